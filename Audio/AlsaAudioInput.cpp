@@ -0,0 +1,95 @@
+#include "AlsaAudioInput.hpp"
+
+// empty unless ALSA development files were found at configure time
+#if WSJT_ALSA_AUDIO
+
+#include <cerrno>
+
+#include <alsa/asoundlib.h>
+
+#include <QAudioDeviceInfo>
+#include <QAudioFormat>
+
+#include "moc_AlsaAudioInput.cpp"
+
+namespace
+{
+  unsigned constexpr device_buffers {4}; // device buffer in units of framesPerBuffer
+}
+
+AlsaAudioInput::AlsaAudioInput (QString const& device_name, QObject * parent)
+  : ThreadedAudioInput {parent}
+  , m_deviceName {device_name}
+  , m_pcm {nullptr}
+  , m_overruns {0}
+  , m_framesPerBuffer {0}
+{
+}
+
+AlsaAudioInput::~AlsaAudioInput ()
+{
+  stop ();
+}
+
+bool AlsaAudioInput::open (QAudioDeviceInfo const& device, QAudioFormat const& format, int framesPerBuffer)
+{
+  auto name = m_deviceName.isEmpty () ? device.deviceName () : m_deviceName;
+  int rc = snd_pcm_open (&m_pcm, name.toLocal8Bit ().constData (), SND_PCM_STREAM_CAPTURE, 0);
+  if (rc >= 0)
+    {
+      // total device latency of a few buffers, resampling allowed in
+      // case the "plug" layer is in use
+      rc = snd_pcm_set_params (m_pcm, SND_PCM_FORMAT_S16, SND_PCM_ACCESS_RW_INTERLEAVED
+                               , format.channelCount (), format.sampleRate (), 1
+                               , device_buffers * format.durationForFrames (framesPerBuffer));
+    }
+  if (rc >= 0)
+    {
+      rc = snd_pcm_start (m_pcm);
+    }
+  if (rc < 0)
+    {
+      Q_EMIT error (tr ("An error opening the ALSA audio input device \"%1\" has occurred: %2")
+                    .arg (name).arg (snd_strerror (rc)));
+      close ();
+      return false;
+    }
+  m_overruns = 0;
+  m_framesPerBuffer = framesPerBuffer;
+  return true;
+}
+
+int AlsaAudioInput::capture (qint16 * frames, int count)
+{
+  auto n = snd_pcm_readi (m_pcm, frames, count);
+  if (n < 0)
+    {
+      if (-EPIPE == n)
+        {
+          // an overrun, the frames lost are unknown so assume a device
+          // buffer full
+          m_overruns += device_buffers * m_framesPerBuffer;
+        }
+      // the next read restarts the stream
+      return snd_pcm_recover (m_pcm, static_cast<int> (n), 1) < 0 ? -1 : 0;
+    }
+  return static_cast<int> (n);
+}
+
+int AlsaAudioInput::overruns ()
+{
+  auto result = m_overruns;
+  m_overruns = 0;
+  return result;
+}
+
+void AlsaAudioInput::close ()
+{
+  if (m_pcm)
+    {
+      snd_pcm_close (m_pcm);
+      m_pcm = nullptr;
+    }
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef ALSA_AUDIO_INPUT_HPP__
+#define ALSA_AUDIO_INPUT_HPP__
+
+#include <QString>
+
+#include "ThreadedAudioInput.hpp"
+
+typedef struct _snd_pcm snd_pcm_t;
+
+//
+// AlsaAudioInput - ALSA PCM capture on a real time thread
+//
+// Reads interleaved 16 bit frames with blocking snd_pcm_readi() calls
+// of one buffer each, the device buffer is sized to a few of those so
+// the latency is far below that of the QAudioInput ALSA and
+// PulseAudio plugins. Overruns are recovered in the capture thread
+// and reported as lost frames.
+//
+// The device is named as for aplay -D, e.g. "hw:1,0" or
+// "plughw:CARD=CODEC", if no name is given the ALSA name of the
+// configured input device is used which is only meaningful when Qt
+// Multimedia is itself using ALSA.
+//
+class AlsaAudioInput final
+  : public ThreadedAudioInput
+{
+  Q_OBJECT
+
+public:
+  explicit AlsaAudioInput (QString const& device_name, QObject * parent = nullptr);
+  ~AlsaAudioInput ();
+
+private:
+  bool open (QAudioDeviceInfo const&, QAudioFormat const&, int framesPerBuffer) override;
+  int capture (qint16 * frames, int count) override;
+  int overruns () override;
+  void close () override;
+
+  QString m_deviceName;
+  snd_pcm_t * m_pcm;
+  int m_overruns;               // capture thread
+  int m_framesPerBuffer;
+};
+
+#endif
@@ -0,0 +1,10 @@
+#include "AudioInputBackend.hpp"
+
+#include <QAudioFormat>
+
+#include "moc_AudioInputBackend.cpp"
+
+int AudioInputBackend::frameRate (QAudioDeviceInfo const&, QAudioFormat const& format, int) const
+{
+  return format.sampleRate ();
+}
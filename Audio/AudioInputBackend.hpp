@@ -0,0 +1,53 @@
+#ifndef AUDIO_INPUT_BACKEND_HPP__
+#define AUDIO_INPUT_BACKEND_HPP__
+
+#include <QObject>
+#include <QString>
+
+class QAudioDeviceInfo;
+class QAudioFormat;
+class AudioDevice;
+
+//
+// AudioInputBackend - source of captured audio for SoundInput
+//
+// A backend delivers frames of the requested format to an already
+// initialized sink by calling its write() operation from the thread
+// the backend lives in, exactly as QAudioInput does in push mode. How
+// the frames are captured is up to the implementation:
+//
+//  QtAudioInput     - QAudioInput, the default
+//  AlsaAudioInput   - ALSA PCM capture on a real time thread
+//  FileAudioInput   - a WAV file played in real time, for repeatable
+//                     tests of the receive and decode pipeline
+//
+// frameRate() chooses the capture rate for the requested format, the
+// sink converts from whatever rate is chosen. start() returns false
+// after emitting error() if the capture cannot be started. The other
+// operations are only called after a successful start().
+//
+class AudioInputBackend
+  : public QObject
+{
+  Q_OBJECT
+
+public:
+  // the requested rate unless the device needs another rate of at
+  // least minimum frames per second
+  virtual int frameRate (QAudioDeviceInfo const&, QAudioFormat const&, int minimum) const;
+  virtual bool start (QAudioDeviceInfo const&, QAudioFormat const&, int framesPerBuffer, AudioDevice * sink) = 0;
+  virtual void suspend () = 0;
+  virtual void resume () = 0;
+  virtual void stop () = 0;
+
+  Q_SIGNAL void error (QString message) const;
+  Q_SIGNAL void status (QString message) const;
+
+protected:
+  explicit AudioInputBackend (QObject * parent = nullptr)
+    : QObject {parent}
+  {
+  }
+};
+
+#endif
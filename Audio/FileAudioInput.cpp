@@ -0,0 +1,106 @@
+#include "FileAudioInput.hpp"
+
+#include <thread>
+
+#include <QAudioFormat>
+#include <QDir>
+
+#include "BWFFile.hpp"
+
+#include "moc_FileAudioInput.cpp"
+
+FileAudioInput::FileAudioInput (QString const& file_name, QObject * parent)
+  : ThreadedAudioInput {parent}
+  , m_fileName {file_name}
+  , m_fileChannels {1}
+  , m_channels {1}
+  , m_repeat {1}
+{
+}
+
+FileAudioInput::~FileAudioInput ()
+{
+  stop ();
+}
+
+int FileAudioInput::frameRate (QAudioDeviceInfo const&, QAudioFormat const& format, int minimum) const
+{
+  BWFFile file {QAudioFormat {}, m_fileName};
+  if (file.open (BWFFile::ReadOnly) && file.format ().sampleRate () >= minimum)
+    {
+      return file.format ().sampleRate ();
+    }
+  return format.sampleRate ();  // open() checks the file
+}
+
+bool FileAudioInput::open (QAudioDeviceInfo const&, QAudioFormat const& format, int framesPerBuffer)
+{
+  m_file.reset (new BWFFile {QAudioFormat {}, m_fileName});
+  if (!m_file->open (BWFFile::ReadOnly))
+    {
+      Q_EMIT error (tr ("Cannot open audio input file \"%1\".").arg (QDir::toNativeSeparators (m_fileName)));
+      m_file.reset ();
+      return false;
+    }
+  auto const& file_format = m_file->format ();
+  if (file_format.sampleSize () != 16
+      || file_format.sampleType () != QAudioFormat::SignedInt
+      || file_format.channelCount () < 1 || file_format.channelCount () > 2
+      || !file_format.sampleRate () || format.sampleRate () % file_format.sampleRate ()
+      || file_format.byteOrder () != format.byteOrder ())
+    {
+      Q_EMIT error (tr ("Audio input file \"%1\" must be 16 bit PCM, mono or stereo, at a sample rate dividing %2 Hz.")
+                    .arg (QDir::toNativeSeparators (m_fileName)).arg (format.sampleRate ()));
+      m_file.reset ();
+      return false;
+    }
+  m_fileChannels = file_format.channelCount ();
+  m_channels = format.channelCount ();
+  m_repeat = format.sampleRate () / file_format.sampleRate ();
+  m_block.assign ((framesPerBuffer + m_repeat - 1) / m_repeat * m_fileChannels, 0);
+  m_blockDuration = std::chrono::microseconds {format.durationForFrames (framesPerBuffer)};
+  m_due = std::chrono::steady_clock::now ();
+  return true;
+}
+
+int FileAudioInput::capture (qint16 * frames, int count)
+{
+  m_due += m_blockDuration;
+  std::this_thread::sleep_until (m_due);
+
+  // read enough file frames for the block, looping at the end of
+  // the file
+  int file_frames = (count + m_repeat - 1) / m_repeat;
+  auto bytes = static_cast<qint64> (file_frames * m_fileChannels * sizeof (qint16));
+  auto buffer = reinterpret_cast<char *> (m_block.data ());
+  qint64 have {0};
+  while (have < bytes)
+    {
+      auto n = m_file->read (buffer + have, bytes - have);
+      if (n < 0 || (!n && (!have && !m_file->pos ())))
+        {
+          return -1;            // read error or empty file
+        }
+      if (!n && !m_file->seek (0))
+        {
+          return -1;
+        }
+      have += n;
+    }
+
+  // expand to the requested rate and channel count
+  for (int i = 0; i < count; ++i)
+    {
+      auto const * in = &m_block[i / m_repeat * m_fileChannels];
+      for (unsigned c = 0; c < m_channels; ++c)
+        {
+          *frames++ = in[c < m_fileChannels ? c : 0];
+        }
+    }
+  return count;
+}
+
+void FileAudioInput::close ()
+{
+  m_file.reset ();
+}
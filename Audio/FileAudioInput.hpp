@@ -0,0 +1,53 @@
+#ifndef FILE_AUDIO_INPUT_HPP__
+#define FILE_AUDIO_INPUT_HPP__
+
+#include <chrono>
+
+#include <QString>
+#include <QScopedPointer>
+
+#include "ThreadedAudioInput.hpp"
+
+class BWFFile;
+
+//
+// FileAudioInput - play a WAV file into the receive pipeline
+//
+// The file is delivered in blocks of exactly framesPerBuffer frames
+// paced by the steady clock, so repeated runs present the decoders
+// with identical input independent of sound card timing. The file is
+// played in a loop, a recording of exactly one T/R period started on
+// a period boundary gives the same decode every period.
+//
+// The file must be 16 bit PCM with one or two channels, it is played
+// at its own sample rate as long as that is not below the minimum
+// rate, otherwise the rate must divide the requested rate and samples
+// are repeated. Mono files feed both channels of a stereo request.
+//
+class FileAudioInput final
+  : public ThreadedAudioInput
+{
+  Q_OBJECT
+
+public:
+  explicit FileAudioInput (QString const& file_name, QObject * parent = nullptr);
+  ~FileAudioInput ();
+
+  int frameRate (QAudioDeviceInfo const&, QAudioFormat const&, int minimum) const override;
+
+private:
+  bool open (QAudioDeviceInfo const&, QAudioFormat const&, int framesPerBuffer) override;
+  int capture (qint16 * frames, int count) override;
+  void close () override;
+
+  QString m_fileName;
+  QScopedPointer<BWFFile> m_file;
+  unsigned m_fileChannels;
+  unsigned m_channels;
+  unsigned m_repeat;
+  std::vector<qint16> m_block;
+  std::chrono::steady_clock::duration m_blockDuration;
+  std::chrono::steady_clock::time_point m_due;
+};
+
+#endif
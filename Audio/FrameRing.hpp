@@ -0,0 +1,95 @@
+#ifndef FRAME_RING_HPP__
+#define FRAME_RING_HPP__
+
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include <QtGlobal>
+
+//
+// FrameRing - lock free single producer single consumer sample ring
+//
+// Carries interleaved 16 bit samples from a real time capture thread
+// to the thread that owns the sink. Neither side blocks, allocates or
+// takes a lock so the capture thread can never be held up by the
+// consumer. Writes are all or nothing so whole frames are never split
+// provided both sides use counts that are multiples of the channel
+// count.
+//
+// resize() must not be called while either side is active.
+//
+class FrameRing final
+{
+public:
+  explicit FrameRing (std::size_t capacity = 0)
+    : mask_ {0}
+    , head_ {0}
+    , tail_ {0}
+  {
+    resize (capacity);
+  }
+
+  // capacity is rounded up to a power of two
+  void resize (std::size_t capacity)
+  {
+    std::size_t size {1};
+    while (size < capacity) size <<= 1;
+    buffer_.assign (size, 0);
+    mask_ = size - 1;
+    head_.store (0);
+    tail_.store (0);
+  }
+
+  std::size_t capacity () const {return buffer_.size ();}
+
+  // producer side, returns false and writes nothing if there is not
+  // room for all count samples
+  bool write (qint16 const * samples, std::size_t count)
+  {
+    auto head = head_.load (std::memory_order_relaxed);
+    auto tail = tail_.load (std::memory_order_acquire);
+    if (buffer_.size () - (head - tail) < count) return false;
+    auto offset = head & mask_;
+    auto first = std::min (count, buffer_.size () - offset);
+    std::copy (samples, samples + first, &buffer_[offset]);
+    std::copy (samples + first, samples + count, &buffer_[0]);
+    head_.store (head + count, std::memory_order_release);
+    return true;
+  }
+
+  // consumer side, returns the number of samples read
+  std::size_t read (qint16 * samples, std::size_t count)
+  {
+    auto tail = tail_.load (std::memory_order_relaxed);
+    auto head = head_.load (std::memory_order_acquire);
+    count = std::min (count, head - tail);
+    auto offset = tail & mask_;
+    auto first = std::min (count, buffer_.size () - offset);
+    std::copy (&buffer_[offset], &buffer_[offset] + first, samples);
+    std::copy (&buffer_[0], &buffer_[0] + (count - first), samples + first);
+    tail_.store (tail + count, std::memory_order_release);
+    return count;
+  }
+
+  // consumer side, samples waiting to be read
+  std::size_t available () const
+  {
+    return head_.load (std::memory_order_acquire) - tail_.load (std::memory_order_relaxed);
+  }
+
+  // consumer side, discard everything written so far
+  void clear ()
+  {
+    tail_.store (head_.load (std::memory_order_acquire), std::memory_order_release);
+  }
+
+private:
+  std::vector<qint16> buffer_;
+  std::size_t mask_;
+  std::atomic<std::size_t> head_;       // free running, written by producer
+  std::atomic<std::size_t> tail_;       // free running, written by consumer
+};
+
+#endif
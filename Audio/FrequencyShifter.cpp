@@ -0,0 +1,94 @@
+#include "FrequencyShifter.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+int constexpr FrequencyShifter::half_length;
+
+namespace
+{
+  double constexpr pi {3.14159265358979323846};
+  double constexpr beta {7.};   // Kaiser window
+
+  // zeroth order modified Bessel function of the first kind
+  double bessel_i0 (double x)
+  {
+    double sum {1.};
+    double term {1.};
+    for (int k = 1; term > 1.e-12 * sum; ++k)
+      {
+        term *= (x / (2. * k)) * (x / (2. * k));
+        sum += term;
+      }
+    return sum;
+  }
+}
+
+FrequencyShifter::FrequencyShifter (double frame_rate)
+  : frame_rate_ {frame_rate}
+  , shift_ {0.}
+  , rate_ {0.}
+  , phase_ {0.}
+  , active_ {false}
+  , coefficients_ (half_length / 2)
+  , history_ (2 * (2 * half_length + 1))
+{
+  // the ideal transformer is 2/(pi n) for odd n and zero for even n,
+  // it is antisymmetric so only the odd taps right of centre are kept
+  auto window_scale = bessel_i0 (beta);
+  for (int k = 0; k < half_length / 2; ++k)
+    {
+      auto n = 2 * k + 1;
+      auto r = double (n) / half_length;
+      auto window = bessel_i0 (beta * std::sqrt (std::max (0., 1. - r * r))) / window_scale;
+      coefficients_[k] = 2. / (pi * n) * window;
+    }
+  reset ();
+}
+
+void FrequencyShifter::set_shift (double hertz, double rate)
+{
+  if (!active_ && (hertz || rate))
+    {
+      reset ();                 // fill the delay line from now
+    }
+  shift_ = hertz;
+  rate_ = rate;
+  active_ = hertz || rate;
+}
+
+void FrequencyShifter::reset ()
+{
+  std::fill (history_.begin (), history_.end (), 0.f);
+  head_ = 0;
+}
+
+void FrequencyShifter::process (qint16 * samples, int count)
+{
+  if (!active_) return;
+  unsigned const taps = 2 * half_length + 1;
+  auto const step = rate_ / frame_rate_; // change of shift per sample
+  for (int i = 0; i < count; ++i)
+    {
+      // newest sample at head_ + taps - 1 of the doubled buffer
+      history_[head_] = history_[head_ + taps] = samples[i];
+      head_ = (head_ + 1) % taps;
+      float const * x = &history_[head_]; // oldest first
+      float const * centre = x + half_length;
+      float quadrature {0.f};
+      for (int k = 0; k < half_length / 2; ++k)
+        {
+          auto n = 2 * k + 1;
+          quadrature += coefficients_[k] * (centre[-n] - centre[n]);
+        }
+      auto angle = 2. * pi * phase_;
+      auto y = *centre * std::cos (angle) - quadrature * std::sin (angle);
+      samples[i] = static_cast<qint16> (std::max (double (std::numeric_limits<qint16>::min ())
+                                                   , std::min (double (std::numeric_limits<qint16>::max ())
+                                                               , std::round (y))));
+      phase_ += shift_ / frame_rate_;
+      phase_ -= std::floor (phase_);
+      shift_ += step;
+    }
+}
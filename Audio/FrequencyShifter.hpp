@@ -0,0 +1,54 @@
+#ifndef FREQUENCY_SHIFTER_HPP__
+#define FREQUENCY_SHIFTER_HPP__
+
+#include <vector>
+
+#include <QtGlobal>
+
+//
+// FrequencyShifter - streaming single sideband frequency shift
+//
+// Moves every component of real 16 bit audio by the same number of
+// hertz, up or down, by forming the analytic signal with a Kaiser
+// windowed Hilbert transformer and mixing it with a complex
+// oscillator. The shift may change linearly with time at a given rate
+// in Hz/s, the oscillator phase is continuous across changes so a
+// tone being received is swept smoothly rather than stepped.
+//
+// The transformer is flat to within 0.1 dB from 250 Hz to within
+// 250 Hz of the Nyquist frequency at 12000 Hz, the output is delayed
+// by delay() samples. With no shift and no rate the samples pass
+// through unchanged and undelayed.
+//
+class FrequencyShifter final
+{
+public:
+  explicit FrequencyShifter (double frame_rate = 12000.);
+
+  // takes effect at the next sample
+  void set_shift (double hertz, double rate = 0.);
+  double shift () const {return shift_;}
+  bool active () const {return active_;}
+
+  // in place
+  void process (qint16 * samples, int count);
+
+  // forget the history, e.g. after a gap in the input
+  void reset ();
+
+  int delay () const {return half_length;}
+
+private:
+  static int constexpr half_length {64}; // taps either side of centre
+
+  double frame_rate_;
+  double shift_;                // Hz
+  double rate_;                 // Hz/s
+  double phase_;                // cycles
+  bool active_;
+  std::vector<float> coefficients_; // odd taps right of centre
+  std::vector<float> history_;      // 2 * taps, doubled for contiguous access
+  unsigned head_;
+};
+
+#endif
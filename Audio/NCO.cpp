@@ -0,0 +1,28 @@
+#include "NCO.hpp"
+
+#include <cmath>
+
+int constexpr NCO::table_bits;
+quint32 constexpr NCO::fraction_mask;
+
+namespace
+{
+  // one cycle of sine plus a copy of the first entry so that
+  // interpolation never needs to wrap the index
+  struct SineTable
+  {
+    SineTable ()
+    {
+      auto constexpr size = sizeof (values) / sizeof (values[0]) - 1;
+      for (unsigned i = 0; i <= size; ++i)
+        {
+          values[i] = std::sin (2. * 3.141592653589793238462 * i / size);
+        }
+      values[size] = values[0];
+    }
+
+    float values[1025];
+  } const sine_table;
+}
+
+float const * const NCO::table_ {sine_table.values};
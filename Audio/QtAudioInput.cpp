@@ -0,0 +1,165 @@
+#include "QtAudioInput.hpp"
+
+#include <algorithm>
+
+#include <QAudioDeviceInfo>
+#include <QAudioFormat>
+#include <QAudioInput>
+
+#include "AudioDevice.hpp"
+
+#include "moc_QtAudioInput.cpp"
+
+QtAudioInput::QtAudioInput (QObject * parent)
+  : AudioInputBackend {parent}
+{
+}
+
+QtAudioInput::~QtAudioInput ()
+{
+  stop ();
+}
+
+bool QtAudioInput::audioError () const
+{
+  bool result (true);
+
+  Q_ASSERT_X (m_stream, "QtAudioInput", "programming error");
+  if (m_stream)
+    {
+      switch (m_stream->error ())
+        {
+        case QAudio::OpenError:
+          Q_EMIT error (tr ("An error opening the audio input device has occurred."));
+          break;
+
+        case QAudio::IOError:
+          Q_EMIT error (tr ("An error occurred during read from the audio input device."));
+          break;
+
+        case QAudio::UnderrunError:
+          Q_EMIT error (tr ("Audio data not being fed to the audio input device fast enough."));
+          break;
+
+        case QAudio::FatalError:
+          Q_EMIT error (tr ("Non-recoverable error, audio input device not usable at this time."));
+          break;
+
+        case QAudio::NoError:
+          result = false;
+          break;
+        }
+    }
+  return result;
+}
+
+int QtAudioInput::frameRate (QAudioDeviceInfo const& device, QAudioFormat const& format, int minimum) const
+{
+  if (device.isFormatSupported (format))
+    {
+      return format.sampleRate ();
+    }
+
+  // try the preferred rate of the device, then the nearest supported
+  // rate above the requested one, then the nearest below it
+  auto requested = format.sampleRate ();
+  auto rates = device.supportedSampleRates ();
+  std::sort (rates.begin (), rates.end (), [requested] (int lhs, int rhs) {
+      return (lhs >= requested) != (rhs >= requested) ? lhs >= requested
+        : lhs >= requested ? lhs < rhs : lhs > rhs;
+    });
+  rates.prepend (device.preferredFormat ().sampleRate ());
+  QAudioFormat candidate {format};
+  for (auto rate : rates)
+    {
+      candidate.setSampleRate (rate);
+      if (rate >= minimum && device.isFormatSupported (candidate))
+        {
+          return rate;
+        }
+    }
+  return requested;             // start() reports the failure
+}
+
+bool QtAudioInput::start (QAudioDeviceInfo const& device, QAudioFormat const& format, int framesPerBuffer, AudioDevice * sink)
+{
+  stop ();
+
+  if (!device.isFormatSupported (format))
+    {
+//      qDebug () << "Nearest supported audio format:" << device.nearestFormat (format);
+      Q_EMIT error (tr ("Requested input audio format is not supported on device."));
+      return false;
+    }
+//  qDebug () << "Selected audio input format:" << format;
+
+  m_stream.reset (new QAudioInput {device, format});
+  if (audioError ())
+    {
+      return false;
+    }
+
+  connect (m_stream.data(), &QAudioInput::stateChanged, this, &QtAudioInput::handleStateChanged);
+
+  m_stream->setBufferSize (m_stream->format ().bytesForFrames (framesPerBuffer));
+  m_stream->start (sink);
+  return !audioError ();
+}
+
+void QtAudioInput::suspend ()
+{
+  if (m_stream)
+    {
+      m_stream->suspend ();
+      audioError ();
+    }
+}
+
+void QtAudioInput::resume ()
+{
+  if (m_stream)
+    {
+      m_stream->resume ();
+      audioError ();
+    }
+}
+
+void QtAudioInput::stop ()
+{
+  if (m_stream)
+    {
+      m_stream->stop ();
+    }
+  m_stream.reset ();
+}
+
+void QtAudioInput::handleStateChanged (QAudio::State newState) const
+{
+  // qDebug () << "QtAudioInput::handleStateChanged: newState:" << newState;
+
+  switch (newState)
+    {
+    case QAudio::IdleState:
+      Q_EMIT status (tr ("Idle"));
+      break;
+
+    case QAudio::ActiveState:
+      Q_EMIT status (tr ("Receiving"));
+      break;
+
+    case QAudio::SuspendedState:
+      Q_EMIT status (tr ("Suspended"));
+      break;
+
+    case QAudio::StoppedState:
+      if (audioError ())
+        {
+          Q_EMIT status (tr ("Error"));
+        }
+      else
+        {
+          Q_EMIT status (tr ("Stopped"));
+        }
+      break;
+    }
+}
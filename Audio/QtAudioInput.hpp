@@ -0,0 +1,36 @@
+#ifndef QT_AUDIO_INPUT_HPP__
+#define QT_AUDIO_INPUT_HPP__
+
+#include <QScopedPointer>
+#include <QAudio>
+
+#include "AudioInputBackend.hpp"
+
+class QAudioInput;
+
+//
+// QtAudioInput - audio capture using QAudioInput
+//
+class QtAudioInput final
+  : public AudioInputBackend
+{
+  Q_OBJECT
+
+public:
+  explicit QtAudioInput (QObject * parent = nullptr);
+  ~QtAudioInput ();
+
+  int frameRate (QAudioDeviceInfo const&, QAudioFormat const&, int minimum) const override;
+  bool start (QAudioDeviceInfo const&, QAudioFormat const&, int framesPerBuffer, AudioDevice * sink) override;
+  void suspend () override;
+  void resume () override;
+  void stop () override;
+
+private:
+  void handleStateChanged (QAudio::State) const;
+  bool audioError () const;
+
+  QScopedPointer<QAudioInput> m_stream;
+};
+
+#endif
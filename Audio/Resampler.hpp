@@ -0,0 +1,63 @@
+#ifndef RESAMPLER_HPP__
+#define RESAMPLER_HPP__
+
+#include <vector>
+
+#include <QtGlobal>
+
+//
+// Resampler - streaming rational rate polyphase resampler
+//
+// Converts 16 bit mono samples from any input rate to the output rate
+// by the ratio up/down in lowest terms, e.g. 48000 to 12000 is 1/4
+// and 44100 to 12000 is 40/147. The anti-alias filter is a Kaiser
+// windowed sinc designed for the rates with its pass band edge at
+// 3/8 and its stop band at 1/2 of the output rate, at least 65 dB
+// down. Only the phases of the filter needed for actual output
+// samples are evaluated.
+//
+// Blocks of any size may be processed, the filter history is kept
+// between calls so the output is the same however the input is
+// split. The delay through the filter is delay() input samples.
+//
+// Equal rates pass samples through unfiltered.
+//
+class Resampler final
+{
+public:
+  explicit Resampler (unsigned input_rate = 48000, unsigned output_rate = 12000);
+
+  void set_rates (unsigned input_rate, unsigned output_rate);
+  unsigned input_rate () const {return input_rate_;}
+  unsigned output_rate () const {return output_rate_;}
+
+  // upper bound on the output from count input samples
+  int max_output (int count) const {return static_cast<int> ((qint64 (count) * up_ + down_ - 1) / down_);}
+
+  // returns the number of output samples written
+  int process (qint16 const * input, int count, qint16 * output);
+
+  // forget the history, e.g. after a gap in the input
+  void reset ();
+
+  // make the next input sample produce an output sample, e.g. to
+  // align output sample zero with a period boundary
+  void align () {phase_ = 0;}
+
+  double delay () const {return taps_ ? (taps_ * up_ - 1) / (2. * up_) : 0.;}
+
+private:
+  float convolve (float const * coefficients) const;
+
+  unsigned input_rate_;
+  unsigned output_rate_;
+  unsigned up_;
+  unsigned down_;
+  unsigned taps_;                       // per phase, multiple of 8
+  unsigned phase_;                      // of the next output, < up_ when due
+  std::vector<float> coefficients_;     // up_ phases of taps_, time reversed
+  std::vector<float> history_;          // 2 * taps_, doubled for contiguous access
+  unsigned head_;
+};
+
+#endif
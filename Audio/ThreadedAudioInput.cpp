@@ -0,0 +1,158 @@
+#include "ThreadedAudioInput.hpp"
+
+#include <algorithm>
+
+#include <QAudioFormat>
+
+#if defined (Q_OS_WIN)
+#include <windows.h>
+#elif defined (Q_OS_UNIX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "AudioDevice.hpp"
+
+#include "moc_ThreadedAudioInput.cpp"
+
+ThreadedAudioInput::ThreadedAudioInput (QObject * parent)
+  : AudioInputBackend {parent}
+  , m_channels {1}
+  , m_framesPerBuffer {0}
+  , m_deliveryTimer {this}
+  , m_running {false}
+  , m_suspended {false}
+  , m_failed {false}
+  , m_dropped {0}
+  , m_droppedReported {0}
+{
+  m_deliveryTimer.setTimerType (Qt::PreciseTimer);
+  connect (&m_deliveryTimer, &QTimer::timeout, this, &ThreadedAudioInput::deliver);
+}
+
+ThreadedAudioInput::~ThreadedAudioInput ()
+{
+  // derived classes have already called stop (), this is just a
+  // safety net
+  if (m_thread.joinable ())
+    {
+      m_running = false;
+      m_thread.join ();
+    }
+}
+
+bool ThreadedAudioInput::start (QAudioDeviceInfo const& device, QAudioFormat const& format, int framesPerBuffer, AudioDevice * sink)
+{
+  stop ();
+
+  if (!open (device, format, framesPerBuffer))
+    {
+      return false;
+    }
+
+  m_sink = sink;
+  m_channels = format.channelCount ();
+  m_framesPerBuffer = framesPerBuffer;
+  m_capture.assign (framesPerBuffer * m_channels, 0);
+  m_buffer.assign (framesPerBuffer * m_channels, 0);
+  // enough slack for the owner thread to be held up for a second or
+  // so without losing frames
+  m_ring.resize (std::max (8 * framesPerBuffer, format.sampleRate ()) * m_channels);
+  m_suspended = false;
+  m_failed = false;
+  m_dropped = 0;
+  m_droppedReported = 0;
+  m_running = true;
+  m_thread = std::thread {&ThreadedAudioInput::run, this};
+
+  // deliver at twice the block rate to keep latency down
+  m_deliveryTimer.start (std::max (1, static_cast<int> (format.durationForFrames (framesPerBuffer) / 2000)));
+  Q_EMIT status (tr ("Receiving"));
+  return true;
+}
+
+void ThreadedAudioInput::suspend ()
+{
+  m_suspended = true;
+  Q_EMIT status (tr ("Suspended"));
+}
+
+void ThreadedAudioInput::resume ()
+{
+  // anything captured before the suspend is stale
+  m_ring.clear ();
+  m_suspended = false;
+  Q_EMIT status (tr ("Receiving"));
+}
+
+void ThreadedAudioInput::stop ()
+{
+  m_deliveryTimer.stop ();
+  if (m_thread.joinable ())
+    {
+      m_running = false;
+      m_thread.join ();
+      close ();
+      Q_EMIT status (tr ("Stopped"));
+    }
+  m_sink.clear ();
+}
+
+void ThreadedAudioInput::run ()
+{
+  // best effort, without the privilege to do so we carry on at
+  // normal priority
+#if defined (Q_OS_WIN)
+  SetThreadPriority (GetCurrentThread (), THREAD_PRIORITY_TIME_CRITICAL);
+#elif defined (Q_OS_UNIX)
+  sched_param param {};
+  param.sched_priority = std::min (sched_get_priority_min (SCHED_FIFO) + 10, sched_get_priority_max (SCHED_FIFO));
+  pthread_setschedparam (pthread_self (), SCHED_FIFO, &param);
+#endif
+
+  while (m_running.load (std::memory_order_relaxed))
+    {
+      auto frames = capture (m_capture.data (), m_framesPerBuffer);
+      if (frames < 0)
+        {
+          m_failed = true;
+          break;
+        }
+      auto lost = overruns ();
+      if (frames && !m_suspended.load (std::memory_order_acquire)
+          && !m_ring.write (m_capture.data (), frames * m_channels))
+        {
+          lost += frames;
+        }
+      if (lost)
+        {
+          m_dropped.fetch_add (lost, std::memory_order_relaxed);
+        }
+    }
+}
+
+void ThreadedAudioInput::deliver ()
+{
+  if (m_failed)
+    {
+      stop ();
+      Q_EMIT error (tr ("An error occurred during read from the audio input device."));
+      Q_EMIT status (tr ("Error"));
+      return;
+    }
+
+  auto dropped = m_dropped.load (std::memory_order_relaxed);
+  if (dropped != m_droppedReported)
+    {
+      Q_EMIT status (tr ("Overrun, %1 frames lost").arg (dropped - m_droppedReported));
+      m_droppedReported = dropped;
+    }
+
+  if (m_sink)
+    {
+      while (auto count = m_ring.read (m_buffer.data (), m_buffer.size ()))
+        {
+          m_sink->write (reinterpret_cast<char const *> (m_buffer.data ()), count * sizeof (qint16));
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef THREADED_AUDIO_INPUT_HPP__
+#define THREADED_AUDIO_INPUT_HPP__
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <QPointer>
+#include <QTimer>
+
+#include "AudioInputBackend.hpp"
+#include "FrameRing.hpp"
+
+class AudioDevice;
+
+//
+// ThreadedAudioInput - base for backends with their own capture thread
+//
+// Derived classes provide blocking capture of fixed size blocks, this
+// class runs the capture loop on a dedicated thread, raised to real
+// time scheduling priority where the platform allows it. Captured
+// frames go through a lock free ring and are written to the sink by a
+// timer in the thread that owns this object, so the sink is only ever
+// used from one thread and the capture thread never waits for it.
+//
+// While suspended the device keeps running and captured frames are
+// dropped, this avoids device overruns and restarts on resume.
+//
+class ThreadedAudioInput
+  : public AudioInputBackend
+{
+  Q_OBJECT
+
+public:
+  ~ThreadedAudioInput ();
+
+  bool start (QAudioDeviceInfo const&, QAudioFormat const&, int framesPerBuffer, AudioDevice * sink) override final;
+  void suspend () override final;
+  void resume () override final;
+  void stop () override final;
+
+protected:
+  explicit ThreadedAudioInput (QObject * parent = nullptr);
+
+  // open the device for capture of blocks of framesPerBuffer frames,
+  // emit error() and return false on failure; called in the owner
+  // thread
+  virtual bool open (QAudioDeviceInfo const&, QAudioFormat const&, int framesPerBuffer) = 0;
+
+  // wait for and read up to count frames, return the number of frames
+  // read or -1 on an unrecoverable error; called on the capture thread
+  virtual int capture (qint16 * frames, int count) = 0;
+
+  // device frames lost since the last call, e.g. ALSA overruns; called
+  // on the capture thread
+  virtual int overruns () {return 0;}
+
+  // called in the owner thread after the capture thread has finished,
+  // derived class destructors must call stop() so this is not called
+  // on a partly destroyed object
+  virtual void close () = 0;
+
+private:
+  void run ();
+  void deliver ();
+
+  QPointer<AudioDevice> m_sink;
+  unsigned m_channels;
+  int m_framesPerBuffer;
+  FrameRing m_ring;
+  std::vector<qint16> m_capture; // capture thread
+  std::vector<qint16> m_buffer;  // owner thread
+  QTimer m_deliveryTimer;
+  std::thread m_thread;
+  std::atomic<bool> m_running;
+  std::atomic<bool> m_suspended;
+  std::atomic<bool> m_failed;
+  std::atomic<unsigned> m_dropped; // frames lost to overruns
+  unsigned m_droppedReported;
+};
+
+#endif
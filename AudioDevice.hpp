@@ -26,6 +26,10 @@ public:
 
   bool initialize (OpenMode mode, Channel channel);
 
+  // the frame rate of the stream is decided when it is started,
+  // devices that convert rates are told it here before initialize()
+  virtual void setFrameRate (unsigned /* rate */) {}
+
   bool isSequential () const override {return true;}
 
   size_t bytesPerFrame () const {return sizeof (qint16) * (Mono == m_channel ? 1 : 2);}
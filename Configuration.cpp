@@ -365,6 +365,7 @@ public:
   void transceiver_tx_frequency (Frequency);
   void transceiver_mode (MODE);
   void transceiver_ptt (bool);
+  void transceiver_next_tx (qint64 start_ms);
   void sync_transceiver (bool force_signal);
 
   Q_SLOT int exec () override;
@@ -454,6 +455,7 @@ private:
   Q_SIGNAL void set_transceiver (Transceiver::TransceiverState const&,
                                  unsigned sequence_number) const;
   Q_SIGNAL void stop_transceiver () const;
+  Q_SIGNAL void next_tx_transceiver (qint64 start_ms) const;
 
   Configuration * const self_;	// back pointer to public interface
 
@@ -524,6 +526,7 @@ private:
   CalibrationParams calibration_;
   bool frequency_calibration_disabled_; // not persistent
   unsigned transceiver_command_number_;
+  qint64 next_tx_ms_;           // see Transceiver::next_tx slot
 
   // configuration fields that we publish
   QString my_callsign_;
@@ -544,6 +547,7 @@ private:
   qint32 RxBandwidth_;
   double degrade_;
   double txDelay_;
+  qint32 pttLead_;
   bool id_after_73_;
   bool tx_QSY_allowed_;
   bool spot_to_psk_reporter_;
@@ -629,6 +633,7 @@ qint32 Configuration::ntrials() const {return m_->ntrials_;}
 qint32 Configuration::aggressive() const {return m_->aggressive_;}
 double Configuration::degrade() const {return m_->degrade_;}
 double Configuration::txDelay() const {return m_->txDelay_;}
+qint32 Configuration::pttLead() const {return m_->pttLead_;}
 qint32 Configuration::RxBandwidth() const {return m_->RxBandwidth_;}
 bool Configuration::id_after_73 () const {return m_->id_after_73_;}
 bool Configuration::tx_QSY_allowed () const {return m_->tx_QSY_allowed_;}
@@ -757,6 +762,11 @@ void Configuration::transceiver_ptt (bool on)
   m_->transceiver_ptt (on);
 }
 
+void Configuration::transceiver_next_tx (qint64 start_ms)
+{
+  m_->transceiver_next_tx (start_ms);
+}
+
 void Configuration::sync_transceiver (bool force_signal, bool enforce_mode_and_split)
 {
 #if WSJT_TRACE_CAT
@@ -833,6 +843,7 @@ Configuration::impl::impl (Configuration * self, QDir const& temp_directory,
   , rig_resolution_ {0}
   , frequency_calibration_disabled_ {false}
   , transceiver_command_number_ {0}
+  , next_tx_ms_ {0}
   , degrade_ {0.}               // initialize to zero each run, not
                                 // saved in settings
   , default_audio_input_device_selected_ {false}
@@ -1080,6 +1091,7 @@ void Configuration::impl::initialize_models ()
   ui_->CW_id_interval_spin_box->setValue (id_interval_);  
   ui_->sbNtrials->setValue (ntrials_);
   ui_->sbTxDelay->setValue (txDelay_);
+  ui_->sbPttLead->setValue (pttLead_);
   ui_->sbAggressive->setValue (aggressive_);
   ui_->sbDegrade->setValue (degrade_);
   ui_->sbBandwidth->setValue (RxBandwidth_);
@@ -1212,6 +1224,7 @@ void Configuration::impl::read_settings ()
   id_interval_ = settings_->value ("IDint", 0).toInt ();
   ntrials_ = settings_->value ("nTrials", 6).toInt ();
   txDelay_ = settings_->value ("TxDelay",0.2).toDouble();
+  pttLead_ = settings_->value ("PTTLead", 0).toInt ();
   aggressive_ = settings_->value ("Aggressive", 0).toInt ();
   RxBandwidth_ = settings_->value ("RxBandwidth", 2500).toInt ();
   save_directory_ = settings_->value ("SaveDir", default_save_directory_.absolutePath ()).toString ();
@@ -1367,6 +1380,7 @@ void Configuration::impl::write_settings ()
   settings_->setValue ("IDint", id_interval_);
   settings_->setValue ("nTrials", ntrials_);
   settings_->setValue ("TxDelay", txDelay_);
+  settings_->setValue ("PTTLead", pttLead_);
   settings_->setValue ("Aggressive", aggressive_);
   settings_->setValue ("RxBandwidth", RxBandwidth_);
   settings_->setValue ("PTTMethod", QVariant::fromValue (rig_params_.ptt_type));
@@ -1804,6 +1818,7 @@ void Configuration::impl::accept ()
   id_interval_ = ui_->CW_id_interval_spin_box->value ();
   ntrials_ = ui_->sbNtrials->value ();
   txDelay_ = ui_->sbTxDelay->value ();
+  pttLead_ = ui_->sbPttLead->value ();
   aggressive_ = ui_->sbAggressive->value ();
   degrade_ = ui_->sbDegrade->value ();
   RxBandwidth_ = ui_->sbBandwidth->value ();
@@ -2343,6 +2358,7 @@ bool Configuration::impl::open_rig (bool force)
           // setup thread safe startup and close down semantics
           rig_connections_ << connect (this, &Configuration::impl::start_transceiver, rig.get (), &Transceiver::start);
           rig_connections_ << connect (this, &Configuration::impl::stop_transceiver, rig.get (), &Transceiver::stop);
+          rig_connections_ << connect (this, &Configuration::impl::next_tx_transceiver, rig.get (), &Transceiver::next_tx);
 
           auto p = rig.release ();	// take ownership
 
@@ -2362,6 +2378,7 @@ bool Configuration::impl::open_rig (bool force)
           ui_->test_CAT_push_button->setStyleSheet ({});
           rig_active_ = true;
           Q_EMIT start_transceiver (++transceiver_command_number_); // start rig on its thread
+          Q_EMIT next_tx_transceiver (next_tx_ms_);
           result = true;
         }
       catch (std::exception const& e)
@@ -2451,6 +2468,15 @@ void Configuration::impl::transceiver_ptt (bool on)
   Q_EMIT set_transceiver (cached_rig_state_, ++transceiver_command_number_);
 }
 
+void Configuration::impl::transceiver_next_tx (qint64 start_ms)
+{
+  next_tx_ms_ = start_ms;       // for when the rig is (re-)opened
+  if (rig_active_)
+    {
+      Q_EMIT next_tx_transceiver (start_ms);
+    }
+}
+
 void Configuration::impl::sync_transceiver (bool /*force_signal*/)
 {
   // pass this on as cache must be ignored
@@ -104,6 +104,7 @@ public:
   qint32 RxBandwidth() const;
   double degrade() const;
   double txDelay() const;
+  qint32 pttLead() const;       // ms PTT is asserted ahead of a Tx period
   bool id_after_73 () const;
   bool tx_QSY_allowed () const;
   bool spot_to_psk_reporter () const;
@@ -225,6 +226,13 @@ public:
   // frequency changes.
   Q_SLOT void transceiver_ptt (bool = true);
 
+  // Advise the  start of the next  scheduled transmission in  ms since
+  // the epoch, zero if none is scheduled.
+  //
+  // CAT polling is held off close to this time so it cannot delay
+  // the PTT command.
+  Q_SLOT void transceiver_next_tx (qint64 start_ms);
+
   // Attempt to (re-)synchronise transceiver state.
   //
   // Force signal guarantees either a transceiver_update or a
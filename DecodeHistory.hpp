@@ -0,0 +1,69 @@
+#ifndef DECODE_HISTORY_HPP__
+#define DECODE_HISTORY_HPP__
+
+#include <QContiguousCache>
+#include <QTime>
+#include <QString>
+
+#include "Radio.hpp"
+
+//
+// Class DecodeHistory
+//
+//	Bounded ring of structured decode records captured at decode
+//	time. The UDP Replay request handler reads back the fields as
+//	decoded rather than parsing them out of the displayed text
+//	again.
+//
+//	Only Replay reads it. The Band Activity window is not rendered
+//	from it, because that window also shows period separators and
+//	transmitted messages that are not decodes, and its search and
+//	filter views work on the displayed text.
+//
+//	When full the oldest records are discarded.
+//
+class DecodeHistory
+{
+public:
+  struct Record
+  {
+    bool is_WSPR;
+    QTime time;
+    qint32 snr;
+    float delta_time;
+    quint32 delta_frequency;    // audio offset, not WSPR
+    QString mode;               // mode character, not WSPR
+    QString message;            // message text, not WSPR
+    bool low_confidence;        // not WSPR
+    Radio::Frequency frequency; // WSPR only
+    qint32 drift;               // WSPR only
+    QString callsign;           // WSPR only
+    QString grid;               // WSPR only
+    qint32 power;               // WSPR only
+  };
+
+  explicit DecodeHistory (int capacity = 5000)
+    : records_ {capacity}
+  {
+  }
+
+  void append (Record const& record) {records_.append (record);}
+  void clear () {records_.clear ();}
+  int size () const {return records_.size ();}
+  bool isEmpty () const {return records_.isEmpty ();}
+
+  // oldest first
+  template<typename F>
+  void for_each (F f) const
+  {
+    for (auto i = records_.firstIndex (); i <= records_.lastIndex (); ++i)
+      {
+        f (records_.at (i));
+      }
+  }
+
+private:
+  QContiguousCache<Record> records_;
+};
+
+#endif
@@ -1,4 +1,6 @@
 #include "Detector.hpp"
+#include <cmath>
+#include <algorithm>
 #include <QDateTime>
 #include <QtAlgorithms>
 #include <QDebug>
@@ -6,8 +8,19 @@
 
 #include "moc_Detector.cpp"
 
-extern "C" {
-  void   fil4_(qint16*, qint32*, qint16*, qint32*);
+namespace
+{
+  // arrivals later than the clock are mostly delivery jitter so the
+  // clock only creeps towards them, earlier ones move it quickly
+  double const late_gain {1. / 256.};
+  double const early_gain {1. / 4.};
+  double const latency_gain {1. / 64.};
+
+  // errors beyond this are a dropout or a clock step, so relock
+  double const relock_ms {1000.};
+
+  // minimum time to measure drift over
+  double const drift_baseline_ms {10000.};
 }
 
 Detector::Detector (unsigned frameRate, unsigned periodLengthInSeconds,
@@ -15,22 +28,65 @@ Detector::Detector (unsigned frameRate, unsigned periodLengthInSeconds,
   : AudioDevice (parent)
   , m_frameRate (frameRate)
   , m_period (periodLengthInSeconds)
-  , m_downSampleFactor (downSampleFactor)
-  , m_samplesPerFFT {max_buffer_size}
-  , m_ns (999)
-  , m_buffer ((downSampleFactor > 1) ?
-              new short [max_buffer_size * downSampleFactor] : nullptr)
+  , m_samplesPerFFT {7 * 512}
+  , m_periodIndex (-1)
+  , m_resampler (frameRate * downSampleFactor, frameRate)
+  , m_input (block_frames)
+  , m_shifter (frameRate)
   , m_bufferPos (0)
+  , m_locked (false)
+  , m_frames (0)
+  , m_t0 (0.)
+  , m_t0Lock (0.)
+  , m_latency (0.)
+{
+  m_output.resize (m_resampler.max_output (block_frames));
+  clear ();
+}
+
+void Detector::setFrameRate (unsigned rate)
 {
-  (void)m_frameRate;            // quell compiler warning
+  m_resampler.set_rates (rate, m_frameRate);
+  m_output.resize (m_resampler.max_output (block_frames));
   clear ();
 }
 
+double Detector::drift () const
+{
+  // the clock counts at the nominal rate so drift shows up as
+  // movement of its origin, a fast clock moves it earlier
+  double elapsed = m_frames * 1000. / inputFrameRate ();
+  if (!m_locked || elapsed < drift_baseline_ms) return 0.;
+  return 1.e6 * (m_t0Lock - m_t0) / elapsed;
+}
+
+void Detector::lock (qint64 now, unsigned frames)
+{
+  m_frames += frames;
+  double arrival = now - (m_t0 + m_frames * 1000. / inputFrameRate ()); // of the last frame
+  if (!m_locked || std::abs (arrival) > relock_ms)
+    {
+      // assume no latency until arrivals say otherwise
+      m_locked = true;
+      m_frames = frames;
+      m_t0 = m_t0Lock = now - m_frames * 1000. / inputFrameRate ();
+      m_latency = 0.;
+      return;
+    }
+  m_t0 += arrival * (arrival < 0. ? early_gain : late_gain);
+  m_latency += (arrival - m_latency) * latency_gain;
+}
+
 void Detector::setBlockSize (unsigned n)
 {
   m_samplesPerFFT = n;
 }
 
+void Detector::setDopplerShift (double hertz, double rate)
+{
+  m_shifter.set_shift (hertz, rate);
+}
+
 bool Detector::reset ()
 {
   clear ();
@@ -47,6 +103,10 @@ void Detector::clear ()
   // dec_data.params.kin = qMin ((msInPeriod * m_frameRate) / 1000, static_cast<unsigned> (sizeof (dec_data.d2) / sizeof (dec_data.d2[0])));
   dec_data.params.kin = 0;
   m_bufferPos = 0;
+  m_resampler.reset ();         // the history is stale
+  m_shifter.reset ();
+  m_periodIndex = -1;           // carry on in the current period
+  m_locked = false;             // the stream may have been suspended
 
   // fill buffer with zeros (G4WJS commented out because it might cause decoder hangs)
   // qFill (dec_data.d2, dec_data.d2 + sizeof (dec_data.d2) / sizeof (dec_data.d2[0]), 0);
@@ -54,79 +114,74 @@ void Detector::clear ()
 
 qint64 Detector::writeData (char const * data, qint64 maxSize)
 {
-  int ns=secondInPeriod();
-  if(ns < m_ns) {                      // When ns has wrapped around to zero, restart the buffers
-    dec_data.params.kin = 0;
-    m_bufferPos = 0;
-  }
-  m_ns=ns;
-
   // no torn frames
   Q_ASSERT (!(maxSize % static_cast<qint64> (bytesPerFrame ())));
-  // these are in terms of input frames (not down sampled)
-  size_t framesAcceptable ((sizeof (dec_data.d2) /
-                            sizeof (dec_data.d2[0]) - dec_data.params.kin) * m_downSampleFactor);
-  size_t framesAccepted (qMin (static_cast<size_t> (maxSize /
-                                                    bytesPerFrame ()), framesAcceptable));
-
-  if (framesAccepted < static_cast<size_t> (maxSize / bytesPerFrame ())) {
-    qDebug () << "dropped " << maxSize / bytesPerFrame () - framesAccepted
-                << " frames of data on the floor!"
-                << dec_data.params.kin << ns;
+  unsigned frames (maxSize / bytesPerFrame ());
+
+  lock (QDateTime::currentMSecsSinceEpoch (), frames);
+
+  // capture times of the first and last frames of this data
+  double msPerFrame = 1000. / inputFrameRate ();
+  double first = m_t0 + (m_frames - frames) * msPerFrame;
+  double last = first + (frames - 1) * msPerFrame;
+  qint64 periodMs = 1000 * m_period;
+  qint64 index = std::floor (last / periodMs);
+  if (m_periodIndex < 0)
+    {
+      m_periodIndex = index;
     }
-
-    for (unsigned remaining = framesAccepted; remaining; ) {
-      size_t numFramesProcessed (qMin (m_samplesPerFFT *
-                                       m_downSampleFactor - m_bufferPos, remaining));
-
-      if(m_downSampleFactor > 1) {
-        store (&data[(framesAccepted - remaining) * bytesPerFrame ()],
-               numFramesProcessed, &m_buffer[m_bufferPos]);
-        m_bufferPos += numFramesProcessed;
-
-        if(m_bufferPos==m_samplesPerFFT*m_downSampleFactor) {
-          qint32 framesToProcess (m_samplesPerFFT * m_downSampleFactor);
-          qint32 framesAfterDownSample (m_samplesPerFFT);
-          if(m_downSampleFactor > 1 && dec_data.params.kin>=0 &&
-             dec_data.params.kin < (NTMAX*12000 - framesAfterDownSample)) {
-            fil4_(&m_buffer[0], &framesToProcess, &dec_data.d2[dec_data.params.kin],
-                  &framesAfterDownSample);
-            dec_data.params.kin += framesAfterDownSample;
-          } else {
-            // qDebug() << "framesToProcess     = " << framesToProcess;
-            // qDebug() << "dec_data.params.kin = " << dec_data.params.kin;
-            // qDebug() << "secondInPeriod      = " << secondInPeriod();
-            // qDebug() << "framesAfterDownSample" << framesAfterDownSample;
-          }
-          Q_EMIT framesWritten (dec_data.params.kin);
-          m_bufferPos = 0;
-        }
-
-      } else {
-        store (&data[(framesAccepted - remaining) * bytesPerFrame ()],
-               numFramesProcessed, &dec_data.d2[dec_data.params.kin]);
-        m_bufferPos += numFramesProcessed;
-        dec_data.params.kin += numFramesProcessed;
-        if (m_bufferPos == static_cast<unsigned> (m_samplesPerFFT)) {
-          Q_EMIT framesWritten (dec_data.params.kin);
-          m_bufferPos = 0;
-        }
-      }
-      remaining -= numFramesProcessed;
+  unsigned before (frames);
+  // early arrivals pull the clock back, which can put the last frame
+  // back before a boundary already crossed, those frames stay in the
+  // current period
+  if (index > m_periodIndex)
+    {
+      // a new period starts in this data, frames up to the boundary
+      // finish the current one
+      double boundary = index * periodMs;
+      before = static_cast<unsigned> (qBound (0., std::ceil ((boundary - first) / msPerFrame), double (frames)));
+      m_periodIndex = index;
+    }
+  accept (data, before);
+  if (before < frames)
+    {
+      // restart the buffers at the first frame of the new period
+      dec_data.params.kin = 0;
+      m_bufferPos = 0;
+      m_resampler.align ();
+      Q_EMIT timing (latency (), drift ());
+      accept (&data[before * bytesPerFrame ()], frames - before);
     }
-
-
 
   return maxSize;    // we drop any data past the end of the buffer on
   // the floor until the next period starts
 }
 
-unsigned Detector::secondInPeriod () const
+void Detector::accept (char const * data, unsigned frames)
 {
-  // we take the time of the data as the following assuming no latency
-  // delivering it to us (not true but close enough for us)
-  qint64 now (QDateTime::currentMSecsSinceEpoch ());
-
-  unsigned secondInToday ((now % 86400000LL) / 1000);
-  return secondInToday % m_period;
+  size_t const capacity (sizeof (dec_data.d2) / sizeof (dec_data.d2[0]));
+  for (unsigned remaining = frames; remaining; ) {
+    unsigned numFramesProcessed (remaining < block_frames ? remaining : block_frames);
+    store (&data[(frames - remaining) * bytesPerFrame ()], numFramesProcessed, m_input.data ());
+    remaining -= numFramesProcessed;
+
+    int produced (m_resampler.process (m_input.data (), numFramesProcessed, m_output.data ()));
+    m_shifter.process (m_output.data (), produced);
+    int stored (qMin (produced, qMax (0, static_cast<int> (capacity) - dec_data.params.kin)));
+    if (stored < produced) {
+      qDebug () << "dropped " << produced - stored
+                << " samples of data on the floor!"
+                << dec_data.params.kin;
+    }
+    std::copy (m_output.constBegin (), m_output.constBegin () + stored, &dec_data.d2[dec_data.params.kin]);
+    dec_data.params.kin += stored;
+
+    // signal each block of samples completed, once the buffer is full
+    // the blocks are signalled without new data as before
+    m_bufferPos += produced;
+    while (m_bufferPos >= static_cast<unsigned> (m_samplesPerFFT)) {
+      m_bufferPos -= m_samplesPerFFT;
+      Q_EMIT framesWritten (stored < produced ? dec_data.params.kin : dec_data.params.kin - static_cast<int> (m_bufferPos));
+    }
+  }
 }
@@ -1,7 +1,9 @@
 #ifndef DETECTOR_HPP__
 #define DETECTOR_HPP__
 #include "AudioDevice.hpp"
-#include <QScopedArrayPointer>
+#include <QVector>
+#include "Audio/Resampler.hpp"
+#include "Audio/FrequencyShifter.hpp"
 
 //
 // output device that distributes data in predefined chunks via a signal
@@ -9,6 +11,20 @@
 // the underlying device for this abstraction is just the buffer that
 // stores samples throughout a receiving period
 //
+// periods are timed by the audio clock, a count of input frames is
+// locked to the system clock so each frame has a capture time and a
+// new period starts in the buffer at the exact frame that crosses
+// the period boundary. The lock follows the earliest arrivals since
+// audio can be delivered late but never early, the average delivery
+// delay and the audio clock drift are available for diagnostics
+//
+// input at any frame rate is resampled to the decoder rate as it
+// arrives, blocks of any size are accepted
+//
+// the resampled audio can be moved in frequency by a shift that
+// changes smoothly with time, used to remove EME Doppler between the
+// occasional retunes of the rig
+//
 class Detector : public AudioDevice
 {
   Q_OBJECT;
@@ -18,17 +34,24 @@ public:
   // if the data buffer were not global storage and fixed size then we
   // might want maximum size passed as constructor arguments
   //
-  // we down sample by a factor of 4
+  // frameRate is the rate after resampling, the input is expected at
+  // downSampleFactor times that until setFrameRate() says otherwise
   //
-  // the samplesPerFFT argument is the number after down sampling
+  // the samplesPerFFT argument is the number after resampling
   //
   Detector (unsigned frameRate, unsigned periodLengthInSeconds, unsigned downSampleFactor = 4u, QObject * parent = 0);
 
   void setPeriod(unsigned p) {m_period=p;}
+  void setFrameRate (unsigned) override; // input rate
   bool reset () override;
 
+  double latency () const {return m_latency;} // ms
+  double drift () const;                      // ppm, +ve is fast
+
   Q_SIGNAL void framesWritten (qint64) const;
+  Q_SIGNAL void timing (double latency, double drift) const; // each period
   Q_SLOT void setBlockSize (unsigned);
+  Q_SLOT void setDopplerShift (double hertz, double rate); // rate in Hz/s
 
 protected:
   qint64 readData (char * /* data */, qint64 /* maxSize */) override
@@ -40,20 +63,27 @@ protected:
 
 private:
   void clear ();		// discard buffer contents
-  unsigned secondInPeriod () const;
+  unsigned inputFrameRate () const {return m_resampler.input_rate ();}
+  void lock (qint64 now, unsigned frames); // discipline the frame clock
+  void accept (char const * data, unsigned frames);
 
   unsigned m_frameRate;
   unsigned m_period;
-  unsigned m_downSampleFactor;
-  qint32 m_samplesPerFFT;	// after any down sampling
-  qint32 m_ns;
-  static size_t const max_buffer_size {7 * 512};
-  QScopedArrayPointer<short> m_buffer; // de-interleaved sample buffer
-  // big enough for all the
-  // samples for one increment of
-  // data (a signals worth) at
-  // the input sample rate
-  unsigned m_bufferPos;
+  qint32 m_samplesPerFFT;	// after resampling
+  qint64 m_periodIndex;         // periods since the epoch
+  static unsigned const block_frames {1024}; // input frames resampled at a time
+  Resampler m_resampler;
+  QVector<short> m_input;       // de-interleaved input block
+  QVector<short> m_output;      // resampled block
+  FrequencyShifter m_shifter;   // Doppler, after resampling
+  unsigned m_bufferPos;         // samples since the last framesWritten
+
+  // frame clock, capture time of frame n is m_t0 + n / rate
+  bool m_locked;
+  qint64 m_frames;              // input frames since locking
+  double m_t0;                  // ms since epoch
+  double m_t0Lock;              // m_t0 when locked
+  double m_latency;             // mean delivery delay in ms
 };
 
 #endif
@@ -38,6 +38,7 @@ public:
   // forward everything else to wrapped Transceiver
   void start (unsigned sequence_number) noexcept override {wrapped_->start (sequence_number);}
   void stop () noexcept override {wrapped_->stop ();}
+  void next_tx (qint64 start_ms) noexcept override {wrapped_->next_tx (start_ms);}
 
 private:
   void handle_update (TransceiverState const&, unsigned seqeunce_number);
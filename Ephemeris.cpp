@@ -0,0 +1,288 @@
+#include "Ephemeris.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <map>
+
+#include <QDateTime>
+#include <QString>
+#include <QByteArray>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QList>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "pimpl_impl.hpp"
+
+extern "C" {
+  void astrosub_(int* nyear, int* month, int* nday, double* uth, double* freqMoon,
+                 const char* mygrid, const char* hisgrid, double* azsun,
+                 double* elsun, double* azmoon, double* elmoon, double* azmoondx,
+                 double* elmoondx, int* ntsky, int* ndop, int* ndop00,
+                 double* ramoon, double* decmoon, double* dgrd, double* poloffset,
+                 double* xnr, double* techo, double* width1, double* width2,
+                 double* doppler, double* doppler00, const char* jpleph,
+                 int len1, int len2, int len3);
+}
+
+namespace
+{
+  int constexpr segment_seconds {600};
+  int constexpr lookahead_segments {12};
+  int constexpr nodes {12};
+
+  double const pi {4. * std::atan (1.)};
+
+  // the fitted quantities
+  enum Quantity {AZ_SUN, EL_SUN, AZ_MOON, EL_MOON, AZ_MOON_DX, EL_MOON_DX, RA_MOON, DEC_MOON
+                 , DGRD, POLOFFSET, XNR, TECHO, WIDTH1, WIDTH2, DOPPLER, DOPPLER00, TSKY, QUANTITIES};
+
+  // range of the angles that wrap, zero for the rest
+  double period (int quantity)
+  {
+    switch (quantity)
+      {
+      case AZ_SUN: case AZ_MOON: case AZ_MOON_DX: return 360.;
+      case POLOFFSET: return 180.; // astro() folds it into [-90, 90]
+      case RA_MOON: return 24.;
+      default: return 0.;
+      }
+  }
+
+  using Series = std::array<double, nodes>;
+  using Segment = std::array<Series, QUANTITIES>;
+
+  // Chebyshev node k in [-1, 1]
+  double node (int k)
+  {
+    return std::cos (pi * (k + .5) / nodes);
+  }
+
+  // coefficients from the values at the nodes, c[0] is doubled
+  Series fit (Series const& values)
+  {
+    Series c;
+    for (int j = 0; j < nodes; ++j)
+      {
+        double sum {0.};
+        for (int k = 0; k < nodes; ++k)
+          {
+            sum += values[k] * std::cos (pi * j * (k + .5) / nodes);
+          }
+        c[j] = 2. * sum / nodes;
+      }
+    return c;
+  }
+
+  // Clenshaw's recurrence
+  double evaluate (Series const& c, double x)
+  {
+    double b1 {0.};
+    double b2 {0.};
+    for (int j = nodes - 1; j > 0; --j)
+      {
+        auto b = 2. * x * b1 - b2 + c[j];
+        b2 = b1;
+        b1 = b;
+      }
+    return x * b1 - b2 + .5 * c[0];
+  }
+
+  // coefficients of the derivative with respect to x
+  Series derivative (Series const& c)
+  {
+    Series d;
+    d[nodes - 1] = 0.;
+    d[nodes - 2] = 2. * (nodes - 1) * c[nodes - 1];
+    for (int j = nodes - 2; j > 0; --j)
+      {
+        d[j - 1] = d[j + 1] + 2. * j * c[j];
+      }
+    return d;
+  }
+
+  double wrap (double value, double range)
+  {
+    value = std::fmod (value, range);
+    return value < 0. ? value + range : value;
+  }
+
+  struct Key
+  {
+    QString mygrid;
+    QString hisgrid;
+    Radio::Frequency frequency;
+
+    bool operator == (Key const& rhs) const
+    {
+      return mygrid == rhs.mygrid && hisgrid == rhs.hisgrid && frequency == rhs.frequency;
+    }
+    bool operator != (Key const& rhs) const {return !(*this == rhs);}
+  };
+}
+
+class Ephemeris::impl
+{
+public:
+  explicit impl (QString const& jpleph)
+    : jpleph_ {jpleph.toLocal8Bit ()}
+    , key_ {QString {}, QString {}, 0}
+  {
+  }
+
+  ~impl ()
+  {
+    worker_.waitForFinished ();
+  }
+
+  Segment compute (qint64 index, Key const&);
+  void prefetch (qint64 index);
+
+  QByteArray jpleph_;
+
+  QMutex mutex_;                // guards key_ and segments_
+  Key key_;
+  std::map<qint64, Segment> segments_; // by segment start / segment_seconds
+
+  QMutex astrosub_mutex_;       // the Fortran is not reentrant
+  QFuture<void> worker_;
+};
+
+Ephemeris::Ephemeris (QString const& jpleph)
+  : m_ {jpleph}
+{
+}
+
+Ephemeris::~Ephemeris ()
+{
+}
+
+Segment Ephemeris::impl::compute (qint64 index, Key const& key)
+{
+  auto mygrid = key.mygrid.toLatin1 ();
+  auto hisgrid = key.hisgrid.toLatin1 ();
+  double freq8 = key.frequency;
+  std::array<Series, QUANTITIES> values;
+  for (int k = 0; k < nodes; ++k)
+    {
+      auto t = QDateTime::fromMSecsSinceEpoch (qint64 ((index * segment_seconds
+                                                         + .5 * segment_seconds * (1. + node (k))) * 1000.)
+                                               , Qt::UTC);
+      int nyear {t.date ().year ()};
+      int month {t.date ().month ()};
+      int nday {t.date ().day ()};
+      double uth {t.time ().hour () + t.time ().minute () / 60. + (t.time ().second () + t.time ().msec () / 1000.) / 3600.};
+      double v[QUANTITIES];
+      int ntsky, ndop, ndop00;
+      {
+        QMutexLocker lock {&astrosub_mutex_};
+        astrosub_ (&nyear, &month, &nday, &uth, &freq8, mygrid.constData (), hisgrid.constData ()
+                   , &v[AZ_SUN], &v[EL_SUN], &v[AZ_MOON], &v[EL_MOON], &v[AZ_MOON_DX], &v[EL_MOON_DX]
+                   , &ntsky, &ndop, &ndop00, &v[RA_MOON], &v[DEC_MOON], &v[DGRD], &v[POLOFFSET]
+                   , &v[XNR], &v[TECHO], &v[WIDTH1], &v[WIDTH2], &v[DOPPLER], &v[DOPPLER00]
+                   , jpleph_.constData (), 6, 6, jpleph_.size ());
+      }
+      v[TSKY] = ntsky;
+      for (int q = 0; q < QUANTITIES; ++q)
+        {
+          values[q][k] = v[q];
+        }
+    }
+
+  Segment segment;
+  for (int q = 0; q < QUANTITIES; ++q)
+    {
+      // make the wrapping angles continuous across the segment
+      if (auto range = period (q))
+        {
+          for (int k = 1; k < nodes; ++k)
+            {
+              auto step = values[q][k] - values[q][k - 1];
+              values[q][k] -= range * std::round (step / range);
+            }
+        }
+      segment[q] = fit (values[q]);
+    }
+  return segment;
+}
+
+void Ephemeris::impl::prefetch (qint64 index)
+{
+  // called with mutex_ held
+  if (worker_.isRunning ()) return;
+  segments_.erase (segments_.begin (), segments_.lower_bound (index - 1));
+  QList<qint64> missing;
+  for (auto i = index + 1; i <= index + lookahead_segments; ++i)
+    {
+      if (!segments_.count (i)) missing << i;
+    }
+  if (missing.isEmpty ()) return;
+  auto key = key_;
+  worker_ = QtConcurrent::run ([this, missing, key] {
+      for (auto i : missing)
+        {
+          auto segment = compute (i, key);
+          QMutexLocker lock {&mutex_};
+          if (key_ != key) return;  // grids or frequency changed
+          segments_[i] = segment;
+        }
+    });
+}
+
+auto Ephemeris::position (QDateTime const& t, QString const& mygrid, QString const& hisgrid
+                          , Frequency frequency) -> Position
+{
+  QMutexLocker lock {&m_->mutex_};
+  Key key {mygrid, hisgrid, frequency};
+  if (key != m_->key_)
+    {
+      m_->key_ = key;
+      m_->segments_.clear ();
+    }
+  auto seconds = t.toMSecsSinceEpoch () / 1000.;
+  auto index = static_cast<qint64> (std::floor (seconds / segment_seconds));
+  auto iter = m_->segments_.find (index);
+  if (iter == m_->segments_.end ())
+    {
+      // only at start up or after a change
+      iter = m_->segments_.emplace (index, m_->compute (index, key)).first;
+    }
+  auto const& segment = iter->second;
+  m_->prefetch (index);
+
+  auto x = 2. * (seconds - index * segment_seconds) / segment_seconds - 1.;
+  auto value = [&segment, x] (Quantity q) {return evaluate (segment[q], x);};
+  // d/dt in Hz/minute from d/dx
+  auto rate = [&segment, x] (Quantity q) {
+    return evaluate (derivative (segment[q]), x) * 2. / segment_seconds * 60.;
+  };
+  Position p;
+  p.az_sun = wrap (value (AZ_SUN), 360.);
+  p.el_sun = value (EL_SUN);
+  p.az_moon = wrap (value (AZ_MOON), 360.);
+  p.el_moon = value (EL_MOON);
+  p.az_moon_dx = wrap (value (AZ_MOON_DX), 360.);
+  p.el_moon_dx = value (EL_MOON_DX);
+  p.ra_moon = wrap (value (RA_MOON), 24.);
+  p.dec_moon = value (DEC_MOON);
+  p.dgrd = value (DGRD);
+  p.poloffset = wrap (value (POLOFFSET) + 90., 180.) - 90.;
+  p.xnr = value (XNR);
+  if (p.xnr != 0.)              // zero when there is no DX grid
+    {
+      // as astro() from the offset, which is smooth where xnr is not
+      auto x1 = std::max (std::abs (std::cos (2. * p.poloffset * pi / 180.)), 0.056234);
+      p.xnr = -20. * std::log10 (x1);
+    }
+  p.techo = value (TECHO);
+  p.width1 = value (WIDTH1);
+  p.width2 = value (WIDTH2);
+  p.doppler = value (DOPPLER);
+  p.doppler00 = value (DOPPLER00);
+  p.dfdt = rate (DOPPLER);
+  p.dfdt00 = rate (DOPPLER00);
+  p.ntsky = static_cast<int> (std::lround (value (TSKY)));
+  return p;
+}
@@ -0,0 +1,64 @@
+#ifndef EPHEMERIS_HPP__
+#define EPHEMERIS_HPP__
+
+#include "Radio.hpp"
+#include "pimpl_h.hpp"
+
+class QDateTime;
+class QString;
+
+//
+// Ephemeris - Moon and Sun positions for the Astro window and Doppler
+// tracking
+//
+//  astrosub() works out everything for one instant from the JPL
+//  ephemeris, too much work to repeat every second on the GUI
+//  thread. Instead each quantity is fitted with a Chebyshev series
+//  over ten minute segments, sampled at the Chebyshev nodes, and the
+//  series are evaluated at any time asked for including fractions of
+//  a second. Doppler rates are the derivatives of the series.
+//
+//  Segments for the next two hours are computed ahead in a worker
+//  thread. They depend on both grids and the frequency, a change to
+//  any of those discards them.
+//
+class Ephemeris final
+{
+public:
+  using Frequency = Radio::Frequency;
+
+  struct Position
+  {
+    double az_sun;              // degrees
+    double el_sun;
+    double az_moon;
+    double el_moon;
+    double az_moon_dx;
+    double el_moon_dx;
+    double ra_moon;             // hours
+    double dec_moon;            // degrees
+    double dgrd;                // dB
+    double poloffset;           // degrees
+    double xnr;                 // dB
+    double techo;               // echo delay, seconds
+    double width1;              // echo spread, Hz
+    double width2;
+    double doppler;             // DX Doppler, Hz
+    double doppler00;           // self echo Doppler, Hz
+    double dfdt;                // Doppler rates, Hz/minute
+    double dfdt00;
+    int ntsky;                  // sky temperature, K
+  };
+
+  explicit Ephemeris (QString const& jpleph);
+  ~Ephemeris ();
+
+  // grids are padded to six characters, blank if not known
+  Position position (QDateTime const&, QString const& mygrid, QString const& hisgrid, Frequency);
+
+private:
+  class impl;
+  pimpl<impl> m_;
+};
+
+#endif
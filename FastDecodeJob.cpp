@@ -0,0 +1,67 @@
+#include "FastDecodeJob.hpp"
+
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+
+extern "C" {
+  void fast_decode_(short id2[], int narg[], int* ntrperiod,
+                    char msg[], char mycall[], char hiscall[],
+                    int len1, int len2, int len3);
+}
+
+namespace
+{
+  int constexpr max_lines {100};
+  int constexpr line_length {80};
+
+  // one thread, so jobs are serialized in the order started
+  QThreadPool * pool ()
+  {
+    static QThreadPool * instance {[] {
+        auto p = new QThreadPool;
+        p->setMaxThreadCount (1);
+        p->setExpiryTimeout (-1);
+        return p;
+      } ()};
+    return instance;
+  }
+}
+
+FastDecodeJob::FastDecodeJob (QVector<short> const& samples, Args const& args, int TRperiod
+                              , QByteArray const& mycall, QByteArray const& hiscall)
+  : samples_ {samples}
+  , args_ (args)
+  , TRperiod_ {TRperiod}
+  , mycall_ {(mycall + QByteArray (12, ' ')).left (12)}
+  , hiscall_ {(hiscall + QByteArray (12, ' ')).left (12)}
+{
+  // keep the decoder inside the snapshot, a pick may reach to the
+  // end of the period
+  args_[1] = qMin (args_[1], samples_.size ());
+  args_[7] = qMin (args_[7], static_cast<int> ((samples_.size () - 1) * 1000ll / 12000));
+}
+
+QFuture<FastDecodeJob::Results> FastDecodeJob::start () const
+{
+  auto job = *this;             // shallow, the samples are shared
+  return QtConcurrent::run (pool (), [job] {return job.run ();});
+}
+
+auto FastDecodeJob::run () const -> Results
+{
+  Results results {args_, {}};
+  auto args = args_;
+  auto TRperiod = TRperiod_;
+  auto mycall = mycall_;
+  auto hiscall = hiscall_;
+  char msg[max_lines][line_length];
+  msg[0][0] = 0;
+  // fast_decode() does not write id2()
+  fast_decode_ (const_cast<short *> (samples_.constData ()), args.data (), &TRperiod, &msg[0][0]
+                , mycall.data (), hiscall.data (), max_lines * line_length, 12, 12);
+  for (int i = 0; i < max_lines && msg[i][0]; ++i)
+    {
+      results.lines << QString::fromLatin1 (msg[i], line_length);
+    }
+  return results;
+}
@@ -0,0 +1,55 @@
+#ifndef FAST_DECODE_JOB_HPP__
+#define FAST_DECODE_JOB_HPP__
+
+#include <array>
+
+#include <QVector>
+#include <QByteArray>
+#include <QStringList>
+#include <QFuture>
+
+//
+// FastDecodeJob - one ISCAT, MSK144 or fast JT9 decode
+//
+//  A job owns everything fast_decode() reads: the Rx samples and its
+//  own copy of the parameters. The GUI may change its state and the
+//  decoder buffer may be refilled while the job runs, so several jobs
+//  can be outstanding, e.g. mouse picked re-decodes of a period
+//  still being decoded.
+//
+//  The samples are an implicitly shared, never modified snapshot of
+//  the period, normally the one retained in the period ring, so
+//  starting a job copies nothing.
+//
+//  fast_decode() keeps state from one call to the next, re-decodes
+//  use the spectra of the last full decode, so jobs run one at a time
+//  and in the order started on a thread of their own. The decoded
+//  lines are the result of the future returned by start().
+//
+class FastDecodeJob final
+{
+public:
+  using Args = std::array<int, 15>; // narg() of fast_decode()
+
+  struct Results
+  {
+    Args args;
+    QStringList lines;
+  };
+
+  FastDecodeJob (QVector<short> const& samples, Args const&, int TRperiod
+                 , QByteArray const& mycall, QByteArray const& hiscall);
+
+  QFuture<Results> start () const;
+
+private:
+  Results run () const;
+
+  QVector<short> samples_;
+  Args args_;
+  int TRperiod_;
+  QByteArray mycall_;           // 12 characters, blank padded
+  QByteArray hiscall_;
+};
+
+#endif
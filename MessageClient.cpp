@@ -8,6 +8,7 @@
 #include <QHostInfo>
 #include <QTimer>
 #include <QQueue>
+#include <QVector>
 #include <QByteArray>
 #include <QHostAddress>
 
@@ -32,8 +33,12 @@ public:
     , server_port_ {server_port}
     , schema_ {2}  // use 2 prior to negotiation not 1 which is broken
     , heartbeat_timer_ {new QTimer {this}}
+    , batch_timer_ {new QTimer {this}}
+    , batch_size_ {0}
   {
     connect (heartbeat_timer_, &QTimer::timeout, this, &impl::heartbeat);
+    batch_timer_->setSingleShot (true);
+    connect (batch_timer_, &QTimer::timeout, this, &impl::flush_decodes);
     connect (this, &QIODevice::readyRead, this, &impl::pending_datagrams);
 
     heartbeat_timer_->start (NetworkMessage::pulse * 1000);
@@ -53,6 +58,10 @@ public:
   void pending_datagrams ();
   void heartbeat ();
   void closedown ();
+  void add_decode (bool is_new, QTime, qint32 snr, float delta_time, quint32 delta_frequency
+                   , QByteArray const& mode, QByteArray const& message, bool low_confidence
+                   , bool off_air);
+  void flush_decodes ();
   StreamStatus check_status (QDataStream const&) const;
   void send_message (QByteArray const&);
   void send_message (QDataStream const& out, QByteArray const& message)
@@ -83,6 +92,23 @@ public:
   // hold messages sent before host lookup completes asynchronously
   QQueue<QByteArray> pending_messages_;
   QByteArray last_message_;
+
+  // decodes waiting to go out as a DecodeBatch message
+  struct BatchedDecode
+  {
+    bool is_new;
+    QTime time;
+    qint32 snr;
+    float delta_time;
+    quint32 delta_frequency;
+    QByteArray mode;
+    QByteArray message;
+    bool low_confidence;
+    bool off_air;
+  };
+  QTimer * batch_timer_;
+  QVector<BatchedDecode> batch_;
+  int batch_size_;              // serialized size of batch_ in bytes
 };
 
 #include "MessageClient.moc"
@@ -245,6 +271,7 @@ void MessageClient::impl::heartbeat ()
 
 void MessageClient::impl::closedown ()
 {
+  flush_decodes ();
    if (server_port_ && !server_.isNull ())
     {
       QByteArray message;
@@ -256,6 +283,46 @@ void MessageClient::impl::closedown ()
     }
 }
 
+void MessageClient::impl::add_decode (bool is_new, QTime time, qint32 snr, float delta_time
+                                      , quint32 delta_frequency, QByteArray const& mode
+                                      , QByteArray const& message, bool low_confidence, bool off_air)
+{
+  // bool, QTime, qint32, double, quint32, two byte arrays, two bools
+  int size = 1 + 4 + 4 + 8 + 4 + 4 + mode.size () + 4 + message.size () + 1 + 1;
+  // magic, schema, type, id and count
+  int header_size = 4 + 4 + 4 + 4 + id_.toUtf8 ().size () + 4;
+  if (batch_.size () && header_size + batch_size_ + size > NetworkMessage::max_datagram_size)
+    {
+      flush_decodes ();
+    }
+  batch_.append ({is_new, time, snr, delta_time, delta_frequency, mode, message, low_confidence, off_air});
+  batch_size_ += size;
+  if (!batch_timer_->isActive ())
+    {
+      // in case the end of the decoding pass is never signalled
+      batch_timer_->start (1000);
+    }
+}
+
+void MessageClient::impl::flush_decodes ()
+{
+  batch_timer_->stop ();
+  if (batch_.size ())
+    {
+      QByteArray message;
+      NetworkMessage::Builder out {&message, NetworkMessage::DecodeBatch, id_, schema_};
+      out << static_cast<quint32> (batch_.size ());
+      for (auto const& decode : batch_)
+        {
+          out << decode.is_new << decode.time << decode.snr << decode.delta_time << decode.delta_frequency
+              << decode.mode << decode.message << decode.low_confidence << decode.off_air;
+        }
+      batch_.clear ();
+      batch_size_ = 0;
+      send_message (out, message);
+    }
+}
+
 void MessageClient::impl::send_message (QByteArray const& message)
 {
   if (server_port_)
@@ -380,6 +447,7 @@ void MessageClient::status_update (Frequency f, QString const& mode, QString con
                                    , bool watchdog_timeout, QString const& sub_mode
                                    , bool fast_mode)
 {
+  m_->flush_decodes ();
   if (m_->server_port_ && !m_->server_string_.isEmpty ())
     {
       QByteArray message;
@@ -396,7 +464,16 @@ void MessageClient::decode (bool is_new, QTime time, qint32 snr, float delta_tim
                             , QString const& mode, QString const& message_text, bool low_confidence
                             , bool off_air)
 {
-   if (m_->server_port_ && !m_->server_string_.isEmpty ())
+  if (!m_->server_port_ || m_->server_string_.isEmpty ())
+    {
+      return;
+    }
+  if (m_->schema_ >= NetworkMessage::decode_batch_schema)
+    {
+      m_->add_decode (is_new, time, snr, delta_time, delta_frequency, mode.toUtf8 ()
+                      , message_text.toUtf8 (), low_confidence, off_air);
+    }
+  else
     {
       QByteArray message;
       NetworkMessage::Builder out {&message, NetworkMessage::Decode, m_->id_, m_->schema_};
@@ -410,6 +487,7 @@ void MessageClient::WSPR_decode (bool is_new, QTime time, qint32 snr, float delt
                                  , qint32 drift, QString const& callsign, QString const& grid, qint32 power
                                  , bool off_air)
 {
+  m_->flush_decodes ();
    if (m_->server_port_ && !m_->server_string_.isEmpty ())
     {
       QByteArray message;
@@ -420,8 +498,14 @@ void MessageClient::WSPR_decode (bool is_new, QTime time, qint32 snr, float delt
     }
 }
 
+void MessageClient::flush_decodes ()
+{
+  m_->flush_decodes ();
+}
+
 void MessageClient::clear_decodes ()
 {
+  m_->flush_decodes ();
    if (m_->server_port_ && !m_->server_string_.isEmpty ())
     {
       QByteArray message;
@@ -430,11 +514,30 @@ void MessageClient::clear_decodes ()
     }
 }
 
+void MessageClient::decoder_stats (QTime time, QString const& mode, float elapsed, quint32 candidates
+                                   , quint32 decodes, quint32 skipped, DecoderStages const& stages)
+{
+  m_->flush_decodes ();
+   if (m_->server_port_ && !m_->server_string_.isEmpty ())
+    {
+      QByteArray message;
+      NetworkMessage::Builder out {&message, NetworkMessage::DecoderStats, m_->id_, m_->schema_};
+      out << time << mode.toUtf8 () << elapsed << candidates << decodes << skipped
+          << static_cast<quint32> (stages.size ());
+      for (auto const& stage : stages)
+        {
+          out << stage.name.toUtf8 () << stage.time << stage.calls;
+        }
+      m_->send_message (out, message);
+    }
+}
+
 void MessageClient::qso_logged (QDateTime time_off, QString const& dx_call, QString const& dx_grid
                                 , Frequency dial_frequency, QString const& mode, QString const& report_sent
                                 , QString const& report_received, QString const& tx_power
                                 , QString const& comments, QString const& name, QDateTime time_on)
 {
+  m_->flush_decodes ();
    if (m_->server_port_ && !m_->server_string_.isEmpty ())
     {
       QByteArray message;
@@ -5,6 +5,7 @@
 #include <QTime>
 #include <QDateTime>
 #include <QString>
+#include <QVector>
 
 #include "Radio.hpp"
 #include "pimpl_h.hpp"
@@ -29,6 +30,15 @@ public:
   using Frequency = Radio::Frequency;
   using port_type = quint16;
 
+  // one timed stage of a decoding pass, see decoder_stats() below
+  struct DecoderStage
+  {
+    QString name;
+    float time;                 // seconds over all threads
+    quint32 calls;
+  };
+  using DecoderStages = QVector<DecoderStage>;
+
   // instantiate and initiate a host lookup on the server
   //
   // messages will be silently dropped until a server host lookup is complete
@@ -58,7 +68,20 @@ public:
   Q_SLOT void WSPR_decode (bool is_new, QTime time, qint32 snr, float delta_time, Frequency
                            , qint32 drift, QString const& callsign, QString const& grid, qint32 power
                            , bool off_air);
+
+  // once a  server has  negotiated schema 4  or later  decodes are
+  // collected and sent  as DecodeBatch messages, call  this when a
+  // decoding pass  is complete  to send any  that are  outstanding,
+  // other outgoing messages do so implicitly
+  Q_SLOT void flush_decodes ();
+
   Q_SLOT void clear_decodes ();
+
+  // profile of a decoding pass when jt9 is run with -P, stages
+  // busiest first, skipped as results.nskipped in commons.h
+  Q_SLOT void decoder_stats (QTime, QString const& mode, float elapsed, quint32 candidates
+                             , quint32 decodes, quint32 skipped, DecoderStages const&);
+
   Q_SLOT void qso_logged (QDateTime time_off, QString const& dx_call, QString const& dx_grid
                           , Frequency dial_frequency, QString const& mode, QString const& report_sent
                           , QString const& report_received, QString const& tx_power, QString const& comments
@@ -254,6 +254,39 @@ void MessageServer::impl::parse_message (QHostAddress const& sender, port_type s
               }
               break;
 
+            case NetworkMessage::DecodeBatch:
+              {
+                quint32 count {0};
+                in >> count;
+                Decodes decodes;
+                decodes.reserve (qMin (count, 1024u)); // don't trust count
+                for (quint32 i = 0; i < count && OK == check_status (in); ++i)
+                  {
+                    bool is_new {true};
+                    QTime time;
+                    qint32 snr;
+                    float delta_time;
+                    quint32 delta_frequency;
+                    QByteArray mode;
+                    QByteArray message;
+                    bool low_confidence {false};
+                    bool off_air {false};
+                    in >> is_new >> time >> snr >> delta_time >> delta_frequency >> mode
+                       >> message >> low_confidence >> off_air;
+                    if (check_status (in) != Fail)
+                      {
+                        decodes.append ({is_new, time, snr, delta_time, delta_frequency
+                              , QString::fromUtf8 (mode), QString::fromUtf8 (message)
+                              , low_confidence, off_air});
+                      }
+                  }
+                if (check_status (in) != Fail && decodes.size ())
+                  {
+                    Q_EMIT self_->decodes_batch (id, decodes);
+                  }
+              }
+              break;
+
             case NetworkMessage::WSPRDecode:
               {
                 // unpack message
@@ -303,6 +336,37 @@ void MessageServer::impl::parse_message (QHostAddress const& sender, port_type s
               }
               break;
 
+            case NetworkMessage::DecoderStats:
+              {
+                QTime time;
+                QByteArray mode;
+                float elapsed;
+                quint32 candidates;
+                quint32 decodes;
+                quint32 skipped;
+                quint32 count {0};
+                in >> time >> mode >> elapsed >> candidates >> decodes >> skipped >> count;
+                DecoderStages stages;
+                stages.reserve (qMin (count, 64u)); // don't trust count
+                for (quint32 i = 0; i < count && OK == check_status (in); ++i)
+                  {
+                    QByteArray name;
+                    float stage_time;
+                    quint32 calls;
+                    in >> name >> stage_time >> calls;
+                    if (check_status (in) != Fail)
+                      {
+                        stages.append ({QString::fromUtf8 (name), stage_time, calls});
+                      }
+                  }
+                if (check_status (in) != Fail)
+                  {
+                    Q_EMIT self_->decoder_stats (id, time, QString::fromUtf8 (mode), elapsed, candidates
+                                                 , decodes, skipped, stages);
+                  }
+              }
+              break;
+
             case NetworkMessage::Close:
               Q_EMIT self_->client_closed (id);
               clients_.remove (id);
@@ -5,13 +5,14 @@
 #include <QTime>
 #include <QDateTime>
 #include <QHostAddress>
+#include <QString>
+#include <QVector>
 
 #include "udp_export.h"
 #include "Radio.hpp"
 
 #include "pimpl_h.hpp"
 
-class QString;
 
 //
 // MessageServer - a reference implementation of a message server
@@ -31,6 +32,31 @@ public:
   using port_type = quint16;
   using Frequency = Radio::Frequency;
 
+  // one decode from a DecodeBatch message, the fields are as for the
+  // decode signal below
+  struct Decode
+  {
+    bool is_new;
+    QTime time;
+    qint32 snr;
+    float delta_time;
+    quint32 delta_frequency;
+    QString mode;
+    QString message;
+    bool low_confidence;
+    bool off_air;
+  };
+  using Decodes = QVector<Decode>;
+
+  // one stage from a DecoderStats message
+  struct DecoderStage
+  {
+    QString name;
+    float time;                 // seconds over all threads
+    quint32 calls;
+  };
+  using DecoderStages = QVector<DecoderStage>;
+
   MessageServer (QObject * parent = nullptr,
                  QString const& version = QString {}, QString const& revision = QString {});
 
@@ -71,6 +97,11 @@ public:
   Q_SIGNAL void decode (bool is_new, QString const& id, QTime time, qint32 snr, float delta_time
                         , quint32 delta_frequency, QString const& mode, QString const& message
                         , bool low_confidence, bool off_air);
+
+  // emitted once  per DecodeBatch  message from a  client, decodes
+  // that arrive this way are not also emitted by the decode signal
+  // above so both signals must be handled
+  Q_SIGNAL void decodes_batch (QString const& id, MessageServer::Decodes const&);
   Q_SIGNAL void WSPR_decode (bool is_new, QString const& id, QTime time, qint32 snr, float delta_time, Frequency
                              , qint32 drift, QString const& callsign, QString const& grid, qint32 power
                              , bool off_air);
@@ -80,6 +111,12 @@ public:
                             , QString const& name, QDateTime time_on);
   Q_SIGNAL void clear_decodes (QString const& id);
 
+  // emitted after each decoding pass of a client whose decoder is
+  // being profiled, stages busiest first
+  Q_SIGNAL void decoder_stats (QString const& id, QTime time, QString const& mode, float elapsed
+                               , quint32 candidates, quint32 decodes, quint32 skipped
+                               , MessageServer::DecoderStages const&);
+
   // this signal is emitted when a network error occurs
   Q_SIGNAL void error (QString const&) const;
 
@@ -18,8 +18,6 @@ extern float gran();		// Noise generator (for tests only)
 # define SOFT_KEYING 1
 #endif
 
-double constexpr Modulator::m_twoPi;
-
 //    float wpm=20.0;
 //    unsigned m_nspd=1.2*48000.0/wpm;
 //    m_nspd=3072;                           //18.75 WPM
@@ -28,9 +26,15 @@ Modulator::Modulator (unsigned frameRate, unsigned periodLengthInSeconds,
                       QObject * parent)
   : AudioDevice {parent}
   , m_quickClose {false}
-  , m_phi {0.0}
+  , m_nco {double (frameRate)}
   , m_toneSpacing {0.0}
   , m_fSpread {0.0}
+  , m_doppler {0.0}
+  , m_doppler0 {0.0}
+  , m_dopplerRate {0.0}
+  , m_txStartMs {0}
+  , m_syncPending {false}
+  , m_pttLead {0}
   , m_frameRate {frameRate}
   , m_period {periodLengthInSeconds}
   , m_state {Idle}
@@ -48,7 +52,7 @@ void Modulator::start (unsigned symbolsLength, double framesPerSymbol,
 {
   Q_ASSERT (stream);
 // Time according to this computer which becomes our base time
-  qint64 ms0 = QDateTime::currentMSecsSinceEpoch() % 86400000;
+  qint64 ms0 = QDateTime::currentMSecsSinceEpoch();
 
   if (m_state != Idle)
     {
@@ -60,7 +64,7 @@ void Modulator::start (unsigned symbolsLength, double framesPerSymbol,
   m_symbolsLength = symbolsLength;
   m_isym0 = std::numeric_limits<unsigned>::max (); // big number
   m_frequency0 = 0.;
-  m_phi = 0.;
+  m_nco.reset ();
   m_addNoise = dBSNR < 0.;
   m_nsps = framesPerSymbol;
   m_frequency = frequency;
@@ -77,23 +81,24 @@ void Modulator::start (unsigned symbolsLength, double framesPerSymbol,
     if (m_snr > 1.0) m_fac = 3000.0 / m_snr;
   }
 
-  unsigned mstr = ms0 % (1000 * m_period); // ms in period
+  qint64 period_ms = 1000 * m_period;
+  qint64 mstr = ms0 % period_ms; // ms in period
+  if (period_ms - mstr <= m_pttLead) mstr -= period_ms; // early, for next period
 
   // round up to an exact portion of a second that allows for startup
   // delays
-  m_ic = (mstr / delay_ms) * m_frameRate * delay_ms / 1000;
+  qint64 nstep = mstr < 0 ? 0 : mstr / delay_ms;
+  m_ic = nstep * m_frameRate * delay_ms / 1000;
+  m_txStartMs = ms0 - mstr + (nstep + 1) * delay_ms;
 
   if(m_bFastMode) m_ic=0;
 
+  // the silence to send is sized on the first read, see readData()
   m_silentFrames = 0;
-  // calculate number of silent frames to send
-  if (synchronize && !m_tuning && !m_bFastMode)	{
-    m_silentFrames = m_ic + m_frameRate / (1000 / delay_ms) - (mstr * (m_frameRate / 1000));
-  }
+  m_syncPending = synchronize && !m_tuning && !m_bFastMode;
 
   initialize (QIODevice::ReadOnly, channel);
-  Q_EMIT stateChanged ((m_state = (synchronize && m_silentFrames) ?
-                        Synchronizing : Active));
+  Q_EMIT stateChanged ((m_state = m_syncPending ? Synchronizing : Active));
   m_stream = stream;
   if (m_stream) m_stream->restart (this);
 }
@@ -151,6 +156,17 @@ qint64 Modulator::readData (char * data, qint64 maxSize)
     {
     case Synchronizing:
       {
+        if (m_syncPending) {
+          // the output is running now, allow for what it already
+          // holds so the first symbol plays on the boundary
+          m_syncPending = false;
+          qint64 latency = m_stream ? m_stream->latency () : 0; // us
+          qint64 frames = ((m_txStartMs - QDateTime::currentMSecsSinceEpoch ()) * 1000 - latency)
+            * m_frameRate / 1000000;
+          if (frames < 0) m_ic += -frames; // late, skip to stay aligned
+          m_silentFrames = qMax (frames, qint64 {0});
+          Q_EMIT txStartOffset (frames < 0 ? -frames / double (m_frameRate) : 0.);
+        }
         if (m_silentFrames)	{  // send silence up to first second
           framesGenerated = qMin (m_silentFrames, numFrames);
           for ( ; samples != end; samples = load (0, samples)) { // silence
@@ -179,10 +195,10 @@ qint64 Modulator::readData (char * data, qint64 maxSize)
         if(!m_bFastMode) m_nspd=2560;                 // 22.5 WPM
 
         if(slowCwId or fastCwId) {     // Transmit CW ID?
-          m_dphi = m_twoPi*m_frequency/m_frameRate;
+          m_nco.set_frequency (m_frequency + m_doppler);
           if(m_bFastMode and !bCwId) {
             m_frequency=1500;          // Set params for CW ID
-            m_dphi = m_twoPi*m_frequency/m_frameRate;
+            m_nco.set_frequency (m_frequency + m_doppler);
             m_symbolsLength=126;
             m_nsps=4096.0*12000.0/11025.0;
             m_ic=2246949;
@@ -196,13 +212,11 @@ qint64 Modulator::readData (char * data, qint64 maxSize)
           while (samples != end) {
             j = (m_ic - ic0)/m_nspd + 1; // symbol of this sample
             bool level {bool (icw[j])};
-            m_phi += m_dphi;
-            if (m_phi > m_twoPi) m_phi -= m_twoPi;
+            float x=m_nco.next ();
             qint16 sample=0;
             float amp=32767.0;
-            float x=0;
+            if(m_ramp==0) x=0;
             if(m_ramp!=0) {
-              x=qSin(float(m_phi));
               if(SOFT_KEYING) {
                 amp=qAbs(qint32(m_ramp));
                 if(amp>32767.0) amp=32767.0;
@@ -254,7 +268,10 @@ qint64 Modulator::readData (char * data, qint64 maxSize)
           if(!m_tuning and m_TRperiod!=3) isym=m_ic / (4.0 * m_nsps);         //Actual
                                                                               //fsample=48000
           if(m_bFastMode) isym=isym%m_symbolsLength;
-          if (isym != m_isym0 || m_frequency != m_frequency0) {
+          if (m_dopplerRate != 0.0 && !(m_ic % 480)) {
+            m_doppler += m_dopplerRate * 480 / m_frameRate; // ramp in 10 ms steps
+          }
+          if (isym != m_isym0 || m_frequency != m_frequency0 || m_doppler != m_doppler0) {
             if(itone[0]>=100) {
               m_toneFrequency0=itone[0];
             } else {
@@ -266,7 +283,8 @@ qint64 Modulator::readData (char * data, qint64 maxSize)
             }
 //            qDebug() << "B" << m_bFastMode << m_ic << numFrames << isym << itone[isym]
 //                     << m_toneFrequency0 << m_nsps;
-            m_dphi = m_twoPi * m_toneFrequency0 / m_frameRate;
+            m_nco.set_frequency (m_toneFrequency0 + m_doppler);
+            m_doppler0 = m_doppler;
             m_isym0 = isym;
             m_frequency0 = m_frequency;         //???
           }
@@ -276,16 +294,15 @@ qint64 Modulator::readData (char * data, qint64 maxSize)
             float x1=(float)qrand()/RAND_MAX;
             float x2=(float)qrand()/RAND_MAX;
             toneFrequency = m_toneFrequency0 + 0.5*m_fSpread*(x1+x2-1.0);
-            m_dphi = m_twoPi * toneFrequency / m_frameRate;
+            m_nco.set_frequency (toneFrequency + m_doppler);
             m_j0=j;
           }
 
-          m_phi += m_dphi;
-          if (m_phi > m_twoPi) m_phi -= m_twoPi;
+          float x=m_nco.next ();
           if (m_ic > i0) m_amp = 0.98 * m_amp;
           if (m_ic > i1) m_amp = 0.0;
 
-          samples = load (postProcessSample (m_amp * qSin (m_phi)), samples);
+          samples = load (postProcessSample (m_amp * x), samples);
           ++framesGenerated;
           ++m_ic;
         }
@@ -296,7 +313,7 @@ qint64 Modulator::readData (char * data, qint64 maxSize)
             Q_EMIT stateChanged ((m_state = Idle));
             return framesGenerated * bytesPerFrame ();
           }
-          m_phi = 0.0;
+          m_nco.reset ();
         }
 
         m_frequency0 = m_frequency;
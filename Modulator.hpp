@@ -5,6 +5,7 @@
 #include <QPointer>
 
 #include "AudioDevice.hpp"
+#include "Audio/NCO.hpp"
 
 class SoundOutput;
 
@@ -15,6 +16,20 @@ class SoundOutput;
 // Output can be muted while underway, preserving waveform timing when
 // transmission is resumed.
 //
+// Synchronized transmissions start on a fixed boundary in the T/R
+// period. The silence before it is sized when the output stream first
+// asks for data, allowing for the audio already queued in the device,
+// so the first symbol is released at the boundary to the nearest
+// sample rather than when start() happened to be called. A start late
+// by some samples skips those samples of the waveform to stay aligned
+// and the offset is reported by txStartOffset().
+//
+// Starts within the PTT lead time of the end of a period are early
+// starts for the next period.
+//
+// A Doppler shift, which may change at a steady rate, is added to
+// every tone so EME transmissions track between rig retunes.
+//
 class Modulator
   : public AudioDevice
 {
@@ -41,8 +56,13 @@ public:
   Q_SLOT void stop (bool quick = false);
   Q_SLOT void tune (bool newState = true);
   Q_SLOT void setFrequency (double newFrequency) {m_frequency = newFrequency;}
+  Q_SLOT void setPttLead (int ms) {m_pttLead = ms;} // PTT asserted ms ahead of this Tx
+  Q_SLOT void setDopplerShift (double hertz, double rate) {m_doppler = hertz; m_dopplerRate = rate;} // Hz/s
   Q_SIGNAL void stateChanged (ModulatorState) const;
 
+  // seconds the first symbol was released after its boundary
+  Q_SIGNAL void txStartOffset (double) const;
+
 protected:
   qint64 readData (char * data, qint64 maxSize) override;
   qint64 writeData (char const * /* data */, qint64 /* maxSize */) override
@@ -58,11 +78,9 @@ private:
 
   unsigned m_symbolsLength;
 
-  static double constexpr m_twoPi = 2.0 * 3.141592653589793238462;
   unsigned m_nspd = 2048 + 512; // CW ID WPM factor = 22.5 WPM
 
-  double m_phi;
-  double m_dphi;
+  NCO m_nco;                    // phase continuous tone generator
   double m_amp;
   double m_nsps;
   double volatile m_frequency;
@@ -71,8 +89,14 @@ private:
   double m_fac;
   double m_toneSpacing;
   double m_fSpread;
+  double m_doppler;
+  double m_doppler0;
+  double m_dopplerRate;
 
   qint64 m_silentFrames;
+  qint64 m_txStartMs;           // boundary for the first symbol
+  bool m_syncPending;           // silence not yet sized
+  int m_pttLead;
   qint32 m_TRperiod;
   qint16 m_ramp;
 
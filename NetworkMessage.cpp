@@ -34,7 +34,7 @@ namespace NetworkMessage
       }
 #endif
 #if QT_VERSION >= 0x050400
-    else if (schema <= 3)
+    else if (schema <= 4)
       {
         setVersion (QDataStream::Qt_5_4); // Qt schema version
       }
@@ -79,7 +79,7 @@ namespace NetworkMessage
         }
 #endif
 #if QT_VERSION >= 0x050400
-      else if (schema_ <= 3)
+      else if (schema_ <= 4)
         {
           parent->setVersion (QDataStream::Qt_5_4);
         }
@@ -71,6 +71,12 @@
  *
  * Schema Version 3:- this schema uses the QDataStream::Qt_5_4 version.
  *
+ * Schema Version 4:- this schema  also uses the QDataStream::Qt_5_4
+ *  version, it adds  the "DecodeBatch" message type.  Clients must not
+ *  send  a  "DecodeBatch" message  unless  schema  4 or  later  has
+ *  been negotiated,  servers written  to  an  earlier schema  do  not
+ *  recognize it.
+ *
  *
  *
  * Message       Direction Value                  Type
@@ -327,6 +333,63 @@
  *      from a played back recording.
  *
  *
+ * DecodeBatch   Out       11                     quint32
+ *                         Id (unique key)        utf8
+ *                         Count                  quint32
+ *
+ *                         followed by Count repetitions of:
+ *
+ *                         New                    bool
+ *                         Time                   QTime
+ *                         snr                    qint32
+ *                         Delta time (S)         float (serialized as double)
+ *                         Delta frequency (Hz)   quint32
+ *                         Mode                   utf8
+ *                         Message                utf8
+ *                         Low confidence         bool
+ *                         Off air                bool
+ *
+ *      This message carries  several decodes, each with  exactly the
+ *      fields of  a "Decode" message,  in the order they  were decoded.
+ *      It  is only  sent once  schema 4  or later  has been  negotiated,
+ *      otherwise  individual "Decode"  messages are  sent  instead.  A
+ *      client  collects  the  decodes of  one  decoding  pass and sends
+ *      them when the pass completes, before any other message, or when
+ *      the next decode would take the datagram over MTU friendly size
+ *      (see NetworkMessage::max_datagram_size below),  so a busy  period
+ *      may span  a few of these  messages. Replayed decodes (New field
+ *      false) are batched in the same way.
+ *
+ *
+ * DecoderStats  Out       12                     quint32
+ *                         Id (unique key)        utf8
+ *                         Time                   QTime
+ *                         Mode                   utf8
+ *                         Elapsed (S)            float (serialized as double)
+ *                         Candidates             quint32
+ *                         Decodes                quint32
+ *                         Skipped                quint32
+ *                         Count                  quint32
+ *
+ *                         followed by Count repetitions of:
+ *
+ *                         Stage                  utf8
+ *                         Time (S)               float (serialized as double)
+ *                         Calls                  quint32
+ *
+ *      Sent at the  end of each decoding pass  when the decoder is
+ *      being profiled  (see the jt9  -P option), Time  is when the
+ *      pass finished. Candidates is the  number of sync candidates
+ *      the decoders  tried and Decodes  the number of  decodes, the
+ *      stages are the  busiest of the decoder's  timed routines by
+ *      name,  busiest  first, with  their  time  summed over  all
+ *      threads and the number of calls.  Skipped is a bit mask of the
+ *      optional stages the  decoders left out to finish  in time: 1
+ *      FT8 OSD, 2 FT8 AP,  4 passes after subtraction, 8 JT65 erasure
+ *      or JT9 Fano trials cut short, 16 weak candidates away from the
+ *      QSO frequency not tried.
+ *
+ *
  */
 
 #include <QDataStream>
@@ -353,12 +416,21 @@ namespace NetworkMessage
       HaltTx,
       FreeText,
       WSPRDecode,
+      DecodeBatch,
+      DecoderStats,
       maximum_message_type_     // ONLY add new message types
                                 // immediately before here
     };
 
   quint32 constexpr pulse {15}; // seconds
 
+  // largest datagram built from several items, small enough to avoid
+  // IP fragmentation on typical links
+  int constexpr max_datagram_size {1400}; // bytes
+
+  // first schema number that understands the DecodeBatch message
+  quint32 constexpr decode_batch_schema {4};
+
   //
   // NetworkMessage::Builder - build a message containing serialized Qt types
   //
@@ -371,7 +443,7 @@ namespace NetworkMessage
     // increment this if a newer Qt schema is required and add decode
     // logic to the Builder and Reader class implementations
 #if QT_VERSION >= 0x050400
-    static quint32 constexpr schema_number {3};
+    static quint32 constexpr schema_number {4};
 #elif QT_VERSION >= 0x050200
     static quint32 constexpr schema_number {2};
 #else
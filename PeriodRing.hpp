@@ -0,0 +1,92 @@
+#ifndef PERIOD_RING_HPP__
+#define PERIOD_RING_HPP__
+
+#include <QContiguousCache>
+#include <QVector>
+#include <QString>
+#include <QDateTime>
+
+#include "Radio.hpp"
+
+//
+// Class PeriodRing
+//
+//	Bounded ring of the most recent receive periods, the samples
+//	and the metadata needed to write each as a WAV file or archive
+//	record later.
+//	Periods are only written to disk when a save policy asks for
+//	them, including after the event, rather than every period
+//	being written and then deleted.
+//
+//	The samples are a copy of the decoder buffer, implicitly
+//	shared so a writer thread can be handed a period without
+//	copying it again or touching dec_data.
+//
+//	When full the oldest periods are discarded.
+//
+class PeriodRing
+{
+public:
+  struct Period
+  {
+    QString name;               // save path without extension
+    QDateTime start;            // UTC
+    QVector<short> samples;     // 12000 Hz
+    QString my_callsign;
+    QString my_grid;
+    QString mode;
+    qint32 sub_mode;
+    Radio::Frequency frequency;
+    QString his_call;
+    QString his_grid;
+    bool saved;
+  };
+
+  explicit PeriodRing (int capacity = 8)
+    : periods_ {capacity}
+  {
+  }
+
+  void set_capacity (int capacity) {periods_.setCapacity (qMax (1, capacity));}
+  int capacity () const {return periods_.capacity ();}
+
+  // a period of the same name replaces the earlier one, e.g. when a
+  // fast mode sequence is captured again
+  void append (Period const& period)
+  {
+    if (auto p = find (period.name))
+      {
+        *p = period;
+      }
+    else
+      {
+        periods_.append (period);
+      }
+  }
+
+  void clear () {periods_.clear ();}
+
+  Period * find (QString const& name)
+  {
+    for (auto i = periods_.lastIndex (); i >= periods_.firstIndex (); --i)
+      {
+        if (periods_[i].name == name) return &periods_[i];
+      }
+    return nullptr;
+  }
+
+  // oldest first
+  template<typename F>
+  void for_each (F f)
+  {
+    for (auto i = periods_.firstIndex (); i <= periods_.lastIndex (); ++i)
+      {
+        f (periods_[i]);
+      }
+  }
+
+private:
+  QContiguousCache<Period> periods_;
+};
+
+#endif
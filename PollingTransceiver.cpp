@@ -1,26 +1,45 @@
 #include "PollingTransceiver.hpp"
 
 #include <exception>
+#include <algorithm>
 
 #include <QObject>
 #include <QString>
 #include <QTimer>
+#include <QDateTime>
+#include <QDebug>
 
 #include "moc_PollingTransceiver.cpp"
 
 namespace
 {
   unsigned const polls_to_stabilize {3};
+
+  // poll interval after a change, doubled on each quiet poll until
+  // the configured interval is reached
+  int const fast_poll_interval {250}; // ms
+
+  // margin before a scheduled transmission where no poll may run
+  qint64 const tx_guard_interval {500}; // ms
 }
 
 PollingTransceiver::PollingTransceiver (int poll_interval, QObject * parent)
   : TransceiverBase {parent}
   , interval_ {poll_interval * 1000}
+  , fast_interval_ {std::min (fast_poll_interval, interval_)}
+  , current_interval_ {interval_}
   , poll_timer_ {nullptr}
+  , next_tx_ {0}
+  , poll_duration_ {0}
   , retries_ {0}
 {
 }
 
+void PollingTransceiver::next_tx (qint64 start_ms) noexcept
+{
+  next_tx_ = start_ms;
+}
+
 void PollingTransceiver::start_timer ()
 {
   if (interval_)
@@ -31,10 +50,12 @@ void PollingTransceiver::start_timer ()
                                            // QObject which handles
                                            // destruction for us
 
+          poll_timer_->setSingleShot (true); // rescheduled after each poll
           connect (poll_timer_, &QTimer::timeout, this,
                    &PollingTransceiver::handle_timeout);
         }
-      poll_timer_->start (interval_);
+      current_interval_ = fast_interval_;
+      poll_timer_->start (current_interval_);
     }
   else
     {
@@ -50,6 +71,16 @@ void PollingTransceiver::stop_timer ()
     }
 }
 
+void PollingTransceiver::speed_up ()
+{
+  current_interval_ = fast_interval_;
+  if (poll_timer_ && poll_timer_->isActive ()
+      && poll_timer_->remainingTime () > current_interval_)
+    {
+      poll_timer_->start (current_interval_);
+    }
+}
+
 void PollingTransceiver::do_post_start ()
 {
   start_timer ();
@@ -82,6 +113,7 @@ void PollingTransceiver::do_post_frequency (Frequency f, MODE m)
           next_state_.mode (m);
         }
       retries_ = polls_to_stabilize;
+      speed_up ();
     }
 }
 
@@ -94,6 +126,7 @@ void PollingTransceiver::do_post_tx_frequency (Frequency f, MODE)
       next_state_.tx_frequency (f);
       next_state_.split (f); // setting non-zero TX frequency means split
       retries_ = polls_to_stabilize;
+      speed_up ();
     }
 }
 
@@ -105,6 +138,7 @@ void PollingTransceiver::do_post_mode (MODE m)
       // update expected state with new mode and set poll count
       next_state_.mode (m);
       retries_ = polls_to_stabilize;
+      speed_up ();
     }
 }
 
@@ -115,6 +149,7 @@ void PollingTransceiver::do_post_ptt (bool p)
       // update expected state with new PTT and set poll count
       next_state_.ptt (p);
       retries_ = polls_to_stabilize;
+      speed_up ();
       //retries_ = 0;             // fast feedback on PTT
     }
 }
@@ -168,7 +203,19 @@ void PollingTransceiver::do_sync (bool force_signal, bool no_poll)
 
 void PollingTransceiver::handle_timeout ()
 {
+  auto const start = QDateTime::currentMSecsSinceEpoch ();
+
+  // hold off if this poll may still be running when PTT is due
+  if (next_tx_ && !state ().ptt () && start < next_tx_
+      && start + poll_duration_ + tx_guard_interval > next_tx_)
+    {
+      TRACE_CAT_POLL ("PollingTransceiver", "holding off for Tx in:" << next_tx_ - start << "ms");
+      poll_timer_->start (next_tx_ - start + fast_interval_);
+      return;
+    }
+
   QString message;
+  auto const signalled_state = last_signalled_state_;
 
   // we must catch all exceptions here since we are called by Qt and
   // inform our parent of the failure via the offline() message
@@ -187,5 +234,21 @@ void PollingTransceiver::handle_timeout ()
   if (!message.isEmpty ())
     {
       offline (message);
+      return;
+    }
+
+  poll_duration_ = QDateTime::currentMSecsSinceEpoch () - start;
+  TRACE_CAT_POLL ("PollingTransceiver", "poll took:" << poll_duration_ << "ms");
+
+  // stay fast while a change is settling or the rig is being
+  // operated, otherwise back off towards the configured interval
+  if (retries_ || last_signalled_state_ != signalled_state)
+    {
+      current_interval_ = fast_interval_;
+    }
+  else
+    {
+      current_interval_ = std::min (current_interval_ * 2, interval_);
     }
+  poll_timer_->start (current_interval_);
 }
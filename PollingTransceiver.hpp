@@ -17,7 +17,9 @@ class QTimer;
 //
 //  Implements the TransceiverBase post  action interface and provides
 //  the abstract  poll() operation  for sub-classes to  implement. The
-//  poll operation is invoked every poll_interval seconds.
+//  poll  operation is  invoked frequently  after any  state change  or
+//  request and backs off to every poll_interval seconds when the rig
+//  is idle.
 //
 // Responsibilities
 //
@@ -29,6 +31,10 @@ class QTimer;
 //  requires a  VFO switch  and polls while  switched will  return the
 //  wrong current frequency.
 //
+//  Polls are slow on some rig interfaces and delay any command issued
+//  while they are in progress, so no poll is started close enough to
+//  a transmission scheduled via next_tx() to hold up the PTT command.
+//
 class PollingTransceiver
   : public TransceiverBase
 {
@@ -38,6 +44,9 @@ protected:
   explicit PollingTransceiver (int poll_interval, // in seconds
                                QObject * parent);
 
+public:
+  void next_tx (qint64 start_ms) noexcept override final;
+
 protected:
   void do_sync (bool force_signal = false, bool no_poll = false) override final;
 
@@ -56,11 +65,16 @@ protected:
 private:
   void start_timer ();
   void stop_timer ();
+  void speed_up ();             // poll soon after a state change
 
   Q_SLOT void handle_timeout ();
 
   int interval_;    // polling interval in milliseconds
+  int fast_interval_;           // polling interval when busy
+  int current_interval_;        // between fast_interval_ & interval_
   QTimer * poll_timer_;
+  qint64 next_tx_;              // ms since epoch, zero if none
+  qint64 poll_duration_;        // of the last poll in milliseconds
 
   // keep a record of the last state signalled so we can elide
   // duplicate updates
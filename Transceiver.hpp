@@ -131,6 +131,11 @@ public:
   Q_SLOT virtual void start (unsigned sequence_number) noexcept = 0;
   Q_SLOT virtual void stop () noexcept = 0;
 
+  // Advise  the start time  of the next scheduled  transmission in ms
+  // since the  epoch, zero if  none is scheduled.  Implementations may
+  // use this to keep slow rig traffic clear of the PTT command.
+  Q_SLOT virtual void next_tx (qint64 /* start_ms */) noexcept {}
+
   //
   // asynchronous status updates
   //
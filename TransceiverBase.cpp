@@ -19,6 +19,7 @@ void TransceiverBase::start (unsigned sequence_number) noexcept
   QString message;
   try
     {
+      apply_pending ();         // keep request order
       may_update u {this, true};
       shutdown ();
       startup ();
@@ -43,6 +44,42 @@ void TransceiverBase::set (TransceiverState const& s,
 {
   TRACE_CAT ("TransceiverBase", "#:" << sequence_number << s);
 
+  // each request carries the complete state wanted so a later one
+  // supersedes any not yet applied, frequency and mode changes often
+  // arrive in quick succession and would otherwise each cost a round
+  // trip to the rig
+  pending_ = true;
+  pending_state_ = s;
+  pending_sequence_number_ = sequence_number;
+  if (s.ptt () != requested_.ptt () || s.online () != requested_.online ())
+    {
+      apply_pending ();         // don't delay PTT or start up/close down
+    }
+  else if (!apply_queued_)
+    {
+      // apply after any requests already queued to us
+      apply_queued_ = true;
+      QMetaObject::invokeMethod (this, "handle_pending", Qt::QueuedConnection);
+    }
+}
+
+void TransceiverBase::handle_pending ()
+{
+  apply_queued_ = false;
+  apply_pending ();
+}
+
+void TransceiverBase::apply_pending ()
+{
+  if (!pending_)
+    {
+      return;
+    }
+  pending_ = false;
+  auto const s = pending_state_;
+  auto const sequence_number = pending_sequence_number_;
+  TRACE_CAT ("TransceiverBase", "applying #:" << sequence_number << s);
+
   QString message;
   try
     {
@@ -141,6 +178,7 @@ void TransceiverBase::startup ()
 
 void TransceiverBase::shutdown ()
 {
+  pending_ = false;             // nothing further to apply
   may_update u {this};
   if (requested_.online ())
     {
@@ -49,6 +49,10 @@
 //  can receive  messages, any exception thrown  takes the Transceiver
 //  offline.
 //
+//  Coalesces  set state  requests  that arrive  together, only the
+//  latest is applied once  the requests already queued  have been
+//  received. PTT changes are applied immediately.
+//
 //  Implements methods  that concrete Transceiver  implementations use
 //  to update the Transceiver state.  These do not signal state change
 //  to  clients  as  this  is   the  responsibility  of  the  concrete
@@ -64,6 +68,9 @@ protected:
   TransceiverBase (QObject * parent)
     : Transceiver {parent}
     , last_sequence_number_ {0}
+    , pending_ {false}
+    , apply_queued_ {false}
+    , pending_sequence_number_ {0}
   {}
 
 public:
@@ -130,6 +137,8 @@ protected:
   void offline (QString const& reason);
 
 private:
+  void apply_pending ();
+  Q_SLOT void handle_pending ();
   void startup ();
   void shutdown ();
   bool maybe_low_resolution (Frequency low_res, Frequency high_res);
@@ -152,6 +161,12 @@ private:
   TransceiverState actual_;
   TransceiverState last_;
   unsigned last_sequence_number_;    // from set state operation
+
+  // coalesced set state request
+  bool pending_;
+  bool apply_queued_;
+  TransceiverState pending_state_;
+  unsigned pending_sequence_number_;
 };
 
 // some trace macros
@@ -1,6 +1,7 @@
 #include "BeaconsModel.hpp"
 
-#include <QStandardItem>
+#include <QModelIndex>
+#include <QVariant>
 #include <QFont>
 
 namespace
@@ -24,112 +25,160 @@ namespace
   }
 
   QFont text_font {"Courier", 10};
+}
 
-  QList<QStandardItem *> make_row (QString const& client_id, QTime time, qint32 snr, float delta_time
-                                   , Frequency frequency, qint32 drift, QString const& callsign
-                                   , QString const& grid, qint32 power, bool off_air)
-  {
-    auto time_item = new QStandardItem {time.toString ("hh:mm")};
-    time_item->setData (time);
-    time_item->setTextAlignment (Qt::AlignRight);
-
-    auto snr_item = new QStandardItem {QString::number (snr)};
-    snr_item->setData (snr);
-    snr_item->setTextAlignment (Qt::AlignRight);
-
-    auto dt = new QStandardItem {QString::number (delta_time)};
-    dt->setData (delta_time);
-    dt->setTextAlignment (Qt::AlignRight);
-
-    auto freq = new QStandardItem {Radio::pretty_frequency_MHz_string (frequency)};
-    freq->setData (frequency);
-    freq->setTextAlignment (Qt::AlignRight);
-
-    auto dri = new QStandardItem {QString::number (drift)};
-    dri->setData (drift);
-    dri->setTextAlignment (Qt::AlignRight);
-
-    auto gd = new QStandardItem {grid};
-    gd->setTextAlignment (Qt::AlignRight);
-
-    auto pwr = new QStandardItem {QString::number (power)};
-    pwr->setData (power);
-    pwr->setTextAlignment (Qt::AlignRight);
-
-    auto live = new QStandardItem {live_string (off_air)};
-    live->setTextAlignment (Qt::AlignHCenter);
-
-    QList<QStandardItem *> row {
-      new QStandardItem {client_id}, time_item, snr_item, dt, freq, dri, gd, pwr, live, new QStandardItem {callsign}};
-    Q_FOREACH (auto& item, row)
-      {
-        item->setEditable (false);
-        item->setFont (text_font);
-        item->setTextAlignment (item->textAlignment () | Qt::AlignVCenter);
-      }
-    return row;
-  }
+BeaconsModel::BeaconsModel (QObject * parent, int capacity)
+  : RingTableModel {capacity, parent}
+  , time_ (capacity)
+  , snr_ (capacity)
+  , delta_time_ (capacity)
+  , frequency_ (capacity)
+  , drift_ (capacity)
+  , grid_ (capacity)
+  , power_ (capacity)
+  , off_air_ (capacity)
+  , callsign_ (capacity)
+{
+}
+
+int BeaconsModel::columnCount (QModelIndex const& parent) const
+{
+  return parent.isValid () ? 0 : sizeof (headings) / sizeof (headings[0]);
+}
+
+QVariant BeaconsModel::headerData (int section, Qt::Orientation orientation, int role) const
+{
+  if (Qt::Horizontal == orientation && Qt::DisplayRole == role
+      && section >= 0 && section < columnCount ())
+    {
+      return tr (headings[section]);
+    }
+  return RingTableModel::headerData (section, orientation, role);
 }
 
-BeaconsModel::BeaconsModel (QObject * parent)
-  : QStandardItemModel {0, sizeof (headings) / sizeof (headings[0]), parent}
+QVariant BeaconsModel::data (QModelIndex const& index, int role) const
 {
-  int column {0};
-  for (auto const& heading : headings)
+  if (!index.isValid () || index.row () >= rowCount ())
     {
-      setHeaderData (column++, Qt::Horizontal, tr (heading));
+      return QVariant {};
+    }
+  auto n = slot (index.row ());
+  switch (role)
+    {
+    case Qt::DisplayRole:
+      switch (index.column ())
+        {
+        case 0: return client_id (index.row ());
+        case 1: return time_[n].toString ("hh:mm");
+        case 2: return QString::number (snr_[n]);
+        case 3: return QString::number (delta_time_[n]);
+        case 4: return Radio::pretty_frequency_MHz_string (frequency_[n]);
+        case 5: return QString::number (drift_[n]);
+        case 6: return grid_[n];
+        case 7: return QString::number (power_[n]);
+        case 8: return live_string (off_air_[n]);
+        case 9: return callsign_[n];
+        }
+      break;
+
+    case Qt::UserRole + 1:
+      switch (index.column ())
+        {
+        case 1: return time_[n];
+        case 2: return snr_[n];
+        case 3: return delta_time_[n];
+        case 4: return frequency_[n];
+        case 5: return drift_[n];
+        case 7: return power_[n];
+        }
+      break;
+
+    case Qt::TextAlignmentRole:
+      switch (index.column ())
+        {
+        case 1: case 2: case 3: case 4: case 5: case 6: case 7:
+          return int (Qt::AlignRight | Qt::AlignVCenter);
+        case 8: return int (Qt::AlignHCenter | Qt::AlignVCenter);
+        default: return int (Qt::AlignLeft | Qt::AlignVCenter);
+        }
+
+    case Qt::FontRole:
+      return text_font;
     }
+  return QVariant {};
+}
+
+void BeaconsModel::move_slot (int from, int to)
+{
+  time_[to] = time_[from];
+  snr_[to] = snr_[from];
+  delta_time_[to] = delta_time_[from];
+  frequency_[to] = frequency_[from];
+  drift_[to] = drift_[from];
+  grid_[to] = grid_[from];
+  power_[to] = power_[from];
+  off_air_[to] = off_air_[from];
+  callsign_[to] = callsign_[from];
 }
 
 void BeaconsModel::add_beacon_spot (bool is_new, QString const& client_id, QTime time, qint32 snr, float delta_time
                                     , Frequency frequency, qint32 drift, QString const& callsign
                                     , QString const& grid, qint32 power, bool off_air)
 {
+  int row {-1};
   if (!is_new)
     {
+      auto key = find_client (client_id);
       int target_row {-1};
-      for (auto row = 0; row < rowCount (); ++row)
+      for (auto r = 0; key >= 0 && r < rowCount (); ++r)
         {
-          if (data (index (row, 0)).toString () == client_id)
+          if (is_client (r, key))
             {
-              auto row_time = item (row, 1)->data ().toTime ();
-              if (row_time == time
-                  && item (row, 2)->data ().toInt () == snr
-                  && item (row, 3)->data ().toFloat () == delta_time
-                  && item (row, 4)->data ().value<Frequency> () == frequency
-                  && data (index (row, 5)).toInt () == drift
-                  && data (index (row, 7)).toString () == grid
-                  && data (index (row, 8)).toInt () == power
-                  && data (index (row, 6)).toString () == live_string (off_air)
-                  && data (index (row, 9)).toString () == callsign)
+              auto n = slot (r);
+              if (time_[n] == time
+                  && snr_[n] == snr
+                  && delta_time_[n] == delta_time
+                  && frequency_[n] == frequency
+                  && drift_[n] == drift
+                  && grid_[n] == grid
+                  && power_[n] == power
+                  && off_air_[n] == off_air
+                  && callsign_[n] == callsign)
                 {
                   return;
                 }
-              if (time <= row_time)
+              if (time <= time_[n])
                 {
-                  target_row = row; // last row with same time
+                  target_row = r; // last row with same time
                 }
             }
         }
       if (target_row >= 0)
         {
-          insertRow (target_row + 1, make_row (client_id, time, snr, delta_time, frequency, drift, callsign, grid, power, off_air));
-          return;
+          row = begin_insert (client_id, target_row + 1);
         }
     }
+  if (row < 0)
+    {
+      row = begin_append (client_id, 1);
+    }
 
-  appendRow (make_row (client_id, time, snr, delta_time, frequency, drift, callsign, grid, power, off_air));
+  auto n = slot (row);
+  time_[n] = time;
+  snr_[n] = snr;
+  delta_time_[n] = delta_time;
+  frequency_[n] = frequency;
+  drift_[n] = drift;
+  grid_[n] = grid;
+  power_[n] = power;
+  off_air_[n] = off_air;
+  callsign_[n] = callsign;
+  end_insert ();
 }
 
 void BeaconsModel::clear_decodes (QString const& client_id)
 {
-  for (auto row = rowCount () - 1; row >= 0; --row)
-    {
-      if (data (index (row, 0)).toString () == client_id)
-        {
-          removeRow (row);
-        }
-    }
+  remove_client (client_id);
 }
 
 #include "moc_BeaconsModel.cpp"
@@ -1,38 +1,61 @@
 #ifndef WSJTX_UDP_BEACONS_MODEL_HPP__
 #define WSJTX_UDP_BEACONS_MODEL_HPP__
 
-#include <QStandardItemModel>
+#include <QVector>
+#include <QTime>
+#include <QString>
 
 #include "MessageServer.hpp"
+#include "RingTableModel.hpp"
 
 using Frequency = MessageServer::Frequency;
 
-class QString;
-class QTime;
+class QModelIndex;
+class QVariant;
 
 //
 // Beacons Model - simple data model for all beacon spots
 //
-// The model is a basic table with uniform row format. Rows consist of
-// QStandardItem instances containing the string representation of the
-// column data  and if the underlying  field is not a  string then the
-// UserRole+1 role contains the underlying data item.
+// The model is a basic table with uniform row format. The display
+// role of each cell is the string representation of the column data
+// and if the underlying  field is not a  string then the UserRole+1
+// role contains the underlying data item.
+//
+// At most capacity spots are held, the oldest are discarded first.
 //
 // Two slots are provided to add a new decode and remove all spots for
 // a client.
 //
 class BeaconsModel
-  : public QStandardItemModel
+  : public RingTableModel
 {
   Q_OBJECT;
 
 public:
-  explicit BeaconsModel (QObject * parent = nullptr);
+  explicit BeaconsModel (QObject * parent = nullptr, int capacity = 10000);
+
+  int columnCount (QModelIndex const& parent = QModelIndex {}) const override;
+  QVariant data (QModelIndex const&, int role = Qt::DisplayRole) const override;
+  QVariant headerData (int section, Qt::Orientation, int role = Qt::DisplayRole) const override;
 
   Q_SLOT void add_beacon_spot (bool is_new, QString const& client_id, QTime time, qint32 snr, float delta_time
                                , Frequency frequency, qint32 drift, QString const& callsign, QString const& grid
                                , qint32 power, bool off_air);
   Q_SLOT void clear_decodes (QString const& client_id);
+
+private:
+  void move_slot (int from, int to) override;
+
+  // column store, indexed by slot
+  QVector<QTime> time_;
+  QVector<qint32> snr_;
+  QVector<float> delta_time_;
+  QVector<Frequency> frequency_;
+  QVector<qint32> drift_;
+  QVector<QString> grid_;
+  QVector<qint32> power_;
+  QVector<bool> off_air_;
+  QVector<QString> callsign_;
 };
 
 #endif
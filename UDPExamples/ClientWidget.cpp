@@ -246,6 +246,11 @@ void ClientWidget::update_status (QString const& id, Frequency f, QString const&
 void ClientWidget::decode_added (bool /*is_new*/, QString const& client_id, QTime /*time*/, qint32 /*snr*/
                                  , float /*delta_time*/, quint32 /*delta_frequency*/, QString const& /*mode*/
                                  , QString const& /*message*/, bool /*low_confidence*/, bool /*off_air*/)
+{
+  decodes_added (client_id, MessageServer::Decodes {});
+}
+
+void ClientWidget::decodes_added (QString const& client_id, MessageServer::Decodes const& /*decodes*/)
 {
   if (client_id == id_ && !columns_resized_)
     {
@@ -34,6 +34,7 @@ public:
   Q_SLOT void decode_added (bool is_new, QString const& client_id, QTime, qint32 snr
                             , float delta_time, quint32 delta_frequency, QString const& mode
                             , QString const& message, bool low_confidence, bool off_air);
+  Q_SLOT void decodes_added (QString const& client_id, MessageServer::Decodes const&);
   Q_SLOT void beacon_spot_added (bool is_new, QString const& client_id, QTime, qint32 snr
                                  , float delta_time, Frequency delta_frequency, qint32 drift
                                  , QString const& callsign, QString const& grid, qint32 power
@@ -1,11 +1,8 @@
 #include "DecodesModel.hpp"
 
-#include <QStandardItem>
 #include <QModelIndex>
-#include <QTime>
-#include <QString>
+#include <QVariant>
 #include <QFont>
-#include <QList>
 
 namespace
 {
@@ -32,82 +29,138 @@ namespace
   }
 
   QFont text_font {"Courier", 10};
+}
 
-  QList<QStandardItem *> make_row (QString const& client_id, QTime time, qint32 snr, float delta_time
-                                   , quint32 delta_frequency, QString const& mode, QString const& message
-                                   , bool low_confidence, bool off_air, bool is_fast)
-  {
-    auto time_item = new QStandardItem {time.toString (is_fast || "~" == mode ? "hh:mm:ss" : "hh:mm")};
-    time_item->setData (time);
-    time_item->setTextAlignment (Qt::AlignRight);
-
-    auto snr_item = new QStandardItem {QString::number (snr)};
-    snr_item->setData (snr);
-    snr_item->setTextAlignment (Qt::AlignRight);
-
-    auto dt = new QStandardItem {QString::number (delta_time)};
-    dt->setData (delta_time);
-    dt->setTextAlignment (Qt::AlignRight);
-
-    auto df = new QStandardItem {QString::number (delta_frequency)};
-    df->setData (delta_frequency);
-    df->setTextAlignment (Qt::AlignRight);
-
-    auto md = new QStandardItem {mode};
-    md->setTextAlignment (Qt::AlignHCenter);
-
-    auto confidence = new QStandardItem {confidence_string (low_confidence)};
-    confidence->setTextAlignment (Qt::AlignHCenter);
-
-    auto live = new QStandardItem {live_string (off_air)};
-    live->setTextAlignment (Qt::AlignHCenter);
-
-    QList<QStandardItem *> row {
-      new QStandardItem {client_id}, time_item, snr_item, dt, df, md, confidence, live, new QStandardItem {message}};
-    Q_FOREACH (auto& item, row)
-      {
-        item->setEditable (false);
-        item->setFont (text_font);
-        item->setTextAlignment (item->textAlignment () | Qt::AlignVCenter);
-      }
-    return row;
-  }
+DecodesModel::DecodesModel (QObject * parent, int capacity)
+  : RingTableModel {capacity, parent}
+  , time_ (capacity)
+  , snr_ (capacity)
+  , delta_time_ (capacity)
+  , delta_frequency_ (capacity)
+  , mode_ (capacity)
+  , message_ (capacity)
+  , low_confidence_ (capacity)
+  , off_air_ (capacity)
+  , is_fast_ (capacity)
+{
+}
+
+int DecodesModel::columnCount (QModelIndex const& parent) const
+{
+  return parent.isValid () ? 0 : sizeof (headings) / sizeof (headings[0]);
 }
 
-DecodesModel::DecodesModel (QObject * parent)
-  : QStandardItemModel {0, sizeof (headings) / sizeof (headings[0]), parent}
+QVariant DecodesModel::headerData (int section, Qt::Orientation orientation, int role) const
 {
-  int column {0};
-  for (auto const& heading : headings)
+  if (Qt::Horizontal == orientation && Qt::DisplayRole == role
+      && section >= 0 && section < columnCount ())
     {
-      setHeaderData (column++, Qt::Horizontal, tr (heading));
+      return tr (headings[section]);
+    }
+  return RingTableModel::headerData (section, orientation, role);
+}
+
+QVariant DecodesModel::data (QModelIndex const& index, int role) const
+{
+  if (!index.isValid () || index.row () >= rowCount ())
+    {
+      return QVariant {};
+    }
+  auto n = slot (index.row ());
+  switch (role)
+    {
+    case Qt::DisplayRole:
+      switch (index.column ())
+        {
+        case 0: return client_id (index.row ());
+        case 1: return time_[n].toString (is_fast_[n] || "~" == mode_[n] ? "hh:mm:ss" : "hh:mm");
+        case 2: return QString::number (snr_[n]);
+        case 3: return QString::number (delta_time_[n]);
+        case 4: return QString::number (delta_frequency_[n]);
+        case 5: return mode_[n];
+        case 6: return confidence_string (low_confidence_[n]);
+        case 7: return live_string (off_air_[n]);
+        case 8: return message_[n];
+        }
+      break;
+
+    case Qt::UserRole + 1:
+      switch (index.column ())
+        {
+        case 1: return time_[n];
+        case 2: return snr_[n];
+        case 3: return delta_time_[n];
+        case 4: return delta_frequency_[n];
+        }
+      break;
+
+    case Qt::TextAlignmentRole:
+      switch (index.column ())
+        {
+        case 1: case 2: case 3: case 4: return int (Qt::AlignRight | Qt::AlignVCenter);
+        case 5: case 6: case 7: return int (Qt::AlignHCenter | Qt::AlignVCenter);
+        default: return int (Qt::AlignLeft | Qt::AlignVCenter);
+        }
+
+    case Qt::FontRole:
+      return text_font;
     }
+  return QVariant {};
+}
+
+void DecodesModel::move_slot (int from, int to)
+{
+  time_[to] = time_[from];
+  snr_[to] = snr_[from];
+  delta_time_[to] = delta_time_[from];
+  delta_frequency_[to] = delta_frequency_[from];
+  mode_[to] = mode_[from];
+  message_[to] = message_[from];
+  low_confidence_[to] = low_confidence_[from];
+  off_air_[to] = off_air_[from];
+  is_fast_[to] = is_fast_[from];
+}
+
+void DecodesModel::set_slot (int n, MessageServer::Decode const& decode, bool is_fast)
+{
+  time_[n] = decode.time;
+  snr_[n] = decode.snr;
+  delta_time_[n] = decode.delta_time;
+  delta_frequency_[n] = decode.delta_frequency;
+  mode_[n] = decode.mode;
+  message_[n] = decode.message;
+  low_confidence_[n] = decode.low_confidence;
+  off_air_[n] = decode.off_air;
+  is_fast_[n] = is_fast;
 }
 
 void DecodesModel::add_decode (bool is_new, QString const& client_id, QTime time, qint32 snr, float delta_time
                                , quint32 delta_frequency, QString const& mode, QString const& message
                                , bool low_confidence, bool off_air, bool is_fast)
 {
+  MessageServer::Decode decode {is_new, time, snr, delta_time, delta_frequency, mode, message
+      , low_confidence, off_air};
   if (!is_new)
     {
+      auto key = find_client (client_id);
       int target_row {-1};
-      for (auto row = 0; row < rowCount (); ++row)
+      for (auto row = 0; key >= 0 && row < rowCount (); ++row)
         {
-          if (data (index (row, 0)).toString () == client_id)
+          if (is_client (row, key))
             {
-              auto row_time = item (row, 1)->data ().toTime ();
-              if (row_time == time
-                  && item (row, 2)->data ().toInt () == snr
-                  && item (row, 3)->data ().toFloat () == delta_time
-                  && item (row, 4)->data ().toUInt () == delta_frequency
-                  && data (index (row, 5)).toString () == mode
-                  && data (index (row, 7)).toString () == confidence_string (low_confidence)
-                  && data (index (row, 6)).toString () == live_string (off_air)
-                  && data (index (row, 8)).toString () == message)
+              auto n = slot (row);
+              if (time_[n] == time
+                  && snr_[n] == snr
+                  && delta_time_[n] == delta_time
+                  && delta_frequency_[n] == delta_frequency
+                  && mode_[n] == mode
+                  && low_confidence_[n] == low_confidence
+                  && off_air_[n] == off_air
+                  && message_[n] == message)
                 {
                   return;
                 }
-              if (time <= row_time)
+              if (time <= time_[n])
                 {
                   target_row = row; // last row with same time
                 }
@@ -115,39 +168,58 @@ void DecodesModel::add_decode (bool is_new, QString const& client_id, QTime time
         }
       if (target_row >= 0)
         {
-          insertRow (target_row + 1, make_row (client_id, time, snr, delta_time, delta_frequency, mode
-                                               , message, low_confidence, off_air, is_fast));
+          auto row = begin_insert (client_id, target_row + 1);
+          set_slot (slot (row), decode, is_fast);
+          end_insert ();
           return;
         }
     }
 
-  appendRow (make_row (client_id, time, snr, delta_time, delta_frequency, mode, message, low_confidence
-                       , off_air, is_fast));
+  auto row = begin_append (client_id, 1);
+  set_slot (slot (row), decode, is_fast);
+  end_insert ();
 }
 
-void DecodesModel::clear_decodes (QString const& client_id)
+void DecodesModel::add_decodes (QString const& client_id, MessageServer::Decodes const& decodes, bool is_fast)
 {
-  for (auto row = rowCount () - 1; row >= 0; --row)
+  // replayed decodes need placing individually, runs of new ones are
+  // appended in one go
+  auto iter = decodes.begin ();
+  while (iter != decodes.end ())
     {
-      if (data (index (row, 0)).toString () == client_id)
+      if (!iter->is_new)
+        {
+          add_decode (false, client_id, iter->time, iter->snr, iter->delta_time, iter->delta_frequency
+                      , iter->mode, iter->message, iter->low_confidence, iter->off_air, is_fast);
+          ++iter;
+          continue;
+        }
+      auto end = iter;
+      while (end != decodes.end () && end->is_new && end - iter < capacity ()) ++end;
+      auto row = begin_append (client_id, end - iter);
+      for (; iter != end; ++iter)
         {
-          removeRow (row);
+          set_slot (slot (row++), *iter, is_fast);
         }
+      end_insert ();
     }
 }
 
+void DecodesModel::clear_decodes (QString const& client_id)
+{
+  remove_client (client_id);
+}
+
 void DecodesModel::do_reply (QModelIndex const& source, quint8 modifiers)
 {
   auto row = source.row ();
-  Q_EMIT reply (data (index (row, 0)).toString ()
-                , item (row, 1)->data ().toTime ()
-                , item (row, 2)->data ().toInt ()
-                , item (row, 3)->data ().toFloat ()
-                , item (row, 4)->data ().toInt ()
-                , data (index (row, 5)).toString ()
-                , data (index (row, 8)).toString ()
-                , confidence_string (true) == data (index (row, 7)).toString ()
-                , modifiers);
+  if (row < 0 || row >= rowCount ())
+    {
+      return;
+    }
+  auto n = slot (row);
+  Q_EMIT reply (client_id (row), time_[n], snr_[n], delta_time_[n], delta_frequency_[n], mode_[n]
+                , message_[n], low_confidence_[n], modifiers);
 }
 
 #include "moc_DecodesModel.cpp"
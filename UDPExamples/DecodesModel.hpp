@@ -1,44 +1,69 @@
 #ifndef WSJTX_UDP_DECODES_MODEL_HPP__
 #define WSJTX_UDP_DECODES_MODEL_HPP__
 
-#include <QStandardItemModel>
+#include <QVector>
+#include <QTime>
+#include <QString>
 
 #include "MessageServer.hpp"
+#include "RingTableModel.hpp"
 
 using Frequency = MessageServer::Frequency;
 
-class QTime;
-class QString;
 class QModelIndex;
+class QVariant;
 
 //
 // Decodes Model - simple data model for all decodes
 //
-// The model is a basic table with uniform row format. Rows consist of
-// QStandardItem instances containing the string representation of the
-// column data  and if the underlying  field is not a  string then the
-// UserRole+1 role contains the underlying data item.
+// The model is a basic table with uniform row format. The display
+// role of each cell is the string representation of the column data
+// and if the underlying  field is not a  string then the UserRole+1
+// role contains the underlying data item.
 //
-// Three slots  are provided to add  a new decode, remove  all decodes
-// for a client  and, to build a  reply to CQ message for  a given row
-// which is emitted as a signal respectively.
+// At most capacity decodes are held, the oldest are discarded first.
+//
+// Four slots are provided to add a new decode, add a batch of decodes
+// from one client, remove all decodes for a client and, to build a
+// reply to CQ message for a given row which is emitted as a signal
+// respectively.
 //
 class DecodesModel
-  : public QStandardItemModel
+  : public RingTableModel
 {
   Q_OBJECT;
 
 public:
-  explicit DecodesModel (QObject * parent = nullptr);
+  explicit DecodesModel (QObject * parent = nullptr, int capacity = 10000);
+
+  int columnCount (QModelIndex const& parent = QModelIndex {}) const override;
+  QVariant data (QModelIndex const&, int role = Qt::DisplayRole) const override;
+  QVariant headerData (int section, Qt::Orientation, int role = Qt::DisplayRole) const override;
 
   Q_SLOT void add_decode (bool is_new, QString const& client_id, QTime time, qint32 snr, float delta_time
                           , quint32 delta_frequency, QString const& mode, QString const& message
                           , bool low_confidence, bool off_air, bool is_fast);
+  Q_SLOT void add_decodes (QString const& client_id, MessageServer::Decodes const&, bool is_fast);
   Q_SLOT void clear_decodes (QString const& client_id);
   Q_SLOT void do_reply (QModelIndex const& source, quint8 modifiers);
 
   Q_SIGNAL void reply (QString const& id, QTime time, qint32 snr, float delta_time, quint32 delta_frequency
                        , QString const& mode, QString const& message, bool low_confidence, quint8 modifiers);
+
+private:
+  void move_slot (int from, int to) override;
+  void set_slot (int slot, MessageServer::Decode const&, bool is_fast);
+
+  // column store, indexed by slot
+  QVector<QTime> time_;
+  QVector<qint32> snr_;
+  QVector<float> delta_time_;
+  QVector<quint32> delta_frequency_;
+  QVector<QString> mode_;
+  QVector<QString> message_;
+  QVector<bool> low_confidence_;
+  QVector<bool> off_air_;
+  QVector<bool> is_fast_;
 };
 
 #endif
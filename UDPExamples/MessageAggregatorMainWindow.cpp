@@ -24,6 +24,8 @@ namespace
     QT_TRANSLATE_NOOP ("MessageAggregatorMainWindow", "Power"),
     QT_TRANSLATE_NOOP ("MessageAggregatorMainWindow", "Comments"),
   };
+
+  int constexpr max_log_rows {1000}; // oldest QSOs are dropped
 }
 
 MessageAggregatorMainWindow::MessageAggregatorMainWindow ()
@@ -95,6 +97,9 @@ MessageAggregatorMainWindow::MessageAggregatorMainWindow ()
                                                     , bool off_air) {
              decodes_model_->add_decode (is_new, id, time, snr, delta_time, delta_frequency, mode, message
                                          , low_confidence, off_air, dock_widgets_[id]->fast_mode ());});
+  connect (server_, &MessageServer::decodes_batch, [this] (QString const& id, MessageServer::Decodes const& decodes) {
+      decodes_model_->add_decodes (id, decodes, dock_widgets_[id]->fast_mode ());
+    });
   connect (server_, &MessageServer::WSPR_decode, beacons_model_, &BeaconsModel::add_beacon_spot);
   connect (server_, &MessageServer::clear_decodes, decodes_model_, &DecodesModel::clear_decodes);
   connect (server_, &MessageServer::clear_decodes, beacons_model_, &BeaconsModel::clear_decodes);
@@ -129,6 +134,10 @@ void MessageAggregatorMainWindow::log_qso (QString const& /*id*/, QDateTime time
   << new QStandardItem {tx_power}
   << new QStandardItem {comments};
   log_->appendRow (row);
+  if (log_->rowCount () > max_log_rows)
+    {
+      log_->removeRows (0, log_->rowCount () - max_log_rows);
+    }
   log_table_view_->resizeColumnsToContents ();
   log_table_view_->horizontalHeader ()->setStretchLastSection (true);
   log_table_view_->scrollToBottom ();
@@ -144,6 +153,7 @@ void MessageAggregatorMainWindow::add_client (QString const& id, QString const&
   addDockWidget (Qt::BottomDockWidgetArea, dock);
   connect (server_, &MessageServer::status_update, dock, &ClientWidget::update_status);
   connect (server_, &MessageServer::decode, dock, &ClientWidget::decode_added);
+  connect (server_, &MessageServer::decodes_batch, dock, &ClientWidget::decodes_added);
   connect (server_, &MessageServer::WSPR_decode, dock, &ClientWidget::beacon_spot_added);
   connect (server_, &MessageServer::clear_decodes, dock, &ClientWidget::clear_decodes);
   connect (dock, &ClientWidget::do_reply, decodes_model_, &DecodesModel::do_reply);
@@ -0,0 +1,125 @@
+#include "RingTableModel.hpp"
+
+#include <QModelIndex>
+
+RingTableModel::RingTableModel (int capacity, QObject * parent)
+  : QAbstractTableModel {parent}
+  , capacity_ {capacity}
+  , head_ {0}
+  , size_ {0}
+  , clients_ (capacity)
+{
+}
+
+int RingTableModel::rowCount (QModelIndex const& parent) const
+{
+  return parent.isValid () ? 0 : size_;
+}
+
+int RingTableModel::find_client (QString const& client_id) const
+{
+  auto iter = client_keys_.find (client_id);
+  return iter != client_keys_.end () && client_rows_[*iter] ? *iter : -1;
+}
+
+int RingTableModel::client_key (QString const& client_id)
+{
+  auto iter = client_keys_.find (client_id);
+  if (iter != client_keys_.end ())
+    {
+      return *iter;
+    }
+  auto key = client_ids_.size ();
+  client_ids_ << client_id;
+  client_rows_ << 0;
+  client_keys_[client_id] = key;
+  return key;
+}
+
+int RingTableModel::begin_append (QString const& client_id, int count)
+{
+  Q_ASSERT (count > 0 && count <= capacity_);
+  auto key = client_key (client_id);
+  if (size_ + count > capacity_)
+    {
+      remove_rows (0, size_ + count - capacity_ - 1);
+    }
+  auto first = size_;
+  beginInsertRows (QModelIndex {}, first, first + count - 1);
+  for (auto row = first; row < first + count; ++row)
+    {
+      clients_[slot (row)] = key;
+    }
+  client_rows_[key] += count;
+  size_ += count;
+  return first;
+}
+
+int RingTableModel::begin_insert (QString const& client_id, int row)
+{
+  auto key = client_key (client_id);
+  if (size_ == capacity_)
+    {
+      remove_rows (0, 0);
+      row = qMax (row - 1, 0);
+    }
+  beginInsertRows (QModelIndex {}, row, row);
+  for (auto r = size_; r > row; --r) // slot (size_) is free
+    {
+      clients_[slot (r)] = clients_[slot (r - 1)];
+      move_slot (slot (r - 1), slot (r));
+    }
+  clients_[slot (row)] = key;
+  ++client_rows_[key];
+  ++size_;
+  return row;
+}
+
+void RingTableModel::remove_client (QString const& client_id)
+{
+  auto key = find_client (client_id);
+  if (key < 0)
+    {
+      return;
+    }
+
+  // remove runs of rows  from the end backwards so that lower row
+  // numbers stay valid, decodes from one client tend to be adjacent
+  // so there are few runs
+  auto row = size_;
+  while (row > 0 && client_rows_[key])
+    {
+      while (row > 0 && !is_client (row - 1, key)) --row;
+      auto last = row - 1;
+      while (row > 0 && is_client (row - 1, key)) --row;
+      if (last >= row)
+        {
+          remove_rows (row, last);
+        }
+    }
+}
+
+void RingTableModel::remove_rows (int first, int last)
+{
+  beginRemoveRows (QModelIndex {}, first, last);
+  auto count = last - first + 1;
+  for (auto row = first; row <= last; ++row)
+    {
+      --client_rows_[clients_[slot (row)]];
+    }
+  if (!first)
+    {
+      // dropping the oldest rows only moves the head
+      head_ = (head_ + count) % capacity_;
+    }
+  else
+    {
+      for (auto row = last + 1; row < size_; ++row)
+        {
+          clients_[slot (row - count)] = clients_[slot (row)];
+          move_slot (slot (row), slot (row - count));
+        }
+    }
+  size_ -= count;
+  endRemoveRows ();
+}
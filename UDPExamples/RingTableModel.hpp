@@ -0,0 +1,73 @@
+#ifndef WSJTX_UDP_RING_TABLE_MODEL_HPP__
+#define WSJTX_UDP_RING_TABLE_MODEL_HPP__
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QHash>
+#include <QString>
+
+class QModelIndex;
+
+//
+// Ring Table Model - base class for the decode and beacon tables
+//
+// Rows are held in a fixed capacity ring, derived classes store each
+// column in its own vector indexed by slot() rather than allocating
+// an item per cell. When the ring is full the oldest rows are dropped
+// to make room for new ones.
+//
+// Every row belongs to a client, client ids are mapped to small
+// integer keys so rows can be matched and removed per client without
+// comparing strings.
+//
+class RingTableModel
+  : public QAbstractTableModel
+{
+public:
+  int rowCount (QModelIndex const& parent = QModelIndex {}) const override;
+  int capacity () const {return capacity_;}
+
+protected:
+  RingTableModel (int capacity, QObject * parent);
+
+  // storage slot of a row, valid for all column vectors
+  int slot (int row) const {return (head_ + row) % capacity_;}
+
+  QString const& client_id (int row) const {return client_ids_[clients_[slot (row)]];}
+  bool is_client (int row, int key) const {return clients_[slot (row)] == key;}
+
+  // key for a client id or -1 if there are no rows for it
+  int find_client (QString const& client_id) const;
+
+  // start appending count (<= capacity()) rows for a client, returns
+  // the first new row, set the column data for the new rows and call
+  // end_insert()
+  int begin_append (QString const& client_id, int count);
+
+  // start inserting one row for a client before row, returns the row
+  // actually used as the oldest row may have been dropped, set the
+  // column data for it and call end_insert()
+  int begin_insert (QString const& client_id, int row);
+
+  void end_insert () {endInsertRows ();}
+
+  // remove all rows for a client
+  void remove_client (QString const& client_id);
+
+private:
+  // copy the column data of a slot to another slot
+  virtual void move_slot (int from, int to) = 0;
+
+  int client_key (QString const& client_id);
+  void remove_rows (int first, int last);
+
+  int capacity_;
+  int head_;
+  int size_;
+  QVector<int> clients_;                // client key per slot
+  QVector<QString> client_ids_;         // indexed by client key
+  QVector<int> client_rows_;            // row count per client key
+  QHash<QString, int> client_keys_;
+};
+
+#endif
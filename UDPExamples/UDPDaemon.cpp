@@ -81,6 +81,15 @@ public:
       }
   }
 
+  Q_SLOT void decodes_added (QString const& client_id, MessageServer::Decodes const& decodes)
+  {
+    for (auto const& d : decodes)
+      {
+        decode_added (d.is_new, client_id, d.time, d.snr, d.delta_time, d.delta_frequency, d.mode
+                      , d.message, d.low_confidence, d.off_air);
+      }
+  }
+
   Q_SLOT void beacon_spot_added (bool is_new, QString const& client_id, QTime time, qint32 snr
       , float delta_time, Frequency delta_frequency, qint32 drift, QString const& callsign
                                  , QString const& grid, qint32 power, bool off_air)
@@ -126,6 +135,7 @@ private:
     auto client = new Client {id};
     connect (server_, &MessageServer::status_update, client, &Client::update_status);
     connect (server_, &MessageServer::decode, client, &Client::decode_added);
+    connect (server_, &MessageServer::decodes_batch, client, &Client::decodes_added);
     connect (server_, &MessageServer::WSPR_decode, client, &Client::beacon_spot_added);
     clients_[id] = client;
     server_->replay (id);
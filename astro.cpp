@@ -4,11 +4,13 @@
 
 #include <QApplication>
 #include <QFile>
+#include <QStringList>
 #include <QTextStream>
 #include <QSettings>
 #include <QDateTime>
 #include <QDir>
 #include <QCloseEvent>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QDebug>
 
 #include "commons.h"
@@ -20,24 +22,14 @@
 #include "ui_astro.h"
 #include "moc_astro.cpp"
 
-
-extern "C" {
-  void astrosub_(int* nyear, int* month, int* nday, double* uth, double* freqMoon,
-                 const char* mygrid, const char* hisgrid, double* azsun,
-                 double* elsun, double* azmoon, double* elmoon, double* azmoondx,
-                 double* elmoondx, int* ntsky, int* ndop, int* ndop00,
-                 double* ramoon, double* decmoon, double* dgrd, double* poloffset,
-                 double* xnr, double* techo, double* width1, double* width2,
-                 bool* bTx, const char* AzElFileName, const char* jpleph,
-                 int len1, int len2, int len3, int len4);
-}
-
 Astro::Astro(QSettings * settings, Configuration const * configuration, QWidget * parent)
   : QDialog {parent, Qt::WindowTitleHint}
   , settings_ {settings}
   , configuration_ {configuration}
   , ui_ {new Ui::Astro}
+  , ephemeris_ {configuration_->data_dir ().absoluteFilePath ("JPLEPH")}
   , m_DopplerMethod {0}
+  , azel_interval_ {0}
 {
   ui_->setupUi (this);
   setWindowTitle (QApplication::applicationName () + " - " + tr ("Astronomical Data"));
@@ -52,6 +44,7 @@ Astro::~Astro ()
   ui_->cbDopplerTracking->setChecked (false);
   Q_EMIT tracking_update ();
   if (isVisible ()) write_settings ();
+  azel_writer_.waitForFinished ();
 }
 
 void Astro::closeEvent (QCloseEvent * e)
@@ -72,6 +65,7 @@ void Astro::read_settings ()
     case 2: ui_->rbConstFreqOnMoon->setChecked (true); break;
     case 3: ui_->rbRxOnly->setChecked (true); break;
     }
+  azel_interval_ = settings_->value ("AzElInterval", 0).toInt ();
   move (settings_->value ("window/pos", pos ()).toPoint ());
 }
 
@@ -87,39 +81,41 @@ auto Astro::astroUpdate(QDateTime const& t, QString const& mygrid, QString const
                         bool dx_is_self, bool bTx, bool no_tx_QSY, int TR_period) -> Correction
 {
   Frequency freq_moon {freq};
-  double azsun,elsun,azmoon,elmoon,azmoondx,elmoondx;
-  double ramoon,decmoon,dgrd,poloffset,xnr,techo,width1,width2;
-  int ntsky;
   QString date {t.date().toString("yyyy MMM dd").trimmed ()};
   QString utc {t.time().toString().trimmed ()};
-  int nyear {t.date().year()};
-  int month {t.date().month()};
-  int nday {t.date().day()};
-  int nhr {t.time().hour()};
-  int nmin {t.time().minute()};
-  double sec {t.time().second() + 0.001*t.time().msec()};
-  double uth {nhr + nmin/60.0 + sec/3600.0};
   if(freq_moon < 1) freq_moon = 144000000;
   int nfreq {static_cast<int> (freq_moon / 1000000u)};
-  double freq8 {static_cast<double> (freq_moon)};
-  auto const& AzElFileName = QDir::toNativeSeparators (configuration_->azel_directory ().absoluteFilePath ("azel.dat"));
-  auto const& jpleph = configuration_->data_dir ().absoluteFilePath ("JPLEPH");
-  int ndop;
-  int ndop00;
 
   QString mygrid_padded {(mygrid + "      ").left (6)};
   QString hisgrid_padded {(hisgrid + "      ").left (6)};
-  astrosub_(&nyear, &month, &nday, &uth, &freq8, mygrid_padded.toLatin1().constData(),
-	    hisgrid_padded.toLatin1().constData(), &azsun, &elsun, &azmoon, &elmoon,
-      &azmoondx, &elmoondx, &ntsky, &ndop, &ndop00, &ramoon, &decmoon,
-	    &dgrd, &poloffset, &xnr, &techo, &width1, &width2, &bTx,
-	    AzElFileName.toLatin1().constData(), jpleph.toLatin1().constData(), 6, 6,
-	    AzElFileName.length(), jpleph.length());
+  auto position = ephemeris_.position (t, mygrid_padded, hisgrid_padded, freq_moon);
+  write_azel (t, position, nfreq, bTx);
+  double azsun {position.az_sun};
+  double elsun {position.el_sun};
+  double azmoon {position.az_moon};
+  double elmoon {position.el_moon};
+  double azmoondx {position.az_moon_dx};
+  double elmoondx {position.el_moon_dx};
+  double decmoon {position.dec_moon};
+  double dgrd {position.dgrd};
+  double poloffset {position.poloffset};
+  double xnr {position.xnr};
+  double techo {position.techo};
+  double width1 {position.width1};
+  double width2 {position.width2};
+  int ntsky {position.ntsky};
+  int ndop {qRound (position.doppler)};
+  int ndop00 {qRound (position.doppler00)};
+  double doppler {position.doppler};
+  double dfdt {position.dfdt / 60.}; // Hz/s
+  double dfdt00 {position.dfdt00 / 60.};
 
   if(hisgrid_padded=="      ") {
     azmoondx=0.0;
     elmoondx=0.0;
     ndop=0;
+    doppler=0.0;
+    dfdt=0.0;
     width2=0.0;
   }
   QString message;
@@ -161,43 +157,46 @@ auto Astro::astroUpdate(QDateTime const& t, QString const& mygrid, QString const
       case 1: // All Doppler correction done here; DX station stays at nominal dial frequency.
       case 3: // Both stations do full correction on Rx and none on Tx
         correction.rx = dx_is_self ? ndop00 : ndop;
+        correction.rx_exact = dx_is_self ? position.doppler00 : doppler;
+        correction.rx_rate = dx_is_self ? dfdt00 : dfdt;
         break;
 
       case 2:
         // Doppler correction to constant frequency on Moon
         correction.rx = ndop00 / 2;
+        correction.rx_exact = position.doppler00 / 2.;
+        correction.rx_rate = dfdt00 / 2.;
         break;
       }
 
-    if (3 != m_DopplerMethod) correction.tx = -correction.rx;
-    if(dx_is_self && m_DopplerMethod == 1) correction.rx = 0;
+    if (3 != m_DopplerMethod)
+      {
+        correction.tx = -correction.rx;
+        correction.tx_exact = -correction.rx_exact;
+        correction.tx_rate = -correction.rx_rate;
+      }
+    if(dx_is_self && m_DopplerMethod == 1)
+      {
+        correction.rx = 0;
+        correction.rx_exact = 0.;
+        correction.rx_rate = 0.;
+      }
 
     if (no_tx_QSY && 3 != m_DopplerMethod && 0 != m_DopplerMethod)
       {
         // calculate a single correction for transmit half way through
         // the period as a compromise for rigs that can't CAT QSY
-        // while transmitting
+        // while transmitting, tx_exact still follows the Doppler so
+        // the audio can correct what is left
         //
         // use a base time of (secs-since-epoch + 2) so as to be sure
         // we do the next period if we calculate just before it starts
         auto sec_since_epoch = t.toMSecsSinceEpoch () / 1000 + 2;
         auto target_sec = sec_since_epoch - sec_since_epoch % TR_period + TR_period / 2;
-        auto target_date_time = QDateTime::fromMSecsSinceEpoch (target_sec * 1000);
-        QString date {target_date_time.date().toString("yyyy MMM dd").trimmed ()};
-        QString utc {target_date_time.time().toString().trimmed ()};
-        int nyear {target_date_time.date().year()};
-        int month {target_date_time.date().month()};
-        int nday {target_date_time.date().day()};
-        int nhr {target_date_time.time().hour()};
-        int nmin {target_date_time.time().minute()};
-        double sec {target_date_time.time().second() + 0.001*target_date_time.time().msec()};
-        double uth {nhr + nmin/60.0 + sec/3600.0};
-        astrosub_(&nyear, &month, &nday, &uth, &freq8, mygrid_padded.toLatin1().constData(),
-                  hisgrid_padded.toLatin1().constData(), &azsun, &elsun, &azmoon, &elmoon,
-                  &azmoondx, &elmoondx, &ntsky, &ndop, &ndop00, &ramoon, &decmoon,
-                  &dgrd, &poloffset, &xnr, &techo, &width1, &width2, &bTx,
-                  "", jpleph.toLatin1().constData(), 6, 6,
-                  0, jpleph.length());
+        auto target = ephemeris_.position (QDateTime::fromMSecsSinceEpoch (target_sec * 1000, Qt::UTC)
+                                           , mygrid_padded, hisgrid_padded, freq_moon);
+        ndop = qRound (target.doppler);
+        ndop00 = qRound (target.doppler00);
         FrequencyDelta offset {0};
         switch (m_DopplerMethod)
           {
@@ -217,6 +216,56 @@ auto Astro::astroUpdate(QDateTime const& t, QString const& mygrid, QString const
   return correction;
 }
 
+void Astro::write_azel (QDateTime const& t, Ephemeris::Position const& position, int nfreq, bool bTx)
+{
+  // azel.dat is polled by rotator and tracking programs, write it on
+  // change or every azel_interval_ seconds, never on the GUI thread
+  QStringList lines;
+  lines << QString {}.sprintf (",%5.1f,%5.1f,Moon", position.az_moon, position.el_moon)
+        << QString {}.sprintf (",%5.1f,%5.1f,Sun", position.az_sun, position.el_sun)
+        << QString {}.sprintf (",%5.1f,%5.1f,Source", 0., 0.);
+  auto doppler = QString {}.sprintf ("%5d,%8.1f,%8.2f,%8.1f,%8.2f,Doppler, %c", nfreq
+                                     , static_cast<double> (qRound (position.doppler)), position.dfdt
+                                     , static_cast<double> (qRound (position.doppler00)), position.dfdt00
+                                     , bTx ? 'T' : 'R');
+  // the Doppler rates change every tick, so leave them out of the
+  // comparison, a change in Doppler itself still writes them
+  auto contents = lines.join ('|') + QString {}.sprintf ("%5d,%8.1f,%8.1f,%c", nfreq
+                                                        , static_cast<double> (qRound (position.doppler))
+                                                        , static_cast<double> (qRound (position.doppler00))
+                                                        , bTx ? 'T' : 'R');
+  if (azel_interval_ > 0)
+    {
+      if (azel_written_.isValid () && azel_written_.secsTo (t) < azel_interval_) return;
+    }
+  else if (contents == azel_contents_)
+    {
+      return;
+    }
+  if (azel_writer_.isRunning ()) return; // try again next time
+  azel_written_ = t;
+  azel_contents_ = contents;
+  auto file_name = configuration_->azel_directory ().absoluteFilePath ("azel.dat");
+  auto time = t.time ().toString ("hh:mm:ss");
+  QString text;
+  for (auto const& line : lines)
+    {
+      text += time + line + '\n';
+    }
+  text += doppler + '\n';
+  azel_writer_ = QtConcurrent::run ([file_name, text] {
+      QFile f {file_name};
+      if (f.open (QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+        {
+          f.write (text.toLatin1 ());
+        }
+      else
+        {
+          qDebug () << "Error opening azel.dat:" << f.errorString ();
+        }
+    });
+}
+
 void Astro::check_split ()
 {
   if (doppler_tracking () && !configuration_->split_mode ())
@@ -4,8 +4,11 @@
 
 #include <QDialog>
 #include <QScopedPointer>
+#include <QDateTime>
+#include <QFuture>
 
 #include "Radio.hpp"
+#include "Ephemeris.hpp"
 
 class QSettings;
 class Configuration;
@@ -30,12 +33,23 @@ public:
     Correction ()
       : rx {0}
       , tx {0}
+      , rx_exact {0.}
+      , tx_exact {0.}
+      , rx_rate {0.}
+      , tx_rate {0.}
     {}
     Correction (Correction const&) = default;
     Correction& operator = (Correction const&) = default;
 
-    FrequencyDelta rx;
+    FrequencyDelta rx;          // whole Hz for CAT
     FrequencyDelta tx;
+
+    // unrounded corrections at this instant and their rates of change
+    // in Hz/s, what is left after CAT can be corrected in the audio
+    double rx_exact;
+    double tx_exact;
+    double rx_rate;
+    double tx_rate;
   };
   Correction astroUpdate(QDateTime const& t,
                          QString const& mygrid,
@@ -65,12 +79,18 @@ private:
   void read_settings ();
   void write_settings ();
   void check_split ();
+  void write_azel (QDateTime const&, Ephemeris::Position const&, int nfreq, bool bTx);
 
   QSettings * settings_;
   Configuration const * configuration_;
   QScopedPointer<Ui::Astro> ui_;
+  Ephemeris ephemeris_;
 
   qint32 m_DopplerMethod;
+  int azel_interval_;           // seconds, 0 to write on change
+  QDateTime azel_written_;
+  QString azel_contents_;       // without the times
+  QFuture<void> azel_writer_;
 };
 
 inline
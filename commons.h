@@ -4,6 +4,16 @@
 #define NSMAX 6827
 #define NTMAX 300
 #define RX_SAMPLE_RATE 12000
+#define MAXDECODES 500
+#define MAXAVERAGE 64
+#define MAXSTAGES 16
+
+/* results.nskipped bits, see lib/decode_budget.f90 */
+#define SKIP_OSD 1
+#define SKIP_AP 2
+#define SKIP_PASSES 4
+#define SKIP_TRIALS 8
+#define SKIP_CANDIDATES 16
 
 #ifdef __cplusplus
 #include <cstdbool>
@@ -57,12 +67,35 @@ extern struct dec_data {
     int naggressive;
     bool nrobust;
     int nexp_decode;
+    int nbudget;                // ms for this pass, 0 no limit, see decode_budget.f90
     char datetime[20];
     char mycall[12];
     char mygrid[6];
     char hiscall[12];
     char hisgrid[6];
   } params;
+
+  /*
+   * Decoder output written by jt9, wsjtx only copies the members
+   * above into the shared memory region.  Strings are blank padded.
+   */
+  struct
+  {
+    int ndecodes;
+    char decodes[MAXDECODES][80]; // this period's decodes, was decoded.txt
+    int naverage;
+    char average[MAXAVERAGE][40]; // message averaging table, was avemsg.txt
+    int nred;                   // points of the QRA64 sync curve in sred
+    float fred;                 // frequency of sred[0] (Hz)
+    float dfred;                // spacing of the sred points (Hz)
+    int ncandidates;            // sync candidates tried this pass
+    int nskipped;               // stages skipped, see decode_budget.f90
+    float elapsed;              // decoding time (s), jt9 -P only
+    int nstages;                // busiest timer() stages, jt9 -P only
+    char stages[MAXSTAGES][8];
+    float stage_time[MAXSTAGES]; // (s) summed over threads
+    int stage_calls[MAXSTAGES];
+  } results;
 } dec_data;
 
 extern struct {
@@ -78,6 +111,10 @@ extern struct {
   float red[4096];
 } echocom_;
 
+extern struct {
+  int   ntrained;
+} fftwtrained_;
+
 #ifdef __cplusplus
 }
 #endif
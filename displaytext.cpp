@@ -7,6 +7,7 @@
 #include <QTextBlock>
 #include <QMenu>
 #include <QAction>
+#include <QRegularExpression>
 
 #include "qt_helpers.hpp"
 
@@ -15,6 +16,8 @@
 DisplayText::DisplayText(QWidget *parent)
   : QTextEdit(parent)
   , erase_action_ {new QAction {tr ("&Erase"), this}}
+  , workedB4_generation_ {0}
+  , batch_depth_ {0}
 {
   setReadOnly (true);
   viewport ()->setCursor (Qt::ArrowCursor);
@@ -74,7 +77,7 @@ void DisplayText::insertLineSpacer(QString const& line)
 
 void DisplayText::appendText(QString const& text, QColor bg)
 {
-  auto cursor = textCursor ();
+  auto cursor = batch_depth_ ? batch_cursor_ : textCursor ();
   cursor.movePosition (QTextCursor::End);
   auto block_format = cursor.blockFormat ();
   block_format.setBackground (bg);
@@ -91,6 +94,13 @@ void DisplayText::appendText(QString const& text, QColor bg)
     }
   cursor.insertText (text);
 
+  if (batch_depth_)
+    {
+      // view is updated when the batch ends
+      batch_cursor_ = cursor;
+      return;
+    }
+
   // position so viewport scrolled to left
   cursor.movePosition (QTextCursor::StartOfLine);
   setTextCursor (cursor);
@@ -98,6 +108,72 @@ void DisplayText::appendText(QString const& text, QColor bg)
   document ()->setMaximumBlockCount (document ()->maximumBlockCount ());
 }
 
+void DisplayText::beginBatch ()
+{
+  if (!batch_depth_++)
+    {
+      batch_cursor_ = textCursor ();
+      batch_cursor_.beginEditBlock ();
+    }
+}
+
+void DisplayText::endBatch ()
+{
+  if (batch_depth_ && !--batch_depth_)
+    {
+      batch_cursor_.endEditBlock ();
+
+      // position so viewport scrolled to left
+      batch_cursor_.movePosition (QTextCursor::End);
+      batch_cursor_.movePosition (QTextCursor::StartOfLine);
+      setTextCursor (batch_cursor_);
+      ensureCursorVisible ();
+      document ()->setMaximumBlockCount (document ()->maximumBlockCount ());
+      batch_cursor_ = QTextCursor {};
+    }
+}
+
+auto DisplayText::workedB4 (QString const& call, LogBook const& logBook) -> WorkedB4 const&
+{
+  if (logBook.generation () != workedB4_generation_)
+    {
+      // worked before status may have changed
+      workedB4_cache_.clear ();
+      workedB4_generation_ = logBook.generation ();
+    }
+  auto entry = workedB4_cache_.find (call);
+  if (entry != workedB4_cache_.end ())
+    {
+      return *entry;
+    }
+
+  QString countryName;
+  bool callWorkedBefore;
+  bool countryWorkedBefore;
+  logBook.match(/*in*/call,/*out*/countryName,callWorkedBefore,countryWorkedBefore);
+
+  // do some obvious abbreviations
+  countryName.replace ("Islands", "Is.");
+  countryName.replace ("Island", "Is.");
+  countryName.replace ("North ", "N. ");
+  countryName.replace ("Northern ", "N. ");
+  countryName.replace ("South ", "S. ");
+  countryName.replace ("East ", "E. ");
+  countryName.replace ("Eastern ", "E. ");
+  countryName.replace ("West ", "W. ");
+  countryName.replace ("Western ", "W. ");
+  countryName.replace ("Central ", "C. ");
+  countryName.replace (" and ", " & ");
+  countryName.replace ("Republic", "Rep.");
+  countryName.replace ("United States", "U.S.A.");
+  countryName.replace ("Fed. Rep. of ", "");
+  countryName.replace ("French ", "Fr.");
+  countryName.replace ("Asiatic", "AS");
+  countryName.replace ("European", "EU");
+  countryName.replace ("African", "AF");
+
+  return *workedB4_cache_.insert (call, {countryName, callWorkedBefore, countryWorkedBefore});
+}
 
 QString DisplayText::appendDXCCWorkedB4(QString message, QString const& callsign, QColor * bg,
           LogBook const& logBook, QColor color_CQ,
@@ -107,9 +183,6 @@ QString DisplayText::appendDXCCWorkedB4(QString message, QString const& callsign
   // allow for seconds
   int padding {message.indexOf (" ") > 4 ? 2 : 0};
   QString call = callsign;
-  QString countryName;
-  bool callWorkedBefore;
-  bool countryWorkedBefore;
 
   if(call.length()==2) {
     int i0=message.indexOf("CQ "+call);
@@ -118,20 +191,21 @@ QString DisplayText::appendDXCCWorkedB4(QString message, QString const& callsign
     call=call.mid(0,i0);
   }
   if(call.length()<3) return message;
-  if(!call.contains(QRegExp("[0-9]|[A-Z]"))) return message;
+  static QRegularExpression const call_re {"[0-9]|[A-Z]"};
+  if(!call.contains(call_re)) return message;
 
-  logBook.match(/*in*/call,/*out*/countryName,callWorkedBefore,countryWorkedBefore);
+  auto const& info = workedB4 (call, logBook);
 
   message = message.trimmed ();
   QString appendage;
-  if (!countryWorkedBefore) // therefore not worked call either
+  if (!info.country_worked) // therefore not worked call either
     {
       appendage += "!";
       *bg = color_DXCC;
     }
   else
     {
-      if (!callWorkedBefore) // but have worked the country
+      if (!info.call_worked) // but have worked the country
         {
           appendage += "~";
           *bg = color_NewCall;
@@ -143,27 +217,7 @@ QString DisplayText::appendDXCCWorkedB4(QString message, QString const& callsign
         }
     }
 
-  // do some obvious abbreviations
-  countryName.replace ("Islands", "Is.");
-  countryName.replace ("Island", "Is.");
-  countryName.replace ("North ", "N. ");
-  countryName.replace ("Northern ", "N. ");
-  countryName.replace ("South ", "S. ");
-  countryName.replace ("East ", "E. ");
-  countryName.replace ("Eastern ", "E. ");
-  countryName.replace ("West ", "W. ");
-  countryName.replace ("Western ", "W. ");
-  countryName.replace ("Central ", "C. ");
-  countryName.replace (" and ", " & ");
-  countryName.replace ("Republic", "Rep.");
-  countryName.replace ("United States", "U.S.A.");
-  countryName.replace ("Fed. Rep. of ", "");
-  countryName.replace ("French ", "Fr.");
-  countryName.replace ("Asiatic", "AS");
-  countryName.replace ("European", "EU");
-  countryName.replace ("African", "AF");
-
-  appendage += countryName;
+  appendage += info.country;
 
   // use a nbsp to save the start of appended text so we can find
   // it again later, align appended data at a fixed column if
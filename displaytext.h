@@ -3,7 +3,9 @@
 #define DISPLAYTEXT_H
 
 #include <QTextEdit>
+#include <QTextCursor>
 #include <QFont>
+#include <QHash>
 
 #include "logbook/logbook.h"
 #include "decodedtext.h"
@@ -26,6 +28,26 @@ public:
 			      QColor color_TxMsg, bool bFastMode);
   void displayQSY(QString text);
 
+  //
+  // Batch appends so that a whole decode period goes into the
+  // document as a single edit block, the view is only scrolled once
+  // when the outermost batch ends. Batches may nest.
+  //
+  void beginBatch ();
+  void endBatch ();
+
+  class Batch final
+  {
+  public:
+    explicit Batch (DisplayText * display) : display_ {display} {display_->beginBatch ();}
+    ~Batch () {display_->endBatch ();}
+    Batch (Batch const&) = delete;
+    Batch& operator = (Batch const&) = delete;
+
+  private:
+    DisplayText * display_;
+  };
+
   Q_SIGNAL void selectCallsign (Qt::KeyboardModifiers);
   Q_SIGNAL void erased ();
 
@@ -39,8 +61,22 @@ private:
   QString appendDXCCWorkedB4(QString message, QString const& callsign, QColor * bg, LogBook const& logBook,
 			     QColor color_CQ, QColor color_DXCC, QColor color_NewCall);
 
+  // per session cache of DXCC entity and worked before status
+  // keyed by callsign, discarded when the log book changes
+  struct WorkedB4
+  {
+    QString country;            // abbreviated for display
+    bool call_worked;
+    bool country_worked;
+  };
+  WorkedB4 const& workedB4 (QString const& call, LogBook const&);
+
   QFont char_font_;
   QAction * erase_action_;
+  QHash<QString, WorkedB4> workedB4_cache_;
+  unsigned workedB4_generation_;
+  int batch_depth_;
+  QTextCursor batch_cursor_;
 };
 
 #endif // DISPLAYTEXT_H
@@ -1,7 +1,7 @@
 subroutine astro0(nyear,month,nday,uth8,freq8,mygrid,hisgrid,              &
      AzSun8,ElSun8,AzMoon8,ElMoon8,AzMoonB8,ElMoonB8,ntsky,ndop,ndop00,    &
      dbMoon8,RAMoon8,DecMoon8,HA8,Dgrd8,sd8,poloffset8,xnr8,dfdt,dfdt0,    &
-     width1,width2,xlst8,techo8)
+     width1,width2,xlst8,techo8,doppler8,doppler008)
 
   parameter (DEGS=57.2957795130823d0)
   character*6 mygrid,hisgrid
@@ -9,6 +9,7 @@ subroutine astro0(nyear,month,nday,uth8,freq8,mygrid,hisgrid,              &
   real*8 dbMoon8,RAMoon8,DecMoon8,HA8,Dgrd8,xnr8,dfdt,dfdt0,dt
   real*8 sd8,poloffset8,width1,width2,xlst8
   real*8 uth8,techo8,freq8
+  real*8 doppler8,doppler008             !Unrounded ndop and ndop00
   real*8 xl,b
   common/librcom/xl(2),b(2)
   data uth8z/0.d0/
@@ -60,6 +61,8 @@ subroutine astro0(nyear,month,nday,uth8,freq8,mygrid,hisgrid,              &
   xnr8=xnr
   ndop=nint(doppler)
   ndop00=nint(doppler00)
+  doppler8=doppler
+  doppler008=doppler00
 
   if(uth8z.eq.0.d0) then
      uth8z=uth8-1.d0/3600.d0
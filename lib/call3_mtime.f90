@@ -0,0 +1,15 @@
+integer function call3_mtime()
+
+! Modification time of CALL3.TXT, or -1 if it cannot be found.  The
+! deep search routines (hint65, deep4) keep their pre-encoded message
+! lists between calls and use this to know when they are stale.
+
+  use prog_args
+  integer values(13)
+
+  call3_mtime=-1
+  call stat(trim(data_dir)//'/CALL3.TXT',values,ierr)
+  if(ierr.eq.0) call3_mtime=values(10)
+
+  return
+end function call3_mtime
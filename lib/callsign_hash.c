@@ -0,0 +1,205 @@
+/*
+ callsign_hash - see callsign_hash.h
+
+ The file is a header followed by SLOTS entries, an all zero entry is
+ empty so a new file needs no initialising beyond its header.  An
+ entry is found within PROBES slots of its home slot, lookups stop at
+ the first empty slot as entries are never removed, only replaced.
+
+ A writer clears the check before changing an entry and sets it
+ last, a reader that sees a check not matching the entry treats it as
+ absent.  Entries are written from the decoders' single threaded
+ paths only.
+
+ License: GNU GPL v3
+ */
+
+#include "callsign_hash.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "wsprd/nhash.h"
+
+#define MAGIC "WSJTHSH1"
+#define SLOT_BITS 16
+#define SLOTS (1u << SLOT_BITS)
+#define PROBES 16
+
+struct header {
+    char magic[8];
+    uint32_t slots;
+    uint32_t entry_size;
+};
+
+struct entry {
+    uint32_t key;               /* kind << 16 | hash, 0 when empty */
+    uint32_t seen;              /* time() of the last put */
+    uint32_t check;             /* entry_check() */
+    char text[CALLSIGN_HASH_TEXT];
+};
+
+#define FILE_SIZE (sizeof (struct header) + SLOTS * sizeof (struct entry))
+
+static struct header *header;
+static struct entry *table;
+#ifdef _WIN32
+static HANDLE file = INVALID_HANDLE_VALUE;
+static HANDLE mapping;
+#endif
+
+static uint32_t make_key(int kind, int hash)
+{
+    return (uint32_t)kind << 16 | ((uint32_t)hash & 0xffff);
+}
+
+/* never 0 so that a cleared check never matches */
+static uint32_t entry_check(uint32_t key, uint32_t seen, char const *text)
+{
+    return nhash(text, strnlen(text, CALLSIGN_HASH_TEXT - 1), key ^ seen) | 0x10000;
+}
+
+static int valid(struct entry const *e)
+{
+    return e->check == entry_check(e->key, e->seen, e->text);
+}
+
+static void *map_file(char const *fname)
+{
+    void *p;
+#ifdef _WIN32
+    file = CreateFileA(fname, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                       NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (INVALID_HANDLE_VALUE == file) return NULL;
+    /* grows a short file to FILE_SIZE with zeros */
+    mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, 0, (DWORD)FILE_SIZE, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+        return NULL;
+    }
+    p = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, FILE_SIZE);
+    if (!p) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+    }
+#else
+    struct stat st;
+    int fd = open(fname, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return NULL;
+    if (fstat(fd, &st) || ((size_t)st.st_size < FILE_SIZE && ftruncate(fd, FILE_SIZE))) {
+        close(fd);
+        return NULL;
+    }
+    p = mmap(NULL, FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);                  /* the mapping stays */
+    if (MAP_FAILED == p) p = NULL;
+#endif
+    return p;
+}
+
+int callsign_hash_open(char const *data_dir)
+{
+    char fname[600];
+    void *p;
+    if (header) return 0;
+    snprintf(fname, sizeof fname, "%s/callsign_hash.dat", data_dir);
+    if (!(p = map_file(fname))) return -1;
+    header = p;
+    table = (struct entry *)(header + 1);
+    if (!memcmp(header->magic, MAGIC, sizeof header->magic)
+        && SLOTS == header->slots && sizeof (struct entry) == header->entry_size) {
+        return 0;
+    }
+    /* new, or written by an incompatible version */
+    memset(table, 0, SLOTS * sizeof (struct entry));
+    header->slots = SLOTS;
+    header->entry_size = sizeof (struct entry);
+    memcpy(header->magic, MAGIC, sizeof header->magic);
+    return 1;
+}
+
+void callsign_hash_close(void)
+{
+    if (!header) return;
+#ifdef _WIN32
+    UnmapViewOfFile(header);
+    CloseHandle(mapping);
+    CloseHandle(file);
+    file = INVALID_HANDLE_VALUE;
+#else
+    munmap(header, FILE_SIZE);
+#endif
+    header = NULL;
+    table = NULL;
+}
+
+/* the entry for key, or for a put the slot to use for it */
+static struct entry *find(uint32_t key, int for_put)
+{
+    uint32_t home = (key * 2654435761u) >> (32 - SLOT_BITS);
+    struct entry *oldest = NULL;
+    int i;
+    for (i = 0; i < PROBES; ++i) {
+        struct entry *e = &table[(home + i) & (SLOTS - 1)];
+        if (key == e->key) return e;
+        if (!e->key) return for_put ? e : NULL;
+        if (!oldest || e->seen < oldest->seen) oldest = e;
+    }
+    return for_put ? oldest : NULL;
+}
+
+void callsign_hash_put(int kind, int hash, char const *text)
+{
+    uint32_t key = make_key(kind, hash);
+    uint32_t now = (uint32_t)time(NULL);
+    struct entry *e;
+    if (!table || !*text) return;
+    e = find(key, 1);
+    e->check = 0;
+    if (key != e->key || strncmp(e->text, text, CALLSIGN_HASH_TEXT - 1)) {
+        memset(e->text, 0, sizeof e->text);
+        strncpy(e->text, text, CALLSIGN_HASH_TEXT - 1);
+        e->key = key;
+    }
+    e->seen = now;
+    e->check = entry_check(key, now, e->text);
+}
+
+int callsign_hash_get(int kind, int hash, int max_age, char *text)
+{
+    struct entry e;
+    struct entry const *p;
+    if (!table || !(p = find(make_key(kind, hash), 0))) return 0;
+    e = *p;                     /* another process may be writing it */
+    e.text[CALLSIGN_HASH_TEXT - 1] = '\0';
+    if (!valid(&e)) return 0;
+    if (max_age > 0 && (uint32_t)time(NULL) - e.seen > (uint32_t)max_age) return 0;
+    memcpy(text, e.text, CALLSIGN_HASH_TEXT);
+    return 1;
+}
+
+void callsign_hash_add_call(char const *call)
+{
+    size_t n = strlen(call);
+    size_t i;
+    if (!table || n < 3 || n > 12) return;
+    for (i = 0; i < n; ++i) {
+        if (!isalnum((unsigned char)call[i]) && '/' != call[i]) return;
+    }
+    /* as wsprd unpk_() and the WSPR encoder hash it */
+    callsign_hash_put(CALLSIGN_HASH_WSPR, nhash(call, n, 146), call);
+}
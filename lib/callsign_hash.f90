@@ -0,0 +1,81 @@
+module callsign_hash
+
+! Interfaces to the persistent callsign hash table in callsign_hash.c,
+! see callsign_hash.h.  update_recent_calls() saves every callsign the
+! decoders copy, the MSK144 short message decoder also looks up call
+! pairs no longer in its list of recent calls.
+
+  private
+  public open_callsign_hash,save_call,save_hash,lookup_hash
+
+  integer, parameter, public :: HASH_WSPR=1,HASH_MSK40=2
+
+  interface
+     function callsign_hash_open(data_dir) bind(C, name='callsign_hash_open')
+       use, intrinsic :: iso_c_binding, only: c_int, c_char
+       integer(c_int) :: callsign_hash_open
+       character(kind=c_char), dimension(*), intent(in) :: data_dir
+     end function callsign_hash_open
+
+     subroutine callsign_hash_put(kind,hash,text) bind(C, name='callsign_hash_put')
+       use, intrinsic :: iso_c_binding, only: c_int, c_char
+       integer(c_int), value :: kind,hash
+       character(kind=c_char), dimension(*), intent(in) :: text
+     end subroutine callsign_hash_put
+
+     function callsign_hash_get(kind,hash,max_age,text)                     &
+          bind(C, name='callsign_hash_get')
+       use, intrinsic :: iso_c_binding, only: c_int, c_char
+       integer(c_int) :: callsign_hash_get
+       integer(c_int), value :: kind,hash,max_age
+       character(kind=c_char), dimension(*) :: text
+     end function callsign_hash_get
+
+     subroutine callsign_hash_add_call(call) bind(C, name='callsign_hash_add_call')
+       use, intrinsic :: iso_c_binding, only: c_char
+       character(kind=c_char), dimension(*), intent(in) :: call
+     end subroutine callsign_hash_add_call
+  end interface
+
+contains
+
+! Until this is called the others do nothing.  Failure is reported on
+! stderr as wsjtx reads every line jt9 writes to stdout as a decode.
+  subroutine open_callsign_hash(data_dir)
+    use, intrinsic :: iso_c_binding, only: c_null_char
+    character*(*), intent(in) :: data_dir
+    if(callsign_hash_open(trim(data_dir)//c_null_char).lt.0)                &
+         write(0,*) 'Cannot open ',trim(data_dir)//'/callsign_hash.dat'
+  end subroutine open_callsign_hash
+
+  subroutine save_call(call)
+    use, intrinsic :: iso_c_binding, only: c_null_char
+    character*(*), intent(in) :: call
+    if(call(1:1).eq.'<' .or. call.eq.' ') return
+    call callsign_hash_add_call(trim(call)//c_null_char)
+  end subroutine save_call
+
+  subroutine save_hash(kind,ihash,text)
+    use, intrinsic :: iso_c_binding, only: c_null_char
+    integer, intent(in) :: kind,ihash
+    character*(*), intent(in) :: text
+    call callsign_hash_put(kind,ihash,trim(text)//c_null_char)
+  end subroutine save_hash
+
+! True with text set if ihash was seen within max_age seconds
+  logical function lookup_hash(kind,ihash,max_age,text)
+    use, intrinsic :: iso_c_binding, only: c_char, c_null_char
+    integer, intent(in) :: kind,ihash,max_age
+    character*(*), intent(out) :: text
+    character(kind=c_char) :: ctext(24)
+    integer i
+    text=' '
+    lookup_hash=callsign_hash_get(kind,ihash,max_age,ctext).ne.0
+    if(.not.lookup_hash) return
+    do i=1,min(len(text),size(ctext))
+       if(ctext(i).eq.c_null_char) exit
+       text(i:i)=ctext(i)
+    enddo
+  end function lookup_hash
+
+end module callsign_hash
@@ -0,0 +1,59 @@
+/*
+ callsign_hash - persistent table of the callsigns behind hash codes
+
+ Hashed and compound callsigns are sent as a few bits of hash that
+ only resolve to a callsign if it has been copied in full before.
+ This table keeps what has been copied in a memory mapped file,
+
+   <data_dir>/callsign_hash.dat
+
+ shared by jt9, wsprd and the wsjtx process itself, where the MSK144
+ real time decoder mskrtd() runs, so that a callsign copied in any
+ mode resolves the hashes of every mode and survives restarts.
+ Entries are keyed by the kind and value of the hash and found by
+ open addressing in a fixed number of probes, when the probes are
+ all in use the least recently seen entry is replaced.
+
+ Those processes may write the table at the same time and do not lock
+ it, each entry carries a check so that one half written by another
+ process is not returned.
+
+ License: GNU GPL v3
+ */
+
+#ifndef CALLSIGN_HASH_H
+#define CALLSIGN_HASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum callsign_hash_kind {
+    CALLSIGN_HASH_WSPR = 1,     /* nhash(call,146) of a callsign, 15 bits,
+                                   WSPR type 3 messages */
+    CALLSIGN_HASH_MSK40 = 2     /* hash() of "CALL1 CALL2", 12 bits,
+                                   MSK144 short messages */
+};
+
+#define CALLSIGN_HASH_TEXT 24   /* text buffer size including the NUL */
+
+/* Map the table, creating it if need be.  Returns 1 if it was created
+   empty, 0 if it was already there or already open and -1 on error,
+   in which case the other functions do nothing. */
+int callsign_hash_open(char const *data_dir);
+void callsign_hash_close(void);
+
+/* Remember text for a hash and look it up, a lookup only succeeds if
+   the entry was seen within max_age seconds or max_age is zero.
+   callsign_hash_get() returns 1 and fills text on success. */
+void callsign_hash_put(int kind, int hash, char const *text);
+int callsign_hash_get(int kind, int hash, int max_age, char *text);
+
+/* Remember a copied callsign under the hashes it can be sent as */
+void callsign_hash_add_call(char const *call);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,61 @@
+module decode_budget
+
+! Wall clock budget for a decoding pass.  wsjtx sets params%nbudget to
+! the milliseconds available before the next period's decode is due,
+! zero means no limit as for decodes at fQSO and of saved data.  The
+! decoders ask within_budget() before optional work and do without
+! it when the time left is short, the stages left out are reported in
+! results%nskipped.
+
+  implicit none
+  private
+  public start_budget,time_left,within_budget,skipped_stages
+
+  integer, parameter, public ::                                       &
+       SKIP_OSD=1,          & !FT8 ordered statistics decoding
+       SKIP_AP=2,           & !FT8 a priori decoding passes
+       SKIP_PASSES=4,       & !Further passes after subtraction
+       SKIP_TRIALS=8,       & !Fewer JT65 erasure trials, shorter JT9 Fano
+       SKIP_CANDIDATES=16     !Weak candidates away from the QSO untried
+
+  integer(kind=8) :: start=0,rate=1
+  real :: budget=0.
+  integer :: nskipped=0
+
+contains
+
+  subroutine start_budget(nbudget)
+    integer, intent(in) :: nbudget                !ms, zero for no limit
+    call system_clock(start,rate)
+    budget=0.001*max(0,nbudget)
+    nskipped=0
+  end subroutine start_budget
+
+! Seconds until the deadline, huge() when there is none
+  real function time_left()
+    integer(kind=8) :: now
+    if(budget.le.0.) then
+       time_left=huge(time_left)
+       return
+    endif
+    call system_clock(now)
+    time_left=budget - real(now-start)/real(rate)
+  end function time_left
+
+! True if needed seconds are left, otherwise nstage is recorded as
+! skipped.  May be called from the parallel JT65 and JT9 decoders.
+  logical function within_budget(needed,nstage)
+    real, intent(in) :: needed
+    integer, intent(in) :: nstage
+    within_budget=time_left().gt.needed
+    if(.not.within_budget) then
+       !$omp atomic
+       nskipped=ior(nskipped,nstage)
+    endif
+  end function within_budget
+
+  integer function skipped_stages()
+    skipped_stages=nskipped
+  end function skipped_stages
+
+end module decode_budget
@@ -1,4 +1,4 @@
-subroutine multimode_decoder(ss,id2,params,nfsample)
+subroutine multimode_decoder(ss,id2,params,nfsample,sred,results)
 
   !$ use omp_lib
   use prog_args
@@ -7,6 +7,9 @@ subroutine multimode_decoder(ss,id2,params,nfsample)
   use jt65_decode
   use jt9_decode
   use ft8_decode
+  use decoder_results, only: attach_results,detach_results,clear_decodes,   &
+       add_decode,clear_average,add_average,save_red,begin_pass,end_pass
+  use decode_budget, only: start_budget,skipped_stages
 
   include 'jt9com.f90'
   include 'timer_common.inc'
@@ -31,6 +34,8 @@ subroutine multimode_decoder(ss,id2,params,nfsample)
   logical baddata,newdat65,newdat9,single_decode,bVHF,bad0,newdat
   integer*2 id2(NTMAX*12000)
   type(params_block) :: params
+  real(c_float), target :: sred(5760)
+  type(results_block), target :: results
   real*4 dd(NTMAX*12000)
   save
   type(counting_jt4_decoder) :: my_jt4
@@ -50,21 +55,12 @@ subroutine multimode_decoder(ss,id2,params,nfsample)
   if(mod(params%nranera,2).eq.1) ntrials=3*10**(params%nranera/2)
   if(params%nranera.eq.0) ntrials=0
   
-  nfail=0
-10 if (params%nagain) then
-     open(13,file=trim(temp_dir)//'/decoded.txt',status='unknown',            &
-          position='append',iostat=ios)
-  else
-     open(13,file=trim(temp_dir)//'/decoded.txt',status='unknown',            &
-          iostat=ios)
-  end if
-  if(ios.ne.0) then
-     nfail=nfail+1
-     if(nfail.le.3) then
-        call sleep_msec(10)
-        go to 10
-     endif
-  endif
+! Results go to the shared memory region, decoding again at fQSO adds
+! to this period's decodes
+  call attach_results(sred,results)
+  if(.not.params%nagain) call clear_decodes()
+  call begin_pass()
+  call start_budget(params%nbudget)
 
   if(params%nmode.eq.8) then
 ! We're in FT8 mode
@@ -105,10 +101,9 @@ subroutine multimode_decoder(ss,id2,params,nfsample)
 !     id2(1:nz)=0                ! temporarily disabled as it can breaak the JT9 decoder, maybe others
   endif
   
-  if(params%nmode.eq.4 .or. params%nmode.eq.65) open(14,file=trim(temp_dir)// &
-       '/avemsg.txt',status='unknown')
-  if(params%nmode.eq.164) open(17,file=trim(temp_dir)//'/red.dat',          &
-       status='unknown')
+  if(params%nmode.eq.4 .or. params%nmode.eq.65 .or. params%nmode.eq.164) &
+       call clear_average()
+  if(params%nmode.eq.164) call save_red(0.0,0.0,sred,0)
 
   if(params%nmode.eq.4) then
      jz=52*nfsample
@@ -194,11 +189,12 @@ subroutine multimode_decoder(ss,id2,params,nfsample)
 
 ! JT65 is not yet producing info for nsynced, ndecoded.
 800 ndecoded = my_jt4%decoded + my_jt65%decoded + my_jt9%decoded + my_ft8%decoded
+  results%nskipped=skipped_stages()
+  call end_pass(params%nutc,params%nmode)         !Before wsjtx is told
   write(*,1010) nsynced,ndecoded
 1010 format('<DecodeFinished>',2i4)
   call flush(6)
-  close(13) 
-  if(params%nmode.eq.4 .or. params%nmode.eq.65) close(14)
+  call detach_results()
 
   return
 
@@ -260,13 +256,15 @@ contains
     integer, intent(in) :: freq
     logical, intent(in) :: flip
     character(len=1) :: cused, csync
+    character(len=40) :: line
 
     cused = '.'
     csync = '*'
     if (used) cused = '$'
     if (flip) csync = '$'
-    write(14,1000) cused,utc,sync,dt,freq,csync
+    write(line,1000) cused,utc,sync,dt,freq,csync
 1000 format(a1,i5.4,f6.1,f6.2,i6,1x,a1)
+    call add_average(line)
   end subroutine jt4_average
 
   subroutine jt65_decoded(this,sync,snr,dt,freq,drift,nflip,width,     &
@@ -292,7 +290,7 @@ contains
 
     integer i,nft
     logical is_deep,is_average
-    character decoded*22,csync*2,cflags*3
+    character decoded*22,csync*2,cflags*3,line*80
 
     if(width.eq.-9999.0) stop              !Silence compiler warning
 !$omp critical(decode_results)
@@ -310,9 +308,10 @@ contains
           write(*,1009) params%nutc,snr,dt,freq,csync,decoded,nft
 1009      format(i4.4,i4,f5.1,i5,1x,a2,1x,a22,i2)
        endif
-       write(13,1011) params%nutc,nint(sync),snr,dt,float(freq),drift,    &
+       write(line,1011) params%nutc,nint(sync),snr,dt,float(freq),drift,  &
             decoded,nft
 1011   format(i4.4,i4,i5,f6.2,f8.0,i4,3x,a22,' QRA64',i3)
+       call add_decode(line)
        go to 100
     endif
     
@@ -352,9 +351,10 @@ contains
        write(*,1010) params%nutc,snr,dt,freq,csync,decoded,cflags
 1010   format(i4.4,i4,f5.1,i5,1x,a2,1x,a22,1x,a3)
     endif
-    write(13,1012) params%nutc,nint(sync),snr,dt,float(freq),drift,    &
+    write(line,1012) params%nutc,nint(sync),snr,dt,float(freq),drift,  &
          decoded,ft,nsum,nsmo
 1012 format(i4.4,i4,i5,f6.2,f8.0,i4,3x,a22,' JT65',3i3)
+    call add_decode(line)
 
 100 call flush(6)
 
@@ -376,12 +376,14 @@ contains
     real, intent(in) :: freq
     integer, intent(in) :: drift
     character(len=22), intent(in) :: decoded
+    character(len=80) :: line
 
     !$omp critical(decode_results)
     write(*,1000) params%nutc,snr,dt,nint(freq),decoded
 1000 format(i4.4,i4,f5.1,i5,1x,'@ ',1x,a22)
-    write(13,1002) params%nutc,nint(sync),snr,dt,freq,drift,decoded
+    write(line,1002) params%nutc,nint(sync),snr,dt,freq,drift,decoded
 1002 format(i4.4,i4,i5,f6.1,f8.0,i4,3x,a22,' JT9')
+    call add_decode(line)
     call flush(6)
     !$omp end critical(decode_results)
     select type(this)
@@ -404,6 +406,7 @@ contains
     real, intent(in) :: qual 
     character*2 annot
     character*22 decoded0
+    character*80 line
   
     decoded0=decoded 
     annot='  ' 
@@ -413,10 +416,10 @@ contains
     endif
     write(*,1000) params%nutc,snr,dt,nint(freq),decoded0,annot
 1000 format(i6.6,i4,f5.1,i5,' ~ ',1x,a22,1x,a2)
-    write(13,1002) params%nutc,nint(sync),snr,dt,freq,0,decoded0
+    write(line,1002) params%nutc,nint(sync),snr,dt,freq,0,decoded0
 1002 format(i6.6,i4,i5,f6.1,f8.0,i4,3x,a22,' FT8')
+    call add_decode(line)
     call flush(6)
-    call flush(13)
     
     select type(this)
     type is (counting_ft8_decoder)
@@ -0,0 +1,377 @@
+/*
+ decoder_profile - see decoder_profile.h
+
+ The timer() callback keeps a stack of open stages per OpenMP thread,
+ closing a stage that was opened during the pass adds its time to the
+ pass's total for that name and thread.  Stack depth counts from the
+ outermost timer on each thread, so with jt9 -s "decoder" is depth 1
+ and decft8 depth 2, whereas jt65a and decjt9 in the parallel
+ sections of multimode_decoder() are depth 1 or 2 depending on which
+ thread runs them.
+
+ Trace event timestamps are microseconds since the epoch so passes
+ from separate runs line up, the closing ] of the JSON array is
+ optional in the Chrome trace format and is never written so that
+ passes can simply be appended.
+
+ License: GNU GPL v3
+ */
+
+#include "decoder_profile.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define NAME 8                  /* timer() names are character*8 */
+#define MAX_NESTING 32
+#define MAX_STAGES 64           /* distinct name and thread pairs per pass */
+#define MAX_EVENTS 65536        /* trace events per pass */
+#define HISTORY 40              /* passes in decoder_metrics.json */
+#define TRACE_LIMIT (64L * 1024 * 1024)
+
+/* timer_impl.f90, both arguments are passed by reference */
+void c_init_timer(void * const *context, void (* const *callback)(void));
+
+struct open_stage {
+    char name[NAME];
+    double start;               /* us */
+};
+
+struct stage {
+    char name[NAME];
+    int thread;
+    int calls;
+    double seconds;
+};
+
+struct event {
+    char name[NAME];
+    int thread;
+    char phase;                 /* 'B' or 'E' */
+    double ts;                  /* us */
+};
+
+struct pass {
+    long long start_ms;
+    int nutc;
+    int nmode;
+    int ncandidates;
+    int ndecodes;
+    int nskipped;               /* decode_budget.f90 stages */
+    int dropped;                /* events over MAX_EVENTS or from threads
+                                   started after the profiler */
+    double elapsed;             /* s */
+    int nstages;
+    struct stage stages[MAX_STAGES];
+};
+
+static int started;
+static int in_pass;
+static int max_depth;
+static char trace_fname[600];
+static char trace_old_fname[600];
+static char metrics_fname[600];
+static char metrics_tmp_fname[600];
+
+static double pass_start;
+static int nthreads;            /* OpenMP threads when profiling started */
+static struct open_stage (*nesting)[MAX_NESTING];
+static int *level;
+static struct event *events;
+static int nevents;
+static struct pass history[HISTORY];
+static int nhistory;
+static int next_history;        /* also the pass in progress */
+
+#ifdef _OPENMP
+static omp_lock_t lock;
+#endif
+
+static void lock_profile(void)
+{
+#ifdef _OPENMP
+    omp_set_lock(&lock);
+#endif
+}
+
+static void unlock_profile(void)
+{
+#ifdef _OPENMP
+    omp_unset_lock(&lock);
+#endif
+}
+
+static double now_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1e6 + tv.tv_usec;
+}
+
+/* -1 for a thread beyond those there were stacks for */
+static int thread_id(void)
+{
+#ifdef _OPENMP
+    int tid = omp_get_thread_num();
+    return tid < nthreads ? tid : -1;
+#else
+    return 0;
+#endif
+}
+
+/* length of a blank padded name */
+static int name_length(char const *name)
+{
+    int n = NAME;
+    while (n > 0 && ' ' == name[n - 1]) --n;
+    return n;
+}
+
+static char const *mode_name(int nmode)
+{
+    switch (nmode) {
+        case 4: return "JT4";
+        case 8: return "FT8";
+        case 9: return "JT9";
+        case 65: return "JT65";
+        case 74: return "JT9+JT65";
+        case 164: return "QRA64";
+    }
+    return "unknown";
+}
+
+static void add_event(char const *name, int tid, char phase, double ts)
+{
+    struct pass *p = &history[next_history];
+    if (nevents < MAX_EVENTS) {
+        struct event *e = &events[nevents++];
+        memcpy(e->name, name, NAME);
+        e->thread = tid;
+        e->phase = phase;
+        e->ts = ts;
+    } else {
+        ++p->dropped;
+    }
+}
+
+static void add_stage(char const *name, int tid, double us)
+{
+    struct pass *p = &history[next_history];
+    int i;
+    for (i = 0; i < p->nstages; ++i) {
+        if (tid == p->stages[i].thread && !memcmp(name, p->stages[i].name, NAME)) break;
+    }
+    if (i == p->nstages) {
+        if (MAX_STAGES == p->nstages) return;
+        memcpy(p->stages[i].name, name, NAME);
+        p->stages[i].thread = tid;
+        p->stages[i].calls = 0;
+        p->stages[i].seconds = 0.;
+        ++p->nstages;
+    }
+    ++p->stages[i].calls;
+    p->stages[i].seconds += us / 1e6;
+}
+
+/* timer() replacement, k is 0 to start and 1 to stop a stage, larger
+   values ask for the timer.out summary which does not apply here */
+static void timer_event(void * const *context, char const *dname, int const *k,
+                        size_t dname_len)
+{
+    double now = now_us();
+    int tid = thread_id();
+    (void)context;
+    (void)dname_len;
+    if (*k > 1) return;
+    lock_profile();
+    if (tid < 0) {
+        if (in_pass) ++history[next_history].dropped;
+    } else if (0 == *k) {
+        if (level[tid] < MAX_NESTING) {
+            memcpy(nesting[tid][level[tid]].name, dname, NAME);
+            nesting[tid][level[tid]].start = now;
+        }
+        ++level[tid];
+        if (in_pass && level[tid] <= max_depth) add_event(dname, tid, 'B', now);
+    } else if (level[tid] > 0) {
+        int depth = level[tid]--;
+        if (depth <= MAX_NESTING) {
+            struct open_stage const *s = &nesting[tid][depth - 1];
+            /* stages opened before the pass, e.g. "decoder", are not
+               part of it */
+            if (in_pass && s->start >= pass_start) {
+                add_stage(s->name, tid, now - s->start);
+                if (depth <= max_depth) add_event(s->name, tid, 'E', now);
+            }
+        }
+    }
+    unlock_profile();
+}
+
+int decoder_profile_start(char const *data_dir, int depth)
+{
+    void *context = NULL;
+    void (*callback)(void) = (void (*)(void))timer_event;
+    if (!started) {
+#ifdef _OPENMP
+        /* multimode_decoder() asks for two threads whatever the default */
+        nthreads = omp_get_max_threads();
+        if (nthreads < omp_get_num_procs()) nthreads = omp_get_num_procs();
+        if (nthreads < 2) nthreads = 2;
+#else
+        nthreads = 1;
+#endif
+        events = malloc(MAX_EVENTS * sizeof *events);
+        nesting = malloc(nthreads * sizeof *nesting);
+        level = calloc(nthreads, sizeof *level);
+        if (!events || !nesting || !level) {
+            free(events);
+            free(nesting);
+            free(level);
+            return -1;
+        }
+#ifdef _OPENMP
+        omp_init_lock(&lock);
+#endif
+        started = 1;
+    }
+    max_depth = depth;
+    snprintf(trace_fname, sizeof trace_fname, "%s/decoder_trace.json", data_dir);
+    snprintf(trace_old_fname, sizeof trace_old_fname, "%s/decoder_trace.old.json", data_dir);
+    snprintf(metrics_fname, sizeof metrics_fname, "%s/decoder_metrics.json", data_dir);
+    snprintf(metrics_tmp_fname, sizeof metrics_tmp_fname, "%s/decoder_metrics.json.tmp", data_dir);
+    c_init_timer(&context, &callback);
+    return 0;
+}
+
+void decoder_profile_begin(void)
+{
+    struct pass *p = &history[next_history];
+    if (!started) return;
+    lock_profile();
+    memset(p, 0, sizeof *p);
+    pass_start = now_us();
+    p->start_ms = (long long)(pass_start / 1000.);
+    nevents = 0;
+    in_pass = 1;
+    unlock_profile();
+}
+
+static void write_trace(struct pass const *p)
+{
+    FILE *f = fopen(trace_fname, "ab");
+    long size;
+    int i;
+    if (!f) return;
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    if (size > TRACE_LIMIT) {
+        fclose(f);
+        remove(trace_old_fname);
+        rename(trace_fname, trace_old_fname);
+        if (!(f = fopen(trace_fname, "ab"))) return;
+        size = 0;
+    }
+    if (0 == size) fputs("[\n", f);
+    fprintf(f, "{\"name\":\"%s pass\",\"cat\":\"decoder\",\"ph\":\"X\",\"pid\":1,\"tid\":0,"
+            "\"ts\":%.0f,\"dur\":%.0f,\"args\":{\"utc\":%d,\"candidates\":%d,\"decodes\":%d,\"skipped\":%d}},\n",
+            mode_name(p->nmode), pass_start, p->elapsed * 1e6, p->nutc, p->ncandidates,
+            p->ndecodes, p->nskipped);
+    for (i = 0; i < nevents; ++i) {
+        struct event const *e = &events[i];
+        fprintf(f, "{\"name\":\"%.*s\",\"cat\":\"decoder\",\"ph\":\"%c\",\"pid\":1,\"tid\":%d,"
+                "\"ts\":%.0f},\n", name_length(e->name), e->name, e->phase, e->thread, e->ts);
+    }
+    fclose(f);
+}
+
+static void write_metrics(void)
+{
+    FILE *f = fopen(metrics_tmp_fname, "wb");
+    int i, j;
+    if (!f) return;
+    fputs("{\n  \"periods\": [", f);
+    for (i = 0; i < nhistory; ++i) {
+        struct pass const *p = &history[(next_history + HISTORY - nhistory + i) % HISTORY];
+        fprintf(f, "%s\n    {\"start_ms\": %lld, \"utc\": %d, \"mode\": \"%s\", \"elapsed\": %.6f,"
+                " \"candidates\": %d, \"decodes\": %d, \"skipped\": %d, \"dropped_events\": %d,"
+                "\n     \"stages\": [",
+                i ? "," : "", p->start_ms, p->nutc, mode_name(p->nmode), p->elapsed,
+                p->ncandidates, p->ndecodes, p->nskipped, p->dropped);
+        for (j = 0; j < p->nstages; ++j) {
+            struct stage const *s = &p->stages[j];
+            fprintf(f, "%s\n       {\"name\": \"%.*s\", \"thread\": %d, \"calls\": %d, \"seconds\": %.6f}",
+                    j ? "," : "", name_length(s->name), s->name, s->thread, s->calls, s->seconds);
+        }
+        fputs("]}", f);
+    }
+    fputs("\n  ]\n}\n", f);
+    if (fclose(f)) return;
+#ifdef _WIN32
+    remove(metrics_fname);      /* rename() does not replace on Windows */
+#endif
+    rename(metrics_tmp_fname, metrics_fname);
+}
+
+static int by_seconds(void const *a, void const *b)
+{
+    double sa = ((struct stage const *)a)->seconds;
+    double sb = ((struct stage const *)b)->seconds;
+    return (sa < sb) - (sa > sb);
+}
+
+/* stage totals over all threads, busiest first */
+static int summarize(struct pass const *p, char *names, float *seconds, int *calls,
+                     int max_stages)
+{
+    struct stage totals[MAX_STAGES];
+    int n = 0, i, j;
+    for (i = 0; i < p->nstages; ++i) {
+        for (j = 0; j < n && memcmp(totals[j].name, p->stages[i].name, NAME); ++j);
+        if (j == n) {
+            totals[n] = p->stages[i];
+            ++n;
+        } else {
+            totals[j].calls += p->stages[i].calls;
+            totals[j].seconds += p->stages[i].seconds;
+        }
+    }
+    qsort(totals, n, sizeof totals[0], by_seconds);
+    if (n > max_stages) n = max_stages;
+    for (i = 0; i < n; ++i) {
+        memcpy(names + i * NAME, totals[i].name, NAME);
+        seconds[i] = totals[i].seconds;
+        calls[i] = totals[i].calls;
+    }
+    return n;
+}
+
+int decoder_profile_end(int nutc, int nmode, int ncandidates, int ndecodes,
+                        int nskipped, float *elapsed, char *names, float *seconds,
+                        int *calls, int max_stages)
+{
+    struct pass *p = &history[next_history];
+    if (!started) return -1;
+    lock_profile();
+    in_pass = 0;
+    unlock_profile();
+    p->elapsed = (now_us() - pass_start) / 1e6;
+    p->nutc = nutc;
+    p->nmode = nmode;
+    p->ncandidates = ncandidates;
+    p->ndecodes = ndecodes;
+    p->nskipped = nskipped;
+    next_history = (next_history + 1) % HISTORY;
+    if (nhistory < HISTORY) ++nhistory;
+
+    write_trace(p);
+    write_metrics();
+    *elapsed = p->elapsed;
+    return summarize(p, names, seconds, calls, max_stages);
+}
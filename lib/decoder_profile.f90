@@ -0,0 +1,48 @@
+module decoder_profile
+
+! Interfaces to the jt9 -P profiler in decoder_profile.c, see
+! decoder_profile.h.  begin_pass() and end_pass() in decoder_results
+! bracket each call of multimode_decoder().
+
+  private
+  public start_profile,decoder_profile_begin,decoder_profile_end
+
+  interface
+     function decoder_profile_start(data_dir,depth)                         &
+          bind(C, name='decoder_profile_start')
+       use, intrinsic :: iso_c_binding, only: c_int, c_char
+       integer(c_int) :: decoder_profile_start
+       character(kind=c_char), dimension(*), intent(in) :: data_dir
+       integer(c_int), value :: depth
+     end function decoder_profile_start
+
+     subroutine decoder_profile_begin() bind(C, name='decoder_profile_begin')
+     end subroutine decoder_profile_begin
+
+     function decoder_profile_end(nutc,nmode,ncandidates,ndecodes,nskipped, &
+          elapsed,names,seconds,calls,max_stages)                           &
+          bind(C, name='decoder_profile_end')
+       use, intrinsic :: iso_c_binding, only: c_int, c_float, c_char
+       integer(c_int) :: decoder_profile_end
+       integer(c_int), value :: nutc,nmode,ncandidates,ndecodes,nskipped
+       integer(c_int), value :: max_stages
+       real(c_float) :: elapsed
+       character(kind=c_char), dimension(*) :: names
+       real(c_float), dimension(*) :: seconds
+       integer(c_int), dimension(*) :: calls
+     end function decoder_profile_end
+  end interface
+
+contains
+
+! Replaces the timer installed by init_timer(), call it afterwards.
+! Reported on stderr as wsjtx reads every line jt9 writes to stdout as
+! a decode.
+  subroutine start_profile()
+    use, intrinsic :: iso_c_binding, only: c_null_char
+    use prog_args
+    if(decoder_profile_start(trim(data_dir)//c_null_char,profile_depth).ne.0) &
+         write(0,*) 'Cannot start the decoder profiler'
+  end subroutine start_profile
+
+end module decoder_profile
@@ -0,0 +1,49 @@
+/*
+ decoder_profile - per period timing of the jt9 decoders
+
+ Installed as the timer() implementation through C_init_timer() in
+ timer_impl.f90 when jt9 is started with -P.  Every timer('name',0)
+ and timer('name',1) pair between decoder_profile_begin() and
+ decoder_profile_end() is recorded with the OpenMP thread that made
+ it, and at the end of each decoding pass:
+
+   <data_dir>/decoder_trace.json    has the pass appended as Chrome
+                                    trace events (chrome://tracing,
+                                    Perfetto), stages nested deeper
+                                    than the -P depth are left out;
+                                    the file is started afresh as
+                                    decoder_trace.old.json grows past
+                                    TRACE_LIMIT bytes
+
+   <data_dir>/decoder_metrics.json  is rewritten with the stage times,
+                                    calls, candidates and decodes of
+                                    the last HISTORY passes
+
+ License: GNU GPL v3
+ */
+
+#ifndef DECODER_PROFILE_H
+#define DECODER_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Start profiling, replaces the timer installed by init_timer().
+   Returns 0 on success. */
+int decoder_profile_start(char const *data_dir, int depth);
+
+/* Bracket one call of multimode_decoder().  decoder_profile_end()
+   writes the files and returns the number of stages summarized in
+   names (blank padded, 8 characters each), seconds and calls, the
+   busiest first, or -1 when not profiling. */
+void decoder_profile_begin(void);
+int decoder_profile_end(int nutc, int nmode, int ncandidates, int ndecodes,
+                        int nskipped, float *elapsed, char *names, float *seconds,
+                        int *calls, int max_stages);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+module decoder_results
+
+! Decoder output for wsjtx, kept in the results block and sred() of
+! the shared memory region rather than in the decoded.txt, avemsg.txt
+! and red.dat files in the temporary directory.  multimode_decoder()
+! attaches the block for the duration of each decode, elsewhere the
+! routines below do nothing.  begin_pass() and end_pass() also
+! bracket the pass for the jt9 -P profiler, see decoder_profile.h.
+
+  use decoder_profile, only: decoder_profile_begin,decoder_profile_end
+
+  include 'jt9com.f90'
+
+  private
+  public attach_results,detach_results,clear_decodes,add_decode,        &
+       clear_average,add_average,save_red,add_candidates,begin_pass,    &
+       end_pass
+
+  type(results_block), pointer :: results => null()
+  real(c_float), pointer :: sred(:) => null()
+
+contains
+
+  subroutine attach_results(red,res)
+    real(c_float), target :: red(:)
+    type(results_block), target :: res
+    sred => red
+    results => res
+  end subroutine attach_results
+
+  subroutine detach_results()
+    nullify(sred,results)
+  end subroutine detach_results
+
+  subroutine clear_decodes()
+    if(associated(results)) results%ndecodes=0
+  end subroutine clear_decodes
+
+! The line is stored before the count is updated so that wsjtx can
+! read the block while a decode is in progress.
+  subroutine add_decode(line)
+    character(len=*), intent(in) :: line
+    if(.not.associated(results)) return
+    if(results%ndecodes.ge.MAXDECODES) return
+    results%decodes(results%ndecodes+1)=line
+    results%ndecodes=results%ndecodes+1
+  end subroutine add_decode
+
+  subroutine clear_average()
+    if(associated(results)) results%naverage=0
+  end subroutine clear_average
+
+  subroutine add_average(line)
+    character(len=*), intent(in) :: line
+    if(.not.associated(results)) return
+    if(results%naverage.ge.MAXAVERAGE) return
+    results%average(results%naverage+1)=line
+    results%naverage=results%naverage+1
+  end subroutine add_average
+
+! Candidates from the sync stage of each decoder, the JT65 and JT9
+! decoders run in parallel
+  subroutine add_candidates(n)
+    integer, intent(in) :: n
+    if(.not.associated(results)) return
+    !$omp atomic
+    results%ncandidates=results%ncandidates+n
+  end subroutine add_candidates
+
+  subroutine begin_pass()
+    if(.not.associated(results)) return
+    results%ncandidates=0
+    results%nskipped=0
+    results%elapsed=0.
+    results%nstages=0
+    call decoder_profile_begin()
+  end subroutine begin_pass
+
+  subroutine end_pass(nutc,nmode)
+    integer, intent(in) :: nutc,nmode
+    integer nstages
+    if(.not.associated(results)) return
+    nstages=decoder_profile_end(nutc,nmode,results%ncandidates,           &
+         results%ndecodes,results%nskipped,results%elapsed,results%stages,  &
+         results%stage_time,results%stage_calls,MAXSTAGES)
+    results%nstages=max(0,nstages)
+  end subroutine end_pass
+
+! QRA64 sync curve, red(i) is at frequency f0+(i-1)*df Hz
+  subroutine save_red(f0,df,red,n)
+    real, intent(in) :: f0,df
+    integer, intent(in) :: n
+    real, intent(in) :: red(n)
+    integer nred
+    if(.not.associated(results)) return
+    nred=max(0,min(n,size(sred)))
+    results%nred=0
+    sred(1:nred)=red(1:nred)
+    results%fred=f0
+    results%dfred=df
+    results%nred=nred
+  end subroutine save_red
+
+end module decoder_results
@@ -14,9 +14,10 @@ subroutine deep4(sym0,neme,flip,mycall,hiscall,hisgrid,decoded,qual)
   character*180 line
   character*4 rpt(MAXRPT)
   integer ncode(206)
+  integer call3_mtime
   real*4   code(206,2*MAXCALLS + 2 + MAXRPT)
   real pp(2*MAXCALLS + 2 + MAXRPT)
-  data neme0/-99/
+  data neme0/-99/,mtime0/-2/
   data rpt/'-01','-02','-03','-04','-05',          &
            '-06','-07','-08','-09','-10',          &
            '-11','-12','-13','-14','-15',          &
@@ -30,11 +31,13 @@ subroutine deep4(sym0,neme,flip,mycall,hiscall,hisgrid,decoded,qual)
            'R-21','R-22','R-23','R-24','R-25',     &
            'R-26','R-27','R-28','R-29','R-30',     &
            'RO','RRR','73'/
-  save mycall0,hiscall0,hisgrid0,neme0,ntot,code,testmsg
+  save mycall0,hiscall0,hisgrid0,neme0,mtime0,ntot,code,testmsg
 
   sym=sym0
+  mtime=call3_mtime()
   if(mycall.eq.mycall0 .and. hiscall.eq.hiscall0 .and.         &
-       hisgrid.eq.hisgrid0 .and. neme.eq.neme0) go to 30
+       hisgrid.eq.hisgrid0 .and. neme.eq.neme0 .and.            &
+       mtime.eq.mtime0) go to 30
 
   open(23,file=trim(data_dir)//'/CALL3.TXT',status='unknown')
   k=0
@@ -111,6 +114,7 @@ subroutine deep4(sym0,neme,flip,mycall,hiscall,hisgrid,decoded,qual)
   hiscall0=hiscall
   hisgrid0=hisgrid
   neme0=neme
+  mtime0=mtime
 
   sq=0.
   do j=1,206
@@ -20,6 +20,7 @@ subroutine downsam9(id2,npts8,nsps8,newdat,nspsd,fpk,c2)
   real s(5000)
   logical first
   common/patience/npatience,nthreads
+  common/fftwtrained/ntrained
   data first/.true./
   save plan,first,c1,s,x1
 
@@ -40,7 +41,10 @@ subroutine downsam9(id2,npts8,nsps8,newdat,nspsd,fpk,c2)
      call c_f_pointer(plan,x1,[NMAX1])
      x1(0:NMAX1-1) => x1        !remap bounds
      call fftwf_plan_with_nthreads(nthreads)
-     plan=fftwf_plan_dft_r2c_1d(NFFT1,x1,c1,nflags)
+     plan=c_null_ptr
+     if(ntrained.ne.0) plan=fftwf_plan_dft_r2c_1d(NFFT1,x1,c1,             &
+          FFTW_PATIENT+FFTW_WISDOM_ONLY)         !From fftw_train wisdom
+     if(.not.c_associated(plan)) plan=fftwf_plan_dft_r2c_1d(NFFT1,x1,c1,nflags)
      call fftwf_plan_with_nthreads(1)
      !$omp end critical(fftw)
 
@@ -62,3 +62,5 @@
   PARAMETER (FFTW_NO_VRECURSE=65536)
   INTEGER FFTW_NO_SIMD
   PARAMETER (FFTW_NO_SIMD=131072)
+  INTEGER FFTW_WISDOM_ONLY
+  PARAMETER (FFTW_WISDOM_ONLY=2097152)
@@ -0,0 +1,179 @@
+/*
+ fftw_train - plan every FFT used by the decoders at high patience
+ and save the result as FFTW wisdom shared by wsjtx, jt9 and wsprd.
+
+ Usage: fftw_train [-a data_dir] [-w patience] [-m threads]
+
+   -a  directory for fftwf_trained_wisdom.dat, default "."; use the
+       WSJT-X writeable data directory (the jt9 -a path)
+   -w  3 for FFTW_PATIENT (default) or 4 for FFTW_EXHAUSTIVE
+   -m  threads for the large FFTs, as passed to jt9 -m, default 1
+
+ Existing trained wisdom is loaded first, so an interrupted or
+ repeated run only plans what is missing.  Planning the largest
+ transforms at FFTW_EXHAUSTIVE can take hours.
+
+ The shapes below must match the callers: four2a() transforms are
+ in place, the filbig() and downsam9() big r2c transforms and those
+ in wsprd are out of place.  When any process finds the trained
+ wisdom it asks for FFTW_PATIENT plans from wisdom only and falls
+ back to its normal planning for anything not listed here.
+
+ License: GNU GPL v3
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <fftw3.h>
+
+enum shape {C2C, R2C, C2R, C2C_OOP, R2C_OOP};
+
+struct transform {
+    enum shape shape;
+    int n;
+    int sign;           /* C2C only */
+    int threaded;       /* planned with the -m thread count */
+    char const *user;
+};
+
+static struct transform const transforms[] = {
+    /* four2a() in place complex */
+    {C2C,       32, FFTW_FORWARD,  0, "ft8b"},
+    {C2C,      240, FFTW_FORWARD,  0, "msk40spd"},
+    {C2C,      512, FFTW_BACKWARD, 0, "decode65a"},
+    {C2C,      864, FFTW_FORWARD,  0, "msk144spd"},
+    {C2C,     1512, FFTW_BACKWARD, 0, "downsam9"},
+    {C2C,     2048, FFTW_BACKWARD, 0, "sh65"},
+    {C2C,     3200, FFTW_BACKWARD, 0, "ft8_downsample"},
+    {C2C,     3456, FFTW_FORWARD,  0, "spec64"},
+    {C2C,    24192, FFTW_FORWARD,  0, "sync64"},
+    {C2C,   180000, FFTW_FORWARD,  0, "subtractft8"},
+    {C2C,   180000, FFTW_BACKWARD, 0, "subtractft8"},
+    {C2C,   336000, FFTW_BACKWARD, 0, "ana64"},
+    {C2C,   564480, FFTW_FORWARD,  0, "subtract65"},
+    {C2C,   564480, FFTW_BACKWARD, 0, "subtract65"},
+    {C2C,   672000, FFTW_FORWARD,  0, "ana64"},
+    /* four2a() in place real */
+    {R2C,      512, 0, 0, "ccf65, hspec"},
+    {C2R,      512, 0, 0, "ccf65"},
+    {R2C,     1024, 0, 0, "mskdt"},
+    {R2C,     2520, 0, 0, "ps4"},
+    {R2C,     3840, 0, 0, "sync8"},
+    {R2C,     6912, 0, 0, "softsym9w, refspectrum"},
+    {C2R,     6912, 0, 0, "refspectrum"},
+    {R2C,     8192, 0, 0, "symspec65"},
+    {R2C,    16384, 0, 0, "symspec"},
+    {R2C,    32768, 0, 0, "avecho"},
+    {R2C,   192000, 0, 0, "ft8_downsample"},
+    /* filbig() and downsam9() */
+    {R2C_OOP, 672000, 0, 1, "filbig"},
+    {C2C,      77175, FFTW_FORWARD,  0, "filbig"},
+    {C2C,      77175, FFTW_BACKWARD, 0, "filbig"},
+    {R2C_OOP, 653184, 0, 1, "downsam9"},
+    /* wsprd, 2 minute mode */
+    {R2C_OOP, 46080 * 32, 0, 0, "wsprd"},
+    {C2C_OOP, 46080, FFTW_BACKWARD, 0, "wsprd"},
+    {C2C_OOP,   512, FFTW_FORWARD,  0, "wsprd"},
+};
+
+static fftwf_plan plan(struct transform const *t, unsigned flags)
+{
+    /* room for n complex values covers every shape */
+    fftwf_complex *in = fftwf_malloc(sizeof(fftwf_complex) * (t->n + 1));
+    fftwf_complex *out = fftwf_malloc(sizeof(fftwf_complex) * (t->n + 1));
+    fftwf_plan p = NULL;
+    if (in && out) {
+        switch (t->shape) {
+            case C2C:
+                p = fftwf_plan_dft_1d(t->n, in, in, t->sign, flags);
+                break;
+            case R2C:
+                p = fftwf_plan_dft_r2c_1d(t->n, (float *)in, in, flags);
+                break;
+            case C2R:
+                p = fftwf_plan_dft_c2r_1d(t->n, in, (float *)in, flags);
+                break;
+            case C2C_OOP:
+                p = fftwf_plan_dft_1d(t->n, in, out, t->sign, flags);
+                break;
+            case R2C_OOP:
+                p = fftwf_plan_dft_r2c_1d(t->n, (float *)in, out, flags);
+                break;
+        }
+    }
+    fftwf_free(out);
+    fftwf_free(in);
+    return p;
+}
+
+int main(int argc, char *argv[])
+{
+    char const *data_dir = ".";
+    int patience = 3;
+    int nthreads = 1;
+    int c;
+    while ((c = getopt(argc, argv, "a:w:m:")) != -1) {
+        switch (c) {
+            case 'a':
+                data_dir = optarg;
+                break;
+            case 'w':
+                patience = atoi(optarg);
+                break;
+            case 'm':
+                nthreads = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "Usage: fftw_train [-a data_dir] [-w 3|4] [-m threads]\n");
+                return 1;
+        }
+    }
+    if (patience < 3 || patience > 4 || nthreads < 1) {
+        fprintf(stderr, "Patience must be 3 or 4 and threads at least 1\n");
+        return 1;
+    }
+    unsigned flags = 4 == patience ? FFTW_EXHAUSTIVE : FFTW_PATIENT;
+
+    char wisdom_fname[512];
+    snprintf(wisdom_fname, sizeof wisdom_fname, "%s/fftwf_trained_wisdom.dat", data_dir);
+
+    fftwf_init_threads();
+    if (fftwf_import_wisdom_from_filename(wisdom_fname)) {
+        printf("Loaded existing wisdom from %s\n", wisdom_fname);
+    }
+
+    size_t const count = sizeof transforms / sizeof transforms[0];
+    for (size_t i = 0; i < count; ++i) {
+        struct transform const *t = &transforms[i];
+        int threads = t->threaded ? nthreads : 1;
+        static char const * const names[] = {"c2c", "r2c", "c2r", "c2c out of place", "r2c out of place"};
+        printf("%2zu/%zu %-16s %8d %s %-24s", i + 1, count, names[t->shape], t->n,
+               C2C == t->shape || C2C_OOP == t->shape ? (FFTW_FORWARD == t->sign ? "fwd" : "bwd") : "   ",
+               t->user);
+        fflush(stdout);
+        clock_t t0 = clock();
+        for (int n = 1; ; n = threads) {
+            fftwf_plan_with_nthreads(n);
+            fftwf_plan p = plan(t, flags);
+            if (!p) {
+                fprintf(stderr, "\nPlanning failed\n");
+                return 1;
+            }
+            fftwf_destroy_plan(p);
+            if (n == threads) break;
+        }
+        printf(" %8.1f s\n", (double)(clock() - t0) / CLOCKS_PER_SEC);
+
+        /* save as we go, large sizes take a long time */
+        if (!fftwf_export_wisdom_to_filename(wisdom_fname)) {
+            fprintf(stderr, "Cannot write %s\n", wisdom_fname);
+            return 1;
+        }
+    }
+    fftwf_cleanup_threads();
+    printf("Wisdom saved to %s\n", wisdom_fname);
+    return 0;
+}
@@ -27,6 +27,7 @@ subroutine filbig(dd,npts,f0,newdat,c4a,n4,sq0)
        5.89886379,1.59355187,-2.49138308,0.60910773,-0.04248129/
   common/refspec/dfref,ref(NSZ)
   common/patience/npatience,nthreads
+  common/fftwtrained/ntrained
   save first,plan1,plan2,plan3,rfilt,cfilt,df,ca
 
   if(npts.lt.0) go to 900                    !Clean up at end of program
@@ -38,13 +39,18 @@ subroutine filbig(dd,npts,f0,newdat,c4a,n4,sq0)
      if(npatience.eq.3) nflags=FFTW_PATIENT
      if(npatience.eq.4) nflags=FFTW_EXHAUSTIVE
 
-! Plan the FFTs just once
+! Plan the FFTs just once, from trained wisdom if we can
+     nflags1=nflags
+     if(ntrained.ne.0) nflags1=FFTW_PATIENT+FFTW_WISDOM_ONLY
      !$omp critical(fftw) ! serialize non thread-safe FFTW3 calls
      call fftwf_plan_with_nthreads(nthreads)
-     plan1=fftwf_plan_dft_r2c_1d(nfft1,rca,ca,nflags)
+     plan1=fftwf_plan_dft_r2c_1d(nfft1,rca,ca,nflags1)
+     if(.not.c_associated(plan1)) plan1=fftwf_plan_dft_r2c_1d(nfft1,rca,ca,nflags)
      call fftwf_plan_with_nthreads(1)
-     plan2=fftwf_plan_dft_1d(nfft2,c4a,c4a,-1,nflags)
-     plan3=fftwf_plan_dft_1d(nfft2,cfilt,cfilt,+1,nflags)
+     plan2=fftwf_plan_dft_1d(nfft2,c4a,c4a,-1,nflags1)
+     if(.not.c_associated(plan2)) plan2=fftwf_plan_dft_1d(nfft2,c4a,c4a,-1,nflags)
+     plan3=fftwf_plan_dft_1d(nfft2,cfilt,cfilt,+1,nflags1)
+     if(.not.c_associated(plan3)) plan3=fftwf_plan_dft_1d(nfft2,cfilt,cfilt,+1,nflags)
      !$omp end critical(fftw)
 
 ! Convert impulse response to filter function
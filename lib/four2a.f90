@@ -29,6 +29,7 @@ subroutine four2a(a,nfft,ndim,isign,iform)
   logical found_plan
   data nplan/0/                          !Number of stored plans
   common/patience/npatience,nthreads     !Patience and threads for FFTW plans
+  common/fftwtrained/ntrained            !Nonzero if fftw_train wisdom loaded
   include 'fftw3.f90'                    !FFTW definitions
   save plan,nplan,nn,ns,nf,nl
 
@@ -71,19 +72,11 @@ subroutine four2a(a,nfft,ndim,isign,iform)
         aa(1:jz)=a(1:jz)
      endif
 
-     !$omp critical(fftw) ! serialize non thread-safe FFTW3 calls
-     if(isign.eq.-1 .and. iform.eq.1) then
-        call sfftw_plan_dft_1d(plan(i),nfft,a,a,FFTW_FORWARD,nflags)
-     else if(isign.eq.1 .and. iform.eq.1) then
-        call sfftw_plan_dft_1d(plan(i),nfft,a,a,FFTW_BACKWARD,nflags)
-     else if(isign.eq.-1 .and. iform.eq.0) then
-        call sfftw_plan_dft_r2c_1d(plan(i),nfft,a,a,nflags)
-     else if(isign.eq.1 .and. iform.eq.-1) then
-        call sfftw_plan_dft_c2r_1d(plan(i),nfft,a,a,nflags)
-     else
-        stop 'Unsupported request in four2a'
-     endif
-     !$omp end critical(fftw)
+! Trained wisdom holds patient plans for the sizes we use, take one
+! if it is there, otherwise plan as usual
+     plan(i)=0
+     if(ntrained.ne.0) call make_plan(FFTW_PATIENT+FFTW_WISDOM_ONLY)
+     if(plan(i).eq.0) call make_plan(nflags)
 
      if(nfft.le.NSMALL) then
         jz=nfft
@@ -112,4 +105,23 @@ subroutine four2a(a,nfft,ndim,isign,iform)
   !$omp end critical(four2a)
 
   return
+
+contains
+
+  subroutine make_plan(nflags1)
+    !$omp critical(fftw) ! serialize non thread-safe FFTW3 calls
+    if(isign.eq.-1 .and. iform.eq.1) then
+       call sfftw_plan_dft_1d(plan(i),nfft,a,a,FFTW_FORWARD,nflags1)
+    else if(isign.eq.1 .and. iform.eq.1) then
+       call sfftw_plan_dft_1d(plan(i),nfft,a,a,FFTW_BACKWARD,nflags1)
+    else if(isign.eq.-1 .and. iform.eq.0) then
+       call sfftw_plan_dft_r2c_1d(plan(i),nfft,a,a,nflags1)
+    else if(isign.eq.1 .and. iform.eq.-1) then
+       call sfftw_plan_dft_c2r_1d(plan(i),nfft,a,a,nflags1)
+    else
+       stop 'Unsupported request in four2a'
+    endif
+    !$omp end critical(fftw)
+  end subroutine make_plan
+
 end subroutine four2a
@@ -28,6 +28,9 @@ contains
        mygrid6,hiscall12,hisgrid6)
 !    use wavhdr
     use timer_module, only: timer
+    use decoder_results, only: add_candidates
+    use decode_budget, only: time_left,within_budget,SKIP_OSD,SKIP_AP,     &
+         SKIP_PASSES,SKIP_CANDIDATES
     include 'fsk4hf/ft8_params.f90'
 !    type(hdr) h
 
@@ -38,7 +41,7 @@ contains
     real candidate(3,200)
     real dd(15*12000)
     logical, intent(in) :: lapon,nagain
-    logical newdat,lsubtract,ldupe,bcontest
+    logical newdat,lsubtract,ldupe,bcontest,near,lapon1
     character*12 mycall12, hiscall12
     character*6 mygrid6,hisgrid6
     integer*2 iwave(15*12000)
@@ -71,6 +74,7 @@ contains
 ! ndepth=3: subtraction, 3 passes, bp+osd
     if(ndepth.eq.1) npass=1
     if(ndepth.ge.2) npass=3
+    tpass=0.
     do ipass=1,npass
       newdat=.true.  ! Is this a problem? I hijacked newdat.
       syncmin=1.5
@@ -85,24 +89,57 @@ contains
         if((ndecodes-n2).eq.0) cycle
         lsubtract=.false. 
       endif 
+! Another pass only if there is time for one like the last
+      if(ipass.ge.2) then
+        if(.not.within_budget(tpass,SKIP_PASSES)) exit
+      endif
+      t0=time_left()
+      tcand=0.                       !Mean time of a full depth candidate
+      nfull=0
 
       call timer('sync8   ',0)
       call sync8(dd,ifa,ifb,syncmin,nfqso,s,candidate,ncand,sbase)
       call timer('sync8   ',1)
+      call add_candidates(ncand)
+! Candidates near the Rx and Tx frequencies go first in every pass so
+! that replies to us reach wsjtx before the rest of the band is done
+      call near_first(candidate,ncand,nfqso,nftx,napwid)
       do icand=1,ncand
         sync=candidate(3,icand)
         f1=candidate(1,icand)
         xdt=candidate(2,icand)
         xbase=10.0**(0.1*(sbase(nint(f1/3.125))-40.0))
         nsnr0=min(99,nint(10.0*log10(sync) - 25.5))    !### empirical ###
+! Short of time, OSD and AP are kept for candidates near the Rx and Tx
+! frequencies and once time is up only those are tried
+        ndepth1=ndepth
+        lapon1=lapon
+        near=abs(f1-nfqso).le.napwid .or. abs(f1-nftx).le.napwid
+        if(.not.near) then
+          if(.not.within_budget(0.0,SKIP_CANDIDATES)) cycle
+          nskip=0
+          if(ndepth.eq.3) nskip=SKIP_OSD
+          if(lapon) nskip=nskip+SKIP_AP
+          if(nskip.ne.0) then
+            if(.not.within_budget((ncand-icand+1)*tcand,nskip)) then
+              ndepth1=min(ndepth,2)
+              lapon1=.false.
+            endif
+          endif
+        endif
+        t1=time_left()
         call timer('ft8b    ',0)
-        call ft8b(dd,newdat,nQSOProgress,nfqso,nftx,ndepth,lapon,napwid,    &
+        call ft8b(dd,newdat,nQSOProgress,nfqso,nftx,ndepth1,lapon1,napwid,  &
              lsubtract,nagain,iaptype,mygrid6,bcontest,sync,f1,xdt,xbase,   &
              apsym,nharderrors,dmin,nbadcrc,iappass,iera,message,xsnr)
         nsnr=nint(xsnr) 
         xdt=xdt-0.5
         hd=nharderrors+dmin
         call timer('ft8b    ',1)
+        if(ndepth1.eq.ndepth .and. (lapon1.eqv.lapon)) then
+          nfull=nfull+1
+          tcand=tcand + (t1-time_left()-tcand)/nfull
+        endif
         if(nbadcrc.eq.0) then
 !           call jtmsg(message,iflag)
            if(bcontest) call fix_contest_msg(mygrid6,message)
@@ -132,8 +169,25 @@ contains
 !     iwave=nint(dd)
 !     write(10) h,iwave
 !     close(10)
+      tpass=t0-time_left()
   enddo
   return
   end subroutine decode
 
+! Stable reordering of the sync8 candidates, those within napwid Hz of
+! nfqso or nftx first, each group keeps its sync order
+  subroutine near_first(candidate,ncand,nfqso,nftx,napwid)
+    integer, intent(in) :: ncand,nfqso,nftx,napwid
+    real, intent(inout) :: candidate(3,ncand)
+    logical near(ncand)
+    integer index(ncand)
+    near=abs(candidate(1,:)-nfqso).le.napwid .or.                         &
+         abs(candidate(1,:)-nftx).le.napwid
+    nnear=count(near)
+    if(nnear.eq.0 .or. nnear.eq.ncand) return
+    index=[(i,i=1,ncand)]
+    index=[pack(index,near),pack(index,.not.near)]
+    candidate=candidate(:,index)
+  end subroutine near_first
+
 end module ft8_decode
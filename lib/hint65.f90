@@ -4,20 +4,24 @@ subroutine hint65(s3,mrs,mrs2,nadd,nflip,mycall,hiscall,hisgrid,qual,decoded)
   use prog_args
   parameter (MAXCALLS=10000,MAXRPT=63)
   parameter (MAXMSG=2*MAXCALLS + 2 + MAXRPT)
+  parameter (NBLOCK=256)               !Codewords scored together
   real s3(64,63)
-  integer*1 sym1(0:62,MAXMSG)
-  integer*1 sym2(0:62,MAXMSG)
+  real dref(64,63)
+  real psum(NBLOCK),ref(NBLOCK)
+  integer*1 sym2(MAXMSG,63)            !Codeword symbol by symbol
   integer mrs(63),mrs2(63)
-  integer dgen(12),sym(0:62),sym_rev(0:62)
+  integer dgen(12),sym_rev(0:62)
+  integer call3_mtime
   character*6 mycall,hiscall,hisgrid,call2(MAXCALLS)
+  character*6 mycall0,hiscall0,hisgrid0
   character*4 grid2(MAXCALLS),rpt(MAXRPT)
   character callsign*12,grid*4
   character*180 line
   character ceme*3,msg*22,msg00*22
   character*22 msg0(MAXMSG),decoded
-  logical*1 eme(MAXCALLS)
+  logical*1 eme(MAXCALLS),iscq(MAXMSG)
   logical first
-  data first/.true./
+  data first/.true./,mtime0/-2/
   data rpt/'-01','-02','-03','-04','-05',          &
            '-06','-07','-08','-09','-10',          &
            '-11','-12','-13','-14','-15',          &
@@ -31,9 +35,13 @@ subroutine hint65(s3,mrs,mrs2,nadd,nflip,mycall,hiscall,hisgrid,qual,decoded)
            'R-21','R-22','R-23','R-24','R-25',     &
            'R-26','R-27','R-28','R-29','R-30',     &
            'RO','RRR','73'/
-  save first,sym1,nused,msg0,sym2
+  save first,nused,msg0,sym2,iscq,mycall0,hiscall0,hisgrid0,mtime0
 
-  first=.true.   !### For now, at least: always recompute hypothetical messages
+! The hypothetical messages depend only on mycall, hiscall, hisgrid
+! and CALL3.TXT, so encode them again only when one of those changes.
+  mtime=call3_mtime()
+  if(mycall.ne.mycall0 .or. hiscall.ne.hiscall0 .or.                   &
+       hisgrid.ne.hisgrid0 .or. mtime.ne.mtime0) first=.true.
   if(first) then
      neme=0
      open(23,file=trim(data_dir)//'/CALL3.TXT',status='unknown')
@@ -90,22 +98,29 @@ subroutine hint65(s3,mrs,mrs2,nadd,nflip,mycall,hiscall,hisgrid,qual,decoded)
            call fmtmsg(msg,iz)
            call packmsg(msg,dgen,itype,.false.) !Pack message into 72 bits
            call rs_encode(dgen,sym_rev)            !RS encode
-           sym(0:62)=sym_rev(62:0:-1)
-           sym1(0:62,j)=sym
-
            call interleave63(sym_rev,1)            !Interleave channel symbols
            call graycode(sym_rev,63,1,sym_rev)     !Apply Gray code
-           sym2(0:62,j)=sym_rev(0:62)
+           sym2(j,1:63)=sym_rev(0:62) + 1      !Row of s3 for each symbol
            msg0(j)=msg
+           iscq(j)=msg(1:3).eq.'CQ '
         enddo
      enddo
      nused=j
+     mycall0=mycall
+     hiscall0=hiscall
+     hisgrid0=hisgrid
+     mtime0=mtime
      first=.false.
   endif
 
+! The reference changes wherever a codeword symbol is the most
+! reliable symbol mrs(j); tabulate that change so every codeword is
+! scored with two table lookups per symbol and no branches.
   ref0=0.
+  dref=0.
   do j=1,63
      ref0=ref0 + s3(mrs(j)+1,j)
+     dref(mrs(j)+1,j)=s3(mrs2(j)+1,j) - s3(mrs(j)+1,j)
   enddo
 
   u1=0.
@@ -113,23 +128,32 @@ subroutine hint65(s3,mrs,mrs2,nadd,nflip,mycall,hiscall,hisgrid,qual,decoded)
   u2=u1
 
 ! Find u1 and u2 (best and second-best) codeword from a list, using 
-! a bank of matched filters on the symbol spectra s3(i,j).
+! a bank of matched filters on the symbol spectra s3(i,j).  A block of
+! codewords is scored one symbol at a time, so the s3 and dref columns
+! stay in cache and sym2 is read in order.
   ipk=1
   ipk2=0
   msg00='                      '
-  do k=1,nused
-     if(k.ge.2 .and. k.le.64 .and. nflip.lt.0) cycle
-! Test all messages if nflip=+1; skip the CQ messages if nflip=-1.
-     if(nflip.gt.0 .or. msg0(k)(1:3).ne.'CQ ') then
-        psum=0.
-        ref=ref0
-        do j=1,63
-           i=sym2(j-1,k)+1
-           psum=psum + s3(i,j)
-           if(i.eq.mrs(j)+1) ref=ref - s3(i,j) + s3(mrs2(j)+1,j)
+  do k0=0,nused-1,NBLOCK
+     nb=min(NBLOCK,nused-k0)
+     psum(1:nb)=0.
+     ref(1:nb)=ref0
+     do j=1,63
+        do kk=1,nb
+           i=sym2(k0+kk,j)
+           psum(kk)=psum(kk) + s3(i,j)
+           ref(kk)=ref(kk) + dref(i,j)
         enddo
-        p=psum/ref
+     enddo
+
+     do kk=1,nb
+        k=k0+kk
+        if(k.ge.2 .and. k.le.64 .and. nflip.lt.0) cycle
+! Test all messages if nflip=+1; skip the CQ messages if nflip=-1.
+        if(nflip.le.0 .and. iscq(k)) cycle
+        p=psum(kk)/ref(kk)
 
+! Compare message text only when the score says it matters
         if(p.gt.u1) then
            if(msg0(k).ne.msg00) then
               ipk2=ipk
@@ -138,12 +162,13 @@ subroutine hint65(s3,mrs,mrs2,nadd,nflip,mycall,hiscall,hisgrid,qual,decoded)
            u1=p
            ipk=k
            msg00=msg0(k)
+        else if(p.gt.u2) then
+           if(msg0(k).ne.msg00) then
+              u2=p
+              ipk2=k
+           endif
         endif
-        if(msg0(k).ne.msg00 .and. p.gt.u2) then
-           u2=p
-           ipk2=k
-        endif
-     endif
+     enddo
   enddo
 
 !### Just in case ???
@@ -43,6 +43,9 @@ contains
 
     use jt65_mod
     use timer_module, only: timer
+    use decoder_results, only: add_candidates
+    use decode_budget, only: time_left,within_budget,SKIP_PASSES,          &
+         SKIP_TRIALS,SKIP_CANDIDATES
 
     include 'constants.f90'
 
@@ -119,7 +122,13 @@ contains
        go to 900
     endif
 
+    tpass=0.
     do ipass=1,n2pass                             !Two-pass decoding loop
+! The second pass only if there is time for one like the first
+       if(ipass.ge.2) then
+          if(.not.within_budget(tpass,SKIP_PASSES)) exit
+       endif
+       t0=time_left()
        first_time=.true.
        if(ipass.eq.1) then                        !First-pass parameters
           thresh0=2.5
@@ -195,11 +204,25 @@ contains
           ca(ncand)%dt=2.5
           ca(ncand)%freq=nfqso
        endif
+       call add_candidates(ncand)
+       tcand=0.                          !Mean time of a candidate, all trials
+       nfull=0
 
        do icand=1,ncand
           sync1=ca(icand)%sync
           dtx=ca(icand)%dt
           freq=ca(icand)%freq
+! Short of time, fewer erasure trials for candidates outside the
+! tolerance around fQSO and once time is up only those inside
+          nvec1=nvec
+          if(abs(freq-nfqso).gt.ntol) then
+             if(.not.within_budget(0.0,SKIP_CANDIDATES)) cycle
+             if(nvec.gt.100) then
+                if(.not.within_budget((ncand-icand+1)*tcand,SKIP_TRIALS))   &
+                     nvec1=100
+             endif
+          endif
+          t1=time_left()
           if(bVHF) then
              flip=ca(icand)%flip
              nflip=flip
@@ -210,7 +233,7 @@ contains
           call timer('decod65a',0)
           nft=0
           nspecial=0
-          call decode65a(dd,npts,first_time,nqd,freq,nflip,mode65,nvec,     &
+          call decode65a(dd,npts,first_time,nqd,freq,nflip,mode65,nvec1,    &
                naggressive,ndepth,ntol,mycall,hiscall,hisgrid,              &
                nexp_decode,bVHF,sync2,a,dtx,nft,nspecial,qual,     &
                nhist,nsmo,decoded)
@@ -218,6 +241,10 @@ contains
           if(nspecial.eq.3) decoded='RRR'
           if(nspecial.eq.4) decoded='73'
           call timer('decod65a',1)
+          if(nvec1.eq.nvec) then
+             nfull=nfull+1
+             tcand=tcand + (t1-time_left()-tcand)/nfull
+          endif
           if(sync1.lt.float(minsync) .and.                                  &
                decoded.eq.'                      ') nflip=0
           if(nft.ne.0) nsum=1
@@ -314,6 +341,7 @@ contains
              if(decoded0.eq.'                      ') decoded0='*'
           endif
        enddo                                 !Candidate loop
+       tpass=t0-time_left()
        if(ndecoded.lt.1) exit
     enddo                                    !Two-pass loop
 
@@ -327,10 +355,12 @@ contains
 ! Decodes averaged JT65 data
 
     use jt65_mod
+    use decoder_results, only: add_average
     parameter (MAXAVE=64)
     character*22 avemsg,deepave,deepbest
     character mycall*12,hiscall*12,hisgrid*6
     character*1 csync,cused(64)
+    character*40 line
     logical nagain
     integer iused(64)
 ! Accumulated data for message averaging
@@ -413,8 +443,9 @@ contains
     do i=1,nsave
        csync='*'
        if(nflipsave(i).lt.0.0) csync='#'
-       write(14,1000) cused(i),iutc(i),syncsave(i),dtsave(i)-1.0,nfsave(i),csync
+       write(line,1000) cused(i),iutc(i),syncsave(i),dtsave(i)-1.0,nfsave(i),csync
 1000   format(a1,i5.4,f6.1,f6.2,i6,1x,a1)
+       call add_average(line)
     enddo
     if(nsum.lt.2) go to 900
 
@@ -10,6 +10,8 @@ program jt9
   use timer_module, only: timer
   use timer_impl, only: init_timer, fini_timer
   use readwav
+  use decoder_profile
+  use callsign_hash, only: open_callsign_hash
 
   include 'jt9com.f90'
 
@@ -19,11 +21,12 @@ program jt9
   character c
   character(len=500) optarg, infile
   character wisfile*80
+  character trained_wisfile*520
 !### ndepth was defined as 60001.  Why???
   integer :: arglen,stat,offset,remain,mode=0,flow=200,fsplit=2700,          &
        fhigh=4000,nrxfreq=1500,ntrperiod=1,ndepth=1,nexp_decode=0
   logical :: read_files = .true., tx9 = .false., display_help = .false.
-  type (option) :: long_options(25) = [ &
+  type (option) :: long_options(26) = [ &
     option ('help', .false., 'h', 'Display this help message', ''),          &
     option ('shmem',.true.,'s','Use shared memory for sample data','KEY'),   &
     option ('tr-period', .true., 'p', 'Tx/Rx period, default MINUTES=1',     &
@@ -63,19 +66,41 @@ program jt9
     option ('his-grid', .true., 'g', 'his grid locator', 'GRID'),            &
     option ('experience-decode', .true., 'X',                                &
         'experience based decoding flags (1..n), default FLAGS=0',           &
-        'FLAGS') ]
+        'FLAGS'),                                                            &
+    option ('profile', .true., 'P',                                          &
+        'Profile decoding into the data path, tracing DEPTH levels', 'DEPTH') ]
 
-  type(dec_data), allocatable :: shared_data
+  type(dec_data), allocatable, target :: shared_data
+  integer(c_short), allocatable :: id2a(:)     !Samples of an archived period
+  character(len=500) segment
+  logical :: archive
+  interface
+     function period_archive_count(segment) bind(C, name='period_archive_count')
+       use, intrinsic :: iso_c_binding, only: c_int, c_char
+       integer(c_int) :: period_archive_count
+       character(kind=c_char), dimension(*), intent(in) :: segment
+     end function period_archive_count
+     function period_archive_read_nth(segment,n,samples,max_samples,nutc)   &
+          bind(C, name='period_archive_read_nth')
+       use, intrinsic :: iso_c_binding, only: c_int, c_char, c_short
+       integer(c_int) :: period_archive_read_nth
+       character(kind=c_char), dimension(*), intent(in) :: segment
+       integer(c_int), value :: n, max_samples
+       integer(c_short), dimension(*) :: samples
+       integer(c_int) :: nutc
+     end function period_archive_read_nth
+  end interface
   character(len=12) :: mycall, hiscall
   character(len=6) :: mygrid, hisgrid
   common/patience/npatience,nthreads
+  common/fftwtrained/ntrained
   common/decstats/ntry65a,ntry65b,n65a,n65b,num9,numfano
   data npatience/1/,nthreads/1/
 
   nsubmode = 0
 
   do
-     call getopt('hs:e:a:b:r:m:p:d:f:w:t:9864qTL:S:H:c:G:x:g:X:',      &
+     call getopt('hs:e:a:b:r:m:p:d:f:w:t:9864qTL:S:H:c:G:x:g:X:P:',    &
           long_options,c,optarg,arglen,stat,offset,remain,.true.)
      if (stat .ne. 0) then
         exit
@@ -132,6 +157,8 @@ program jt9
            read (optarg(:arglen), *) hisgrid
         case ('X')
            read (optarg(:arglen), *) nexp_decode
+        case ('P')
+           read (optarg(:arglen), *) profile_depth
      end select
   end do
 
@@ -140,7 +167,8 @@ program jt9
        .or. (read_files .and. remain .lt. 1)) then
 
      print *, 'Usage: jt9 [OPTIONS] file1 [file2 ...]'
-     print *, '       Reads data from *.wav files.'
+     print *, '       Reads data from *.wav files, or from *.wsa period archives'
+     print *, '       where file.wsa decodes every period and file.wsa#N period N.'
      print *, ''
      print *, '       jt9 -s <key> [-w patience] [-m threads] [-e path] [-a path] [-t path]'
      print *, '       Gets data from shared memory region with key==<key>'
@@ -158,7 +186,11 @@ program jt9
 ! Default to 1 thread, but use nthreads for the big ones
   call fftwf_plan_with_nthreads(1)
 
-! Import FFTW wisdom, if available
+! Import FFTW wisdom, if available.  Wisdom from fftw_train is shared
+! with wsjtx and wsprd, when present four2a() etc. ask for patient
+! plans from it before falling back to planning at npatience.
+  trained_wisfile=trim(data_dir)//'/fftwf_trained_wisdom.dat'// C_NULL_CHAR
+  ntrained=fftwf_import_wisdom_from_filename(trained_wisfile)
   wisfile=trim(data_dir)//'/jt9_wisdom.dat'// C_NULL_CHAR
   iret=fftwf_import_wisdom_from_filename(wisfile)
 
@@ -180,124 +212,169 @@ program jt9
   do iarg = offset + 1, offset + remain
      call get_command_argument (iarg, optarg, arglen)
      infile = optarg(:arglen)
-     call wav%read (infile)
-     nfsample=wav%audio_format%sample_rate
-     i1=index(infile,'.wav')
-     if(i1.lt.1) i1=index(infile,'.WAV')
-     if(infile(i1-5:i1-5).eq.'_') then
-        read(infile(i1-4:i1-1),*,err=1) nutc
-     else
-        read(infile(i1-6:i1-1),*,err=1) nutc
-     endif
-     go to 2
-1    nutc=0
-2    nsps=0
-     if(ntrperiod.eq.1)  then
-        nsps=6912
-        shared_data%params%nzhsym=181
-     else if(ntrperiod.eq.2)  then
-        nsps=15360
-        shared_data%params%nzhsym=178
-     else if(ntrperiod.eq.5)  then
-        nsps=40960
-        shared_data%params%nzhsym=172
-     else if(ntrperiod.eq.10) then
-        nsps=82944
-        shared_data%params%nzhsym=171
-     else if(ntrperiod.eq.30) then
-        nsps=252000
-        shared_data%params%nzhsym=167
+! A period archive is file.wsa for every period or file.wsa#N for one
+     archive=index(infile,'.wsa').gt.0
+     irec0=1
+     irec1=1
+     if(archive) then
+        i1=index(infile,'.wsa')
+        segment=infile(:i1+3)
+        irec0=0
+        if(infile(i1+4:i1+4).eq.'#') read(infile(i1+5:),*,err=5) irec0
+5       nrec=period_archive_count(trim(segment)//C_NULL_CHAR)
+        if(nrec.lt.1) then
+           print*,'No periods in archive ',trim(segment)
+           cycle
+        endif
+        if(.not.allocated(id2a)) allocate(id2a(NMAX))
+        if(irec0.ge.1) then
+           irec1=min(irec0,nrec)
+        else
+           irec0=1
+           irec1=nrec
+        endif
      endif
-     if(nsps.eq.0) stop 'Error: bad TRperiod'
 
-     kstep=nsps/2
-     k=0
-     nhsym0=-999
-     npts=(60*ntrperiod-6)*12000
-     if(iarg .eq. offset + 1) then
-        call init_timer (trim(data_dir)//'/timer.out')
-        call timer('jt9     ',0)
-     endif
+     do irec=irec0,irec1
+        if(archive) then
+           nsamp=period_archive_read_nth(trim(segment)//C_NULL_CHAR,irec-1,id2a,  &
+                NMAX,nutc)
+           if(nsamp.lt.0) then
+              print*,'Cannot read period',irec,' of ',trim(segment)
+              cycle
+           endif
+           nfsample=12000
+           if(mode.ne.8 .and. mod(nutc,100).eq.0) nutc=nutc/100
+        else
+           call wav%read (infile)
+           nfsample=wav%audio_format%sample_rate
+           i1=index(infile,'.wav')
+           if(i1.lt.1) i1=index(infile,'.WAV')
+           if(infile(i1-5:i1-5).eq.'_') then
+              read(infile(i1-4:i1-1),*,err=1) nutc
+           else
+              read(infile(i1-6:i1-1),*,err=1) nutc
+           endif
+        endif
+        go to 2
+1       nutc=0
+2       nsps=0
+        if(ntrperiod.eq.1)  then
+           nsps=6912
+           shared_data%params%nzhsym=181
+        else if(ntrperiod.eq.2)  then
+           nsps=15360
+           shared_data%params%nzhsym=178
+        else if(ntrperiod.eq.5)  then
+           nsps=40960
+           shared_data%params%nzhsym=172
+        else if(ntrperiod.eq.10) then
+           nsps=82944
+           shared_data%params%nzhsym=171
+        else if(ntrperiod.eq.30) then
+           nsps=252000
+           shared_data%params%nzhsym=167
+        endif
+        if(nsps.eq.0) stop 'Error: bad TRperiod'
 
-     shared_data%id2=0          !??? Why is this necessary ???
+        kstep=nsps/2
+        k=0
+        nhsym0=-999
+        npts=(60*ntrperiod-6)*12000
+        if(iarg .eq. offset + 1 .and. irec .eq. irec0) then
+           call init_timer (trim(data_dir)//'/timer.out')
+           if(profile_depth.gt.0) call start_profile()
+           call open_callsign_hash(data_dir)
+           call timer('jt9     ',0)
+        endif
 
-     do iblk=1,npts/kstep
-        k=iblk*kstep
-        if(mode.eq.8 .and. k.gt.179712) exit
-        call timer('read_wav',0)
-        read(unit=wav%lun,end=3) shared_data%id2(k-kstep+1:k)
-        go to 4
-3       call timer('read_wav',1)
-        print*,'EOF on input file ',infile
-        exit
-4       call timer('read_wav',1)
-        nhsym=(k-2048)/kstep
-        if(nhsym.ge.1 .and. nhsym.ne.nhsym0) then
-           if(mode.eq.9 .or. mode.eq.74) then
-! Compute rough symbol spectra for the JT9 decoder
-              ingain=0
-              call timer('symspec ',0)
-              nminw=1
-              call symspec(shared_data,k,ntrperiod,nsps,ingain,nminw,pxdb,  &
-                   s,df3,ihsym,npts8,pxdbmax)
-              call timer('symspec ',1)
+        shared_data%id2=0          !??? Why is this necessary ???
+
+        do iblk=1,npts/kstep
+           k=iblk*kstep
+           if(mode.eq.8 .and. k.gt.179712) exit
+           call timer('read_wav',0)
+           if(archive) then
+              if(k.gt.nsamp) go to 3
+              shared_data%id2(k-kstep+1:k)=id2a(k-kstep+1:k)
+           else
+              read(unit=wav%lun,end=3) shared_data%id2(k-kstep+1:k)
            endif
-           nhsym0=nhsym
-           if(nhsym.ge.181) exit
-        endif
-     enddo
-     close(unit=wav%lun)
-     shared_data%params%nutc=nutc
-     shared_data%params%ndiskdat=.true.
-     shared_data%params%ntr=60
-     shared_data%params%nfqso=nrxfreq
-     shared_data%params%newdat=.true.
-     shared_data%params%npts8=74736
-     shared_data%params%nfa=flow
-     shared_data%params%nfsplit=fsplit
-     shared_data%params%nfb=fhigh
-     shared_data%params%ntol=20
-     shared_data%params%kin=64800
-     shared_data%params%nzhsym=181
-     shared_data%params%ndepth=ndepth
-     shared_data%params%lapon=.true.
-     shared_data%params%napwid=75
-     shared_data%params%dttol=3.
+           go to 4
+3          call timer('read_wav',1)
+           print*,'EOF on input file ',infile
+           exit
+4          call timer('read_wav',1)
+           nhsym=(k-2048)/kstep
+           if(nhsym.ge.1 .and. nhsym.ne.nhsym0) then
+              if(mode.eq.9 .or. mode.eq.74) then
+   ! Compute rough symbol spectra for the JT9 decoder
+                 ingain=0
+                 call timer('symspec ',0)
+                 nminw=1
+                 call symspec(shared_data,k,ntrperiod,nsps,ingain,nminw,pxdb,  &
+                      s,df3,ihsym,npts8,pxdbmax)
+                 call timer('symspec ',1)
+              endif
+              nhsym0=nhsym
+              if(nhsym.ge.181) exit
+           endif
+        enddo
+        if(.not.archive) close(unit=wav%lun)
+        shared_data%params%nutc=nutc
+        shared_data%params%ndiskdat=.true.
+        shared_data%params%ntr=60
+        shared_data%params%nfqso=nrxfreq
+        shared_data%params%newdat=.true.
+        shared_data%params%npts8=74736
+        shared_data%params%nfa=flow
+        shared_data%params%nfsplit=fsplit
+        shared_data%params%nfb=fhigh
+        shared_data%params%ntol=20
+        shared_data%params%kin=64800
+        shared_data%params%nzhsym=181
+        shared_data%params%ndepth=ndepth
+        shared_data%params%lapon=.true.
+        shared_data%params%napwid=75
+        shared_data%params%dttol=3.
 
 !     shared_data%params%minsync=0       !### TEST ONLY
 !     shared_data%params%nfqso=1500     !### TEST ONLY
 !     mycall="G3WDG       "              !### TEST ONLY
 !     hiscall="VK7MO       "             !### TEST ONLY
 !     hisgrid="QE37        "             !### TEST ONLY
-     if(mode.eq.164 .and. nsubmode.lt.100) nsubmode=nsubmode+100
+        if(mode.eq.164 .and. nsubmode.lt.100) nsubmode=nsubmode+100
 
-     shared_data%params%naggressive=0
-     shared_data%params%n2pass=2
+        shared_data%params%naggressive=0
+        shared_data%params%n2pass=2
 !     shared_data%params%nranera=8                      !### ntrials=10000
-     shared_data%params%nranera=6                      !### ntrials=3000
-     shared_data%params%nrobust=.false.
-     shared_data%params%nexp_decode=nexp_decode
-     shared_data%params%mycall=mycall
-     shared_data%params%mygrid=mygrid
-     shared_data%params%hiscall=hiscall
-     shared_data%params%hisgrid=hisgrid
-     if (shared_data%params%mycall == '') shared_data%params%mycall='K1ABC'
-     if (shared_data%params%hiscall == '') shared_data%params%hiscall='W9XYZ'
-     if (shared_data%params%hisgrid == '') shared_data%params%hiscall='EN37'
-     if (tx9) then
-        shared_data%params%ntxmode=9
-     else
-        shared_data%params%ntxmode=65
-     end if
-     if (mode.eq.0) then
-        shared_data%params%nmode=65+9
-     else
-        shared_data%params%nmode=mode
-     end if
-     shared_data%params%nsubmode=nsubmode
-     shared_data%params%datetime="2013-Apr-16 15:13" !### Temp
-     if(mode.eq.9 .and. fsplit.ne.2700) shared_data%params%nfa=fsplit
-     call multimode_decoder(shared_data%ss,shared_data%id2,shared_data%params,nfsample)
+        shared_data%params%nranera=6                      !### ntrials=3000
+        shared_data%params%nrobust=.false.
+        shared_data%params%nexp_decode=nexp_decode
+        shared_data%params%nbudget=0                    !No time limit
+        shared_data%params%mycall=mycall
+        shared_data%params%mygrid=mygrid
+        shared_data%params%hiscall=hiscall
+        shared_data%params%hisgrid=hisgrid
+        if (shared_data%params%mycall == '') shared_data%params%mycall='K1ABC'
+        if (shared_data%params%hiscall == '') shared_data%params%hiscall='W9XYZ'
+        if (shared_data%params%hisgrid == '') shared_data%params%hiscall='EN37'
+        if (tx9) then
+           shared_data%params%ntxmode=9
+        else
+           shared_data%params%ntxmode=65
+        end if
+        if (mode.eq.0) then
+           shared_data%params%nmode=65+9
+        else
+           shared_data%params%nmode=mode
+        end if
+        shared_data%params%nsubmode=nsubmode
+        shared_data%params%datetime="2013-Apr-16 15:13" !### Temp
+        if(mode.eq.9 .and. fsplit.ne.2700) shared_data%params%nfa=fsplit
+        call multimode_decoder(shared_data%ss,shared_data%id2,shared_data%params,   &
+             nfsample,shared_data%sred,shared_data%results)
+     enddo
   enddo
 
   call timer('jt9     ',1)
@@ -26,6 +26,9 @@ contains
   subroutine decode(this,callback,ss,id2,nfqso,newdat,npts8,nfa,    &
        nfsplit,nfb,ntol,nzhsym,nagain,ndepth,nmode,nsubmode,nexp_decode)
     use timer_module, only: timer
+    use decoder_results, only: add_candidates
+    use decode_budget, only: time_left,within_budget,SKIP_TRIALS,           &
+         SKIP_CANDIDATES
 
     include 'constants.f90'
     class(jt9_decoder), intent(inout) :: this
@@ -122,24 +125,45 @@ contains
        endif
 
        fgood=0.
+       ntried=0                           !Candidates tried in this pass
+       t0=time_left()
        do i=ia,ib
           if(done(i) .or. (.not.ccfok(i))) cycle
           f=(i-1)*df3
           if(nqd.eq.1 .or.                                                   &
                (ccfred(i).ge.ccflim .and. abs(f-fgood).gt.10.0*df8)) then
 
+! Short of time the wide search uses the shortest Fano limit and
+! stops once time is up, the search around fQSO always completes
+             limit1=limit
+             if(nqd.eq.0) then
+                if(.not.within_budget(0.0,SKIP_CANDIDATES)) exit
+                if(limit.gt.5000 .and. ntried.gt.0) then
+! Candidates still to come by the test above, at the mean time so far
+                   nleft=0
+                   do j=i,ib
+                      if(ccfok(j) .and. .not.done(j) .and. ccfred(j).ge.ccflim &
+                           .and. abs((j-1)*df3-fgood).gt.10.0*df8) nleft=nleft+1
+                   enddo
+                   tcand=(t0-time_left())/ntried
+                   if(.not.within_budget(nleft*tcand,SKIP_TRIALS)) limit1=5000
+                endif
+             endif
+
              call timer('softsym ',0)
              fpk=nf0 + df3*(i-1)
              call softsym(id2,npts8,nsps8,newdat,fpk,syncpk,snrdb,xdt,    &
                   freq,drift,a3,schk,i1SoftSymbols)
              call timer('softsym ',1)
+             call add_candidates(1)
+             ntried=ntried+1
 
              sync=(syncpk+1)/4.0
              if(nqd.eq.1 .and. ((sync.lt.0.5) .or. (schk.lt.1.0))) cycle
              if(nqd.ne.1 .and. ((sync.lt.1.0) .or. (schk.lt.1.5))) cycle
 
              call timer('jt9fano ',0)
-             call jt9fano(i1SoftSymbols,limit,nlim,msg)
+             call jt9fano(i1SoftSymbols,limit1,nlim,msg)
              call timer('jt9fano ',1)
 
              if(sync.lt.0.0 .or. snrdb.lt.dblim-2.0) sync=0.0
@@ -3,6 +3,8 @@ subroutine jt9a()
   use prog_args
   use timer_module, only: timer
   use timer_impl, only: init_timer !, limtrace
+  use decoder_profile
+  use callsign_hash, only: open_callsign_hash
 
   include 'jt9com.f90'
 
@@ -27,6 +29,8 @@ subroutine jt9a()
   i0 = len(trim(shm_key))
 
   call init_timer (trim(data_dir)//'/timer.out')
+  if(profile_depth.gt.0) call start_profile()
+  call open_callsign_hash(data_dir)
 !  open(23,file=trim(data_dir)//'/CALL3.TXT',status='unknown')
 
 !  limtrace=-1                            !Disable all calls to timer()
@@ -61,7 +65,8 @@ subroutine jt9a()
   local_params=shared_data%params !save a copy because wsjtx carries on accessing
   call flush(6)
   call timer('decoder ',0)
-  call multimode_decoder(shared_data%ss,shared_data%id2,local_params,12000)
+  call multimode_decoder(shared_data%ss,shared_data%id2,local_params,12000,  &
+       shared_data%sred,shared_data%results)
   call timer('decoder ',1)
 
 100 inquire(file=trim(temp_dir)//'/.lock',exist=fileExists)
@@ -39,6 +39,7 @@
      integer(c_int) :: naggressive
      logical(c_bool) :: nrobust
      integer(c_int) :: nexp_decode
+     integer(c_int) :: nbudget            !ms for this pass, 0 no limit
      character(kind=c_char, len=20) :: datetime
      character(kind=c_char, len=12) :: mycall
      character(kind=c_char, len=6) :: mygrid
@@ -46,10 +47,30 @@
      character(kind=c_char, len=6) :: hisgrid
   end type params_block
 
+  ! decoder output, see decoder_results.f90
+  integer, parameter :: MAXDECODES=500, MAXAVERAGE=64, MAXSTAGES=16
+  type, bind(C) :: results_block
+     integer(c_int) :: ndecodes
+     character(kind=c_char, len=80) :: decodes(MAXDECODES)
+     integer(c_int) :: naverage
+     character(kind=c_char, len=40) :: average(MAXAVERAGE)
+     integer(c_int) :: nred               !Points of the QRA64 sync curve in sred
+     real(c_float) :: fred                !Frequency of sred(1), Hz
+     real(c_float) :: dfred               !Spacing of sred points, Hz
+     integer(c_int) :: ncandidates        !Sync candidates tried this pass
+     integer(c_int) :: nskipped           !Stages skipped, see decode_budget.f90
+     real(c_float) :: elapsed             !Decoding time, s, with jt9 -P only
+     integer(c_int) :: nstages            !Busiest timer() stages, jt9 -P only
+     character(kind=c_char, len=8) :: stages(MAXSTAGES)
+     real(c_float) :: stage_time(MAXSTAGES)   !s, summed over threads
+     integer(c_int) :: stage_calls(MAXSTAGES)
+  end type results_block
+
   type, bind(C) :: dec_data
      real(c_float) :: ss(184,NSMAX)
      real(c_float) :: savg(NSMAX)
      real(c_float) :: sred(5760)
      integer(c_short) :: id2(NMAX)
      type(params_block) :: params
+     type(results_block) :: results
   end type dec_data
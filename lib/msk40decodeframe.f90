@@ -1,12 +1,15 @@
 subroutine msk40decodeframe(c,mycall,hiscall,xsnr,bswl,nhasharray,             &
                             recent_calls,nrecent,msgreceived,nsuccess)
 !  use timer_module, only: timer
+  use callsign_hash
 
   parameter (NSPM=240)
+  parameter (MAXAGE=3600)            !Oldest saved call pair to try, s
   character*4 rpt(0:15)
   character*6 mycall,hiscall,mycall0,hiscall0
   character*22 hashmsg,msgreceived
   character*12 recent_calls(nrecent)
+  character*12 call1,call2
   complex cb(42)
   complex cfac,cca
   complex c(NSPM)
@@ -19,7 +22,7 @@ subroutine msk40decodeframe(c,mycall,hiscall,xsnr,bswl,nhasharray,             &
   real pp(12)
   real softbits(40)
   real llr(32)
-  logical first
+  logical first,known
   logical*1 bswl
   data first/.true./
   data s8r/1,0,1,1,0,0,0,1/
@@ -157,6 +160,21 @@ subroutine msk40decodeframe(c,mycall,hiscall,xsnr,bswl,nhasharray,             &
           endif
         enddo
       enddo
+      if(nsuccess.eq.0 .and. lookup_hash(HASH_MSK40,nrxhash,MAXAGE,hashmsg)) then
+! A pair copied within the hour, maybe before a restart, only trusted if
+! one of its calls is ours, the DX call or still a recent call since a
+! bare 12 bit hash matches some saved pair all too often
+        i1=index(hashmsg,' ')
+        call1=hashmsg(1:i1-1)
+        call2=hashmsg(i1+1:)
+        known=any(recent_calls.eq.call1) .or. any(recent_calls.eq.call2)
+        if(mycall.ne.' ') known=known .or. call1.eq.mycall .or. call2.eq.mycall
+        if(hiscall.ne.' ') known=known .or. call1.eq.hiscall .or. call2.eq.hiscall
+        if(known) then
+          nsuccess=2
+          write(msgreceived,'(a1,a,a1,1x,a4)') "<",trim(hashmsg),">",rpt(nrxrpt)
+        endif
+      endif
       if(nsuccess.eq.0) then
         nsuccess=3
 !write(*,*) 'decodeframe 4',bswl,nbadsync,nhammd,cord,nrxhash,nrxrpt,ihash,xsnr,sigma,nsuccess
@@ -5,6 +5,8 @@ subroutine mskrtd(id2,nutc0,tsec,ntol,nrxfreq,ndepth,mycall,mygrid,hiscall,   &
 ! Analysis block size = NZ = 7168 samples, t_block = 0.597333 s 
 ! Called from hspec() at half-block increments, about 0.3 s
 
+  use callsign_hash, only: open_callsign_hash
+
   parameter (NZ=7168)                !Block size
   parameter (NSPM=864)               !Number of samples per message frame
   parameter (NFFT1=8192)             !FFT size for making analytic signal
@@ -57,6 +59,7 @@ subroutine mskrtd(id2,nutc0,tsec,ntol,nrxfreq,ndepth,mycall,mygrid,hiscall,   &
        nsnrlast,nsnrlastswl,recent_calls,nhasharray,recent_shmsgs
 
   if(first) then
+     call open_callsign_hash(datadir)
      tsec0=tsec
      nutc00=nutc0
      pnoise=-1.0
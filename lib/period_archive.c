@@ -0,0 +1,580 @@
+/*
+ period_archive - see period_archive.h
+
+ Record layout:
+
+   "WSAR"          magic
+   u32             header bytes that follow, before the payload
+   i64             utc_ms
+   u64             dial_hz
+   char[16]        mode
+   u32             sample_rate
+   u32             nsamples
+   u32             payload bytes
+   u32             payload CRC-32
+   u16             comment bytes
+   char[]          comment, not null terminated
+   payload
+
+ The payload is a sequence of blocks of BLOCK samples, the last may
+ be short.  Each block starts with a 3 bit predictor order 0-4, or
+ VERBATIM followed by the raw samples.  A predicted block has order
+ warm up samples of 16 bits then the residuals in partitions of
+ PARTITION samples, each with a 5 bit Rice parameter.  Residuals are
+ zig-zag mapped and Rice coded, quotients of ESCAPE or more are sent
+ as ESCAPE one bits and the value in 32 bits.  Bits are packed most
+ significant first.
+
+ Index entry layout, 48 bytes:
+
+   i64 utc_ms, u64 dial_hz, char[16] mode, i64 offset,
+   u32 nsamples, u32 sample_rate
+ */
+
+#define _FILE_OFFSET_BITS 64     /* daily segments can pass 2 GiB */
+
+#include "period_archive.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+#define BLOCK 4096
+#define PARTITION 1024
+#define MAX_ORDER 4
+#define VERBATIM 7
+#define ESCAPE 32
+#define HEADER_FIXED 50         /* header bytes after the size field, less comment */
+#define INDEX_ENTRY 48
+
+/* bit packing */
+
+struct bits {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+    unsigned long long acc;
+    int count;                  /* bits in acc */
+};
+
+static int put_bits(struct bits *b, unsigned value, int n)
+{
+    b->acc = (b->acc << n) | (value & (n < 32 ? (1u << n) - 1 : 0xffffffffu));
+    b->count += n;
+    while (b->count >= 8) {
+        if (b->size == b->capacity) {
+            size_t capacity = b->capacity ? 2 * b->capacity : 65536;
+            unsigned char *data = realloc(b->data, capacity);
+            if (!data) return -1;
+            b->data = data;
+            b->capacity = capacity;
+        }
+        b->count -= 8;
+        b->data[b->size++] = (unsigned char)(b->acc >> b->count);
+    }
+    return 0;
+}
+
+static int flush_bits(struct bits *b)
+{
+    return b->count ? put_bits(b, 0, 8 - b->count) : 0;
+}
+
+struct reader {
+    unsigned char const *data;
+    size_t size;
+    size_t pos;
+    unsigned long long acc;
+    int count;
+};
+
+/* returns -1 once past the end of the data */
+static long long get_bits(struct reader *r, int n)
+{
+    while (r->count < n) {
+        if (r->pos == r->size) return -1;
+        r->acc = (r->acc << 8) | r->data[r->pos++];
+        r->count += 8;
+    }
+    r->count -= n;
+    return (long long)((r->acc >> r->count) & ((1ull << n) - 1));
+}
+
+/* prediction, FLAC fixed predictors */
+
+static int residual(short const *x, int i, int order)
+{
+    switch (order) {
+        case 0: return x[i];
+        case 1: return x[i] - x[i-1];
+        case 2: return x[i] - 2*x[i-1] + x[i-2];
+        case 3: return x[i] - 3*x[i-1] + 3*x[i-2] - x[i-3];
+        default: return x[i] - 4*x[i-1] + 6*x[i-2] - 4*x[i-3] + x[i-4];
+    }
+}
+
+static int predict(short const *x, int i, int order)
+{
+    switch (order) {
+        case 0: return 0;
+        case 1: return x[i-1];
+        case 2: return 2*x[i-1] - x[i-2];
+        case 3: return 3*x[i-1] - 3*x[i-2] + x[i-3];
+        default: return 4*x[i-1] - 6*x[i-2] + 4*x[i-3] - x[i-4];
+    }
+}
+
+static unsigned zigzag(int v)
+{
+    return v < 0 ? ((unsigned)(-(v + 1)) << 1) | 1 : (unsigned)v << 1;
+}
+
+static int unzigzag(unsigned u)
+{
+    return u & 1 ? -(int)(u >> 1) - 1 : (int)(u >> 1);
+}
+
+static unsigned long long rice_bits(unsigned const *u, int n, int k)
+{
+    unsigned long long bits = 0;
+    for (int i = 0; i < n; ++i) {
+        unsigned q = u[i] >> k;
+        bits += q < ESCAPE ? q + 1 + k : ESCAPE + 32;
+    }
+    return bits;
+}
+
+static int best_parameter(unsigned const *u, int n)
+{
+    unsigned long long sum = 0;
+    for (int i = 0; i < n; ++i) sum += u[i];
+    int k = 0;
+    while (k < 30 && (unsigned long long)n << (k + 1) <= sum) ++k;
+    /* the estimate is close, check either side of it */
+    int best = k;
+    unsigned long long best_bits = rice_bits(u, n, k);
+    for (int j = k > 0 ? k - 1 : 0; j <= k + 1 && j <= 30; ++j) {
+        unsigned long long bits = rice_bits(u, n, j);
+        if (bits < best_bits) {
+            best_bits = bits;
+            best = j;
+        }
+    }
+    return best;
+}
+
+static int encode_block(struct bits *b, short const *x, int n)
+{
+    unsigned u[BLOCK];
+    int order = 0;
+    unsigned long long best = ~0ull;
+    for (int o = 0; o <= MAX_ORDER && o < n; ++o) {
+        unsigned long long sum = 0;
+        for (int i = o; i < n; ++i) sum += zigzag(residual(x, i, o));
+        if (sum < best) {
+            best = sum;
+            order = o;
+        }
+    }
+
+    int count = n - order;
+    for (int i = 0; i < count; ++i) u[i] = zigzag(residual(x, i + order, order));
+    unsigned long long bits = 16ull * order;
+    int k[BLOCK / PARTITION];
+    for (int p = 0; p * PARTITION < count; ++p) {
+        int m = count - p * PARTITION < PARTITION ? count - p * PARTITION : PARTITION;
+        k[p] = best_parameter(&u[p * PARTITION], m);
+        bits += 5 + rice_bits(&u[p * PARTITION], m, k[p]);
+    }
+
+    if (bits >= 16ull * n) {
+        if (put_bits(b, VERBATIM, 3)) return -1;
+        for (int i = 0; i < n; ++i) {
+            if (put_bits(b, (unsigned short)x[i], 16)) return -1;
+        }
+        return 0;
+    }
+
+    if (put_bits(b, order, 3)) return -1;
+    for (int i = 0; i < order; ++i) {
+        if (put_bits(b, (unsigned short)x[i], 16)) return -1;
+    }
+    for (int p = 0; p * PARTITION < count; ++p) {
+        int m = count - p * PARTITION < PARTITION ? count - p * PARTITION : PARTITION;
+        if (put_bits(b, k[p], 5)) return -1;
+        for (int i = p * PARTITION; i < p * PARTITION + m; ++i) {
+            unsigned q = u[i] >> k[p];
+            if (q < ESCAPE) {
+                /* unary quotient, q ones and a zero */
+                while (q >= 24) {
+                    if (put_bits(b, 0xffffff, 24)) return -1;
+                    q -= 24;
+                }
+                if (put_bits(b, ((1u << q) - 1) << 1, q + 1)) return -1;
+                if (k[p] && put_bits(b, u[i], k[p])) return -1;
+            } else {
+                if (put_bits(b, 0xffffffffu, ESCAPE)) return -1;
+                if (put_bits(b, u[i], 32)) return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int decode_block(struct reader *r, short *x, int n)
+{
+    long long order = get_bits(r, 3);
+    if (order < 0) return -1;
+    if (VERBATIM == order) {
+        for (int i = 0; i < n; ++i) {
+            long long v = get_bits(r, 16);
+            if (v < 0) return -1;
+            x[i] = (short)(unsigned short)v;
+        }
+        return 0;
+    }
+    if (order > MAX_ORDER || order > n) return -1;
+    for (int i = 0; i < order; ++i) {
+        long long v = get_bits(r, 16);
+        if (v < 0) return -1;
+        x[i] = (short)(unsigned short)v;
+    }
+    int count = n - (int)order;
+    for (int p = 0; p * PARTITION < count; ++p) {
+        int m = count - p * PARTITION < PARTITION ? count - p * PARTITION : PARTITION;
+        long long k = get_bits(r, 5);
+        if (k < 0) return -1;
+        for (int i = (int)order + p * PARTITION; i < (int)order + p * PARTITION + m; ++i) {
+            unsigned q = 0;
+            long long bit;
+            while (q < ESCAPE && (bit = get_bits(r, 1)) == 1) ++q;
+            if (q < ESCAPE && bit < 0) return -1;
+            long long u;
+            if (q == ESCAPE) {
+                u = get_bits(r, 32);
+            } else {
+                long long low = k ? get_bits(r, (int)k) : 0;
+                u = low < 0 ? -1 : ((long long)q << k) | low;
+            }
+            if (u < 0) return -1;
+            int v = predict(x, i, (int)order) + unzigzag((unsigned)u);
+            if (v < -32768 || v > 32767) return -1;
+            x[i] = (short)v;
+        }
+    }
+    return 0;
+}
+
+/* integrity */
+
+static unsigned long crc32(unsigned char const *data, size_t n)
+{
+    static unsigned long table[256];
+    if (!table[1]) {
+        for (unsigned long i = 0; i < 256; ++i) {
+            unsigned long c = i;
+            for (int j = 0; j < 8; ++j) c = c & 1 ? 0xedb88320ul ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+    }
+    unsigned long crc = 0xfffffffful;
+    for (size_t i = 0; i < n; ++i) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return crc ^ 0xfffffffful;
+}
+
+/* little endian fields */
+
+static void put_le(unsigned char *p, unsigned long long v, int n)
+{
+    for (int i = 0; i < n; ++i) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static unsigned long long get_le(unsigned char const *p, int n)
+{
+    unsigned long long v = 0;
+    for (int i = n - 1; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+/* 64 bit file offsets, long is 32 bits on Windows */
+
+static int seek_to(FILE *fp, long long offset, int whence)
+{
+#ifdef _WIN32
+    return _fseeki64(fp, offset, whence);
+#else
+    return fseeko(fp, (off_t)offset, whence);
+#endif
+}
+
+static long long tell(FILE *fp)
+{
+#ifdef _WIN32
+    return _ftelli64(fp);
+#else
+    return (long long)ftello(fp);
+#endif
+}
+
+static char *index_name(char const *segment)
+{
+    char *name = malloc(strlen(segment) + 5);
+    if (name) sprintf(name, "%s.idx", segment);
+    return name;
+}
+
+int period_archive_append(char const *segment, struct period_archive_entry *entry,
+                          char const *comment, short const *samples)
+{
+    struct bits b = {0};
+    for (int i = 0; i < entry->nsamples; i += BLOCK) {
+        int n = entry->nsamples - i < BLOCK ? entry->nsamples - i : BLOCK;
+        if (encode_block(&b, &samples[i], n)) {
+            free(b.data);
+            return -1;
+        }
+    }
+    if (flush_bits(&b)) {
+        free(b.data);
+        return -1;
+    }
+
+    size_t comment_size = comment ? strlen(comment) : 0;
+    if (comment_size > 0xffff) comment_size = 0xffff;
+    unsigned char header[8 + HEADER_FIXED];
+    memcpy(header, "WSAR", 4);
+    put_le(&header[4], HEADER_FIXED + comment_size, 4);
+    put_le(&header[8], (unsigned long long)entry->utc_ms, 8);
+    put_le(&header[16], entry->dial_hz, 8);
+    memset(&header[24], 0, PERIOD_ARCHIVE_MODE_SIZE);
+    for (int i = 0; i < PERIOD_ARCHIVE_MODE_SIZE - 1 && entry->mode[i]; ++i) header[24 + i] = entry->mode[i];
+    put_le(&header[40], entry->sample_rate, 4);
+    put_le(&header[44], entry->nsamples, 4);
+    put_le(&header[48], b.size, 4);
+    put_le(&header[52], crc32(b.data, b.size), 4);
+    put_le(&header[56], comment_size, 2);
+
+    int result = -1;
+    FILE *fp = fopen(segment, "ab");
+    if (fp && !seek_to(fp, 0, SEEK_END)) {
+        entry->offset = tell(fp);
+        if (entry->offset >= 0
+            && 1 == fwrite(header, sizeof header, 1, fp)
+            && comment_size == fwrite(comment ? comment : "", 1, comment_size, fp)
+            && b.size == fwrite(b.data, 1, b.size, fp)
+            && !fflush(fp)) {
+            result = 0;
+        }
+    }
+    if (fp && fclose(fp)) result = -1;
+    free(b.data);
+    if (result) return result;
+
+    /* the record is complete, now index it */
+    unsigned char index[INDEX_ENTRY];
+    put_le(&index[0], (unsigned long long)entry->utc_ms, 8);
+    put_le(&index[8], entry->dial_hz, 8);
+    memcpy(&index[16], &header[24], PERIOD_ARCHIVE_MODE_SIZE);
+    put_le(&index[32], (unsigned long long)entry->offset, 8);
+    put_le(&index[40], entry->nsamples, 4);
+    put_le(&index[44], entry->sample_rate, 4);
+    char *name = index_name(segment);
+    fp = name ? fopen(name, "ab") : NULL;
+    free(name);
+    if (!fp) return -1;
+    result = 1 == fwrite(index, sizeof index, 1, fp) ? 0 : -1;
+    if (fclose(fp)) result = -1;
+    return result;
+}
+
+/* read a record header at offset, returns the payload size or -1 */
+static long long read_header(FILE *fp, long long offset, struct period_archive_entry *entry,
+                             char *comment, int comment_size, unsigned long *crc,
+                             long long *payload_offset)
+{
+    unsigned char header[8 + HEADER_FIXED];
+    if (seek_to(fp, offset, SEEK_SET)
+        || 1 != fread(header, sizeof header, 1, fp)
+        || memcmp(header, "WSAR", 4)) {
+        return -1;
+    }
+    unsigned long long header_size = get_le(&header[4], 4);
+    unsigned long long text_size = get_le(&header[56], 2);
+    if (header_size < HEADER_FIXED + text_size) return -1;
+    entry->utc_ms = (long long)get_le(&header[8], 8);
+    entry->dial_hz = get_le(&header[16], 8);
+    memcpy(entry->mode, &header[24], PERIOD_ARCHIVE_MODE_SIZE);
+    entry->mode[PERIOD_ARCHIVE_MODE_SIZE - 1] = '\0';
+    entry->sample_rate = (int)get_le(&header[40], 4);
+    entry->nsamples = (int)get_le(&header[44], 4);
+    entry->offset = offset;
+    *crc = (unsigned long)get_le(&header[52], 4);
+    if (comment && comment_size > 0) {
+        size_t n = text_size < (unsigned long long)comment_size ? (size_t)text_size : (size_t)comment_size - 1;
+        if (n != fread(comment, 1, n, fp)) return -1;
+        comment[n] = '\0';
+    }
+    *payload_offset = offset + 8 + (long long)header_size;
+    return (long long)get_le(&header[48], 4);
+}
+
+int period_archive_index(char const *segment, struct period_archive_entry **entries)
+{
+    *entries = NULL;
+    FILE *fp = fopen(segment, "rb");
+    if (!fp) return -1;
+    seek_to(fp, 0, SEEK_END);
+    long long segment_size = tell(fp);
+
+    int count = 0;
+    int capacity = 0;
+    long long next = 0;         /* offset after the last indexed record */
+    char *name = index_name(segment);
+    FILE *ip = name ? fopen(name, "rb") : NULL;
+    free(name);
+    unsigned char index[INDEX_ENTRY];
+    while (ip && 1 == fread(index, sizeof index, 1, ip)) {
+        struct period_archive_entry e;
+        e.utc_ms = (long long)get_le(&index[0], 8);
+        e.dial_hz = get_le(&index[8], 8);
+        memcpy(e.mode, &index[16], PERIOD_ARCHIVE_MODE_SIZE);
+        e.mode[PERIOD_ARCHIVE_MODE_SIZE - 1] = '\0';
+        e.offset = (long long)get_le(&index[32], 8);
+        e.nsamples = (int)get_le(&index[40], 4);
+        e.sample_rate = (int)get_le(&index[44], 4);
+        if (e.offset < next || e.offset >= segment_size) break;
+        if (count == capacity) {
+            capacity = capacity ? 2 * capacity : 256;
+            struct period_archive_entry *p = realloc(*entries, capacity * sizeof **entries);
+            if (!p) break;
+            *entries = p;
+        }
+        (*entries)[count++] = e;
+        next = e.offset + 1;
+    }
+    if (ip) fclose(ip);
+
+    /* pick up records written after the index was, e.g. after a crash
+       between the two writes */
+    if (count) {
+        struct period_archive_entry e;
+        unsigned long crc;
+        long long payload_offset;
+        long long payload = read_header(fp, (*entries)[count - 1].offset, &e, NULL, 0, &crc, &payload_offset);
+        next = payload < 0 ? segment_size : payload_offset + payload;
+    }
+    while (next < segment_size) {
+        struct period_archive_entry e;
+        unsigned long crc;
+        long long payload_offset;
+        long long payload = read_header(fp, next, &e, NULL, 0, &crc, &payload_offset);
+        if (payload < 0 || payload_offset + payload > segment_size) break;
+        if (count == capacity) {
+            capacity = capacity ? 2 * capacity : 256;
+            struct period_archive_entry *p = realloc(*entries, capacity * sizeof **entries);
+            if (!p) break;
+            *entries = p;
+        }
+        (*entries)[count++] = e;
+        next = payload_offset + payload;
+    }
+    fclose(fp);
+    return count;
+}
+
+int period_archive_read(char const *segment, long long offset,
+                        struct period_archive_entry *entry,
+                        char *comment, int comment_size,
+                        short *samples, int max_samples)
+{
+    FILE *fp = fopen(segment, "rb");
+    if (!fp) return -1;
+    struct period_archive_entry e;
+    unsigned long crc;
+    long long payload_offset;
+    long long payload = read_header(fp, offset, &e, comment, comment_size, &crc, &payload_offset);
+    unsigned char *data = payload >= 0 ? malloc(payload ? (size_t)payload : 1) : NULL;
+    int ok = data && !seek_to(fp, payload_offset, SEEK_SET)
+        && (size_t)payload == fread(data, 1, (size_t)payload, fp)
+        && crc == crc32(data, (size_t)payload);
+    fclose(fp);
+
+    /* decode whole blocks, the last one may need a scratch buffer if
+       the caller wants fewer samples than were saved */
+    int n = 0;
+    short *block = ok ? malloc(BLOCK * sizeof *block) : NULL;
+    if (block) {
+        struct reader r = {data, (size_t)payload, 0, 0, 0};
+        for (int i = 0; i < e.nsamples && n < max_samples; i += BLOCK) {
+            int m = e.nsamples - i < BLOCK ? e.nsamples - i : BLOCK;
+            if (decode_block(&r, block, m)) {
+                ok = 0;
+                break;
+            }
+            int copy = max_samples - n < m ? max_samples - n : m;
+            memcpy(&samples[n], block, copy * sizeof *block);
+            n += copy;
+        }
+        free(block);
+    }
+    free(data);
+    if (!ok) return -1;
+    if (entry) *entry = e;
+    return n;
+}
+
+/* jt9 reads a segment's periods one call at a time, so the index of
+   the last segment asked for is kept until that segment changes size */
+
+static char *cached_segment;
+static long long cached_size = -1;
+static struct period_archive_entry *cached_entries;
+static int cached_count = -1;
+
+static long long segment_size(char const *segment)
+{
+    FILE *fp = fopen(segment, "rb");
+    long long size = -1;
+    if (fp && !seek_to(fp, 0, SEEK_END)) size = tell(fp);
+    if (fp) fclose(fp);
+    return size;
+}
+
+static int cached_index(char const *segment)
+{
+    long long size = segment_size(segment);
+    if (size >= 0 && size == cached_size && cached_segment && !strcmp(segment, cached_segment)) {
+        return cached_count;
+    }
+    free(cached_entries);
+    free(cached_segment);
+    cached_entries = NULL;
+    cached_count = -1;
+    cached_size = size;
+    cached_segment = malloc(strlen(segment) + 1);
+    if (!cached_segment) return -1;
+    strcpy(cached_segment, segment);
+    cached_count = period_archive_index(segment, &cached_entries);
+    return cached_count;
+}
+
+int period_archive_count(char const *segment)
+{
+    return cached_index(segment);
+}
+
+int period_archive_read_nth(char const *segment, int n, short *samples,
+                            int max_samples, int *nutc)
+{
+    int count = cached_index(segment);
+    if (n < 0 || n >= count) return -1;
+    struct period_archive_entry const *e = &cached_entries[n];
+    time_t t = (time_t)(e->utc_ms / 1000);
+    struct tm *tm = gmtime(&t);
+    *nutc = tm ? 10000 * tm->tm_hour + 100 * tm->tm_min + tm->tm_sec : 0;
+    return period_archive_read(segment, e->offset, NULL, NULL, 0, samples, max_samples);
+}
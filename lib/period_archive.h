@@ -0,0 +1,71 @@
+/*
+ period_archive - losslessly compressed, indexed storage of Rx periods
+
+ A segment file holds any number of periods appended one after the
+ other, each a record of a small header followed by the samples
+ compressed with fixed order linear prediction and Rice coding of the
+ residuals, as FLAC does for its fixed subframes.  Receiver noise at
+ normal levels compresses to between a half and two thirds of 16 bit
+ PCM, silence to almost nothing.
+
+ Alongside each segment "name.wsa" an index "name.wsa.idx" holds one
+ fixed size entry per record giving its start time, dial frequency,
+ mode and byte offset.  Both files are only ever appended to; a
+ record missing from the index after a crash is found again by
+ scanning the segment from the last indexed record.
+
+ All multi-byte fields are little endian.
+
+ License: GNU GPL v3
+ */
+
+#ifndef PERIOD_ARCHIVE_H
+#define PERIOD_ARCHIVE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PERIOD_ARCHIVE_MODE_SIZE 16
+
+struct period_archive_entry {
+    long long utc_ms;                   /* period start, ms since the epoch */
+    unsigned long long dial_hz;
+    char mode[PERIOD_ARCHIVE_MODE_SIZE]; /* null terminated */
+    long long offset;                   /* of the record in the segment */
+    int nsamples;
+    int sample_rate;
+};
+
+/* Append a period to a segment and its index, creating them if
+   necessary.  The offset member of entry is set.  Returns 0 on
+   success. */
+int period_archive_append(char const *segment, struct period_archive_entry *entry,
+                          char const *comment, short const *samples);
+
+/* Read the index of a segment into a malloc()ed array owned by the
+   caller, oldest first.  Returns the number of entries or -1 if the
+   segment cannot be read. */
+int period_archive_index(char const *segment, struct period_archive_entry **entries);
+
+/* Read and decompress the record at offset, up to max_samples
+   samples.  entry and comment (null terminated, truncated to
+   comment_size) may be null.  Returns the number of samples read or
+   -1 if the record is missing or corrupt. */
+int period_archive_read(char const *segment, long long offset,
+                        struct period_archive_entry *entry,
+                        char *comment, int comment_size,
+                        short *samples, int max_samples);
+
+/* For jt9: the number of records in a segment or -1, and record n
+   counting from 0 with its start time as hhmmss.  The index of the
+   last segment used is kept until the segment changes size. */
+int period_archive_count(char const *segment);
+int period_archive_read_nth(char const *segment, int n, short *samples,
+                            int max_samples, int *nutc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
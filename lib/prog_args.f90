@@ -1,4 +1,5 @@
 MODULE prog_args
   CHARACTER(len=80) :: shm_key
   CHARACTER(len=500) :: exe_dir = '.', data_dir = '.', temp_dir = '.'
+  INTEGER :: profile_depth = 0          !jt9 -P, zero when not profiling
 END MODULE prog_args
@@ -19,7 +19,10 @@
 //    along with qracodes source distribution.  
 //    If not, see <http://www.gnu.org/licenses/>.
 
+#include <string.h>
+
 #include "npfwht.h"
+#include "npsimd.h"
 
 #define WHBFY(dst,src,base,offs,dist) { dst[base+offs]=src[base+offs]+src[base+offs+dist]; dst[base+offs+dist]=src[base+offs]-src[base+offs+dist]; }
 
@@ -147,6 +150,49 @@ static void np_fwht32(float *dst, float *src)
 
 }
 
+#ifdef NP_SIMD
+
+// Same butterflies in the same order as the scalar version below,
+// eight and four elements at a time
+NP_SIMD_DISPATCH
+static void np_fwht64(float *dst, float *src)
+{
+	np_v8sf t[8];
+	np_v4sf *q = (np_v4sf*)t;
+	int dist,base,k;
+	static const np_v4sf sgn2 = { 1.f, 1.f,-1.f,-1.f};
+	static const np_v4sf sgn1 = { 1.f,-1.f, 1.f,-1.f};
+
+	memcpy(t,src,sizeof(t));
+
+	// groups 1 to 3, distance 32, 16 and 8
+	for (dist=4;dist>=1;dist>>=1)
+		for (base=0;base<8;base+=2*dist)
+			for (k=0;k<dist;k++) {
+				np_v8sf a = t[base+k], b = t[base+k+dist];
+				t[base+k]      = a+b;
+				t[base+k+dist] = a-b;
+				}
+
+	// group 4, distance 4
+	for (k=0;k<16;k+=2) {
+		np_v4sf a = q[k], b = q[k+1];
+		q[k]   = a+b;
+		q[k+1] = a-b;
+		}
+
+	// groups 5 and 6, distance 2 and 1 within each group of four
+	for (k=0;k<16;k++) {
+		np_v4sf x = q[k];
+		x    = __builtin_shuffle(x,(np_v4si){0,1,0,1}) + __builtin_shuffle(x,(np_v4si){2,3,2,3})*sgn2;
+		q[k] = __builtin_shuffle(x,(np_v4si){0,0,2,2}) + __builtin_shuffle(x,(np_v4si){1,1,3,3})*sgn1;
+		}
+
+	memcpy(dst,t,sizeof(t));
+}
+
+#else
+
 static void np_fwht64(float *dst, float *src)
 {
 	float t[128];
@@ -213,4 +259,6 @@ static void np_fwht64(float *dst, float *src)
 	WHBFY(dst,t1,40,0,1);  WHBFY(dst,t1,42,0,1); WHBFY(dst,t1,44,0,1); WHBFY(dst,t1,46,0,1); 
 	WHBFY(dst,t1,48,0,1);  WHBFY(dst,t1,50,0,1); WHBFY(dst,t1,52,0,1); WHBFY(dst,t1,54,0,1); 
 	WHBFY(dst,t1,56,0,1);  WHBFY(dst,t1,58,0,1); WHBFY(dst,t1,60,0,1); WHBFY(dst,t1,62,0,1); 
-}
\ No newline at end of file
+}
+
+#endif // NP_SIMD
@@ -0,0 +1,49 @@
+// npsimd.h
+// Portable short vector types for the qracodes kernels
+//
+// With GCC the 64-point kernels (fwht, pd_imul, pd_norm) are written
+// with the compiler vector extensions and are built both for the base
+// instruction set and for AVX2, the best version being selected at
+// load time by the dynamic loader (target_clones). Other compilers,
+// and platforms without ifunc support, use the plain scalar code or
+// the base instruction set version only.
+//
+// The vectorized fwht and pd_imul give bit identical results to the
+// scalar versions, pd_norm sums in a different order.
+// ------------------------------------------------------------------------------
+// This file is part of the qracodes project, a Forward Error Control
+// encoding/decoding package based on Q-ary RA (repeat and accumulate) LDPC codes.
+//
+//    qracodes is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//    qracodes is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+
+//    You should have received a copy of the GNU General Public License
+//    along with qracodes source distribution.  
+//    If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef _npsimd_h_
+#define _npsimd_h_
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+
+#define NP_SIMD 1
+
+typedef float np_v4sf __attribute__((vector_size(16)));
+typedef float np_v8sf __attribute__((vector_size(32)));
+typedef int   np_v4si __attribute__((vector_size(16)));
+
+#if defined(__linux__) && defined(__x86_64__) && __GNUC__ >= 6
+#define NP_SIMD_DISPATCH __attribute__((target_clones("avx2","default")))
+#else
+#define NP_SIMD_DISPATCH
+#endif
+
+#endif
+
+#endif // _npsimd_h_
@@ -20,6 +20,7 @@
 //    If not, see <http://www.gnu.org/licenses/>.
 
 #include "pdmath.h"
+#include "npsimd.h"
 
 typedef const float *ppd_uniform;
 typedef void  (*ppd_imul)(float*,const float*);
@@ -115,6 +116,20 @@ static void pd_imul32(float *dst, const float *src)
 	pd_imul16(dst,src);
 	pd_imul16(dst+16,src+16);
 }
+#ifdef NP_SIMD
+NP_SIMD_DISPATCH
+static void pd_imul64(float *dst, const float *src)
+{
+	np_v8sf d[8], t[8];
+	int k;
+
+	memcpy(d,dst,sizeof(d));
+	memcpy(t,src,sizeof(t));
+	for (k=0;k<8;k++)
+		d[k] *= t[k];
+	memcpy(dst,d,sizeof(d));
+}
+#else
 static void pd_imul64(float *dst, const float *src)
 {
 	pd_imul16(dst, src);
@@ -122,6 +137,7 @@ static void pd_imul64(float *dst, const float *src)
 	pd_imul16(dst+32, src+32);
 	pd_imul16(dst+48, src+48);
 }
+#endif // NP_SIMD
 
 static const ppd_imul pd_imul_tab[7] = {
 	pd_imul1,
@@ -256,6 +272,32 @@ static float pd_norm32(float *ppd)
 	return to;
 }
 
+#ifdef NP_SIMD
+NP_SIMD_DISPATCH
+static float pd_norm64(float *ppd)
+{
+	np_v8sf d[8], acc;
+	float t,to;
+	int k;
+
+	memcpy(d,ppd,sizeof(d));
+	acc = ((d[0]+d[1])+(d[2]+d[3]))+((d[4]+d[5])+(d[6]+d[7]));
+	t = ((acc[0]+acc[1])+(acc[2]+acc[3]))+((acc[4]+acc[5])+(acc[6]+acc[7]));
+
+	if (t<=0) {
+		pd_init(ppd,pd_uniform(6),pd_log2dim[6]);
+		return t;
+		}
+
+	to = t;
+	t = 1.0f/t;
+	for (k=0;k<8;k++)
+		d[k] *= t;
+	memcpy(ppd,d,sizeof(d));
+
+	return to;
+}
+#else
 static float pd_norm64(float *ppd)
 {
 	float t,to;
@@ -305,7 +347,7 @@ static float pd_norm64(float *ppd)
 
 	return to;
 }
-
+#endif // NP_SIMD
 
 static const ppd_norm pd_norm_tab[7] = {
 	pd_norm1,
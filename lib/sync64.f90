@@ -2,6 +2,7 @@ subroutine sync64(c0,nf1,nf2,nfqso,ntol,mode64,emedelay,dtx,f0,jpk,sync,  &
      sync2,width)
 
   use timer_module, only: timer
+  use decoder_results, only: save_red
 
   parameter (NMAX=60*12000)                  !Max size of raw data at 12000 Hz
   parameter (NSPS=3456)                      !Samples per symbol at 6000 Hz
@@ -12,6 +13,7 @@ subroutine sync64(c0,nf1,nf2,nfqso,ntol,mode64,emedelay,dtx,f0,jpk,sync,  &
   real s0(0:NSPC-1)                          !Sum of s1+s2+s3
   real s0a(0:NSPC-1)                         !Best synchromized spectrum (saved)
   real s0b(0:NSPC-1)                         !tmp
+  real red(NSPC/3)                           !Sync curve for the waterfall
   real a(5)
   integer icos7(0:6)                         !Costas 7x7 tones
   integer ipk0(1)
@@ -137,10 +139,7 @@ subroutine sync64(c0,nf1,nf2,nfqso,ntol,mode64,emedelay,dtx,f0,jpk,sync,  &
   rms2=sqrt(sq/40.0)
   sync2=10.0*log10(a(2)/rms2)
 
-  slimit=6.0
-  rewind 17
-  write(17,1110) 0.0,0.0
-  rewind 17
+  nred=0
 !  rewind 76
   do i=2,iz-2*nskip-1,3
      x=i
@@ -153,12 +152,12 @@ subroutine sync64(c0,nf1,nf2,nfqso,ntol,mode64,emedelay,dtx,f0,jpk,sync,  &
      j=i+ia+49
      freq=j*df3
      ss=(s0a(j-1)+s0a(j)+s0a(j+1))/3.0
-     if(ss.gt.slimit) write(17,1110) freq,ss
-1110 format(3f10.3)
+     nred=nred+1
+     red(nred)=ss
 !     write(76,1110) freq,ss,yfit
+!1110 format(3f10.3)
   enddo
-  flush(17)
-  close(17)
+  call save_red((ia+51)*df3,3*df3,red,nred)
 !  flush(76)
 
   return
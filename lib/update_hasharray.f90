@@ -1,4 +1,5 @@
 subroutine update_hasharray(recent_calls,nrecent,nhasharray)
+  use callsign_hash
   
   character*12 recent_calls(nrecent)
   character*22 hashmsg
@@ -13,11 +14,13 @@ subroutine update_hasharray(recent_calls,nrecent,nhasharray)
         call hash(hashmsg,22,ihash)
         ihash=iand(ihash,4095)
         nhasharray(i,j)=ihash
+        call save_hash(HASH_MSK40,ihash,hashmsg)
         hashmsg=trim(recent_calls(j))//' '//trim(recent_calls(i))
         call fmtmsg(hashmsg,iz)
         call hash(hashmsg,22,ihash)
         ihash=iand(ihash,4095)
         nhasharray(j,i)=ihash
+        call save_hash(HASH_MSK40,ihash,hashmsg)
       endif
     enddo
   enddo 
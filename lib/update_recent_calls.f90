@@ -1,6 +1,9 @@
 subroutine update_recent_calls(call,calls_hrd,nsize)
+use callsign_hash, only: save_call
 character*12 call,calls_hrd(nsize)
 
+ call save_call(call)                    !Resolves its hashes in any mode
+
  new=1
  do ic=1,nsize
    if( calls_hrd(ic).eq.call ) then
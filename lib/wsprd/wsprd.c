@@ -41,12 +41,17 @@
 #include "nhash.h"
 #include "wsprd_utils.h"
 #include "wsprsim_utils.h"
+#include "../callsign_hash.h"
 
 #define max(x,y) ((x) > (y) ? (x) : (y))
 // Possible PATIENCE options: FFTW_ESTIMATE, FFTW_ESTIMATE_PATIENT,
 // FFTW_MEASURE, FFTW_PATIENT, FFTW_EXHAUSTIVE
 #define PATIENCE FFTW_ESTIMATE
+// Wisdom written by fftw_train holds patient plans for our sizes, when
+// it is loaded those are used and anything else is planned at PATIENCE
+#define TRAINED_PATIENCE (FFTW_PATIENT | FFTW_WISDOM_ONLY)
 fftwf_plan PLAN1,PLAN2,PLAN3;
+int trained_wisdom=0;
 
 unsigned char pr3[162]=
 {1,1,0,0,0,0,0,0,1,0,0,0,1,1,1,0,0,0,1,0,
@@ -146,7 +151,9 @@ unsigned long readwavfile(char *ptr_to_infile, int ntrmin, float *idat, float *q
     
     realin=(float*) fftwf_malloc(sizeof(float)*nfft1);
     fftout=(fftwf_complex*) fftwf_malloc(sizeof(fftwf_complex)*nfft1);
-    PLAN1 = fftwf_plan_dft_r2c_1d(nfft1, realin, fftout, PATIENCE);
+    PLAN1 = NULL;
+    if( trained_wisdom ) PLAN1 = fftwf_plan_dft_r2c_1d(nfft1, realin, fftout, TRAINED_PATIENCE);
+    if( !PLAN1 ) PLAN1 = fftwf_plan_dft_r2c_1d(nfft1, realin, fftout, PATIENCE);
     
     for (i=0; i<npoints; i++) {
         realin[i]=buf2[i]/32768.0;
@@ -171,7 +178,9 @@ unsigned long readwavfile(char *ptr_to_infile, int ntrmin, float *idat, float *q
     
     fftwf_free(fftout);
     fftout=(fftwf_complex*) fftwf_malloc(sizeof(fftwf_complex)*nfft2);
-    PLAN2 = fftwf_plan_dft_1d(nfft2, fftin, fftout, FFTW_BACKWARD, PATIENCE);
+    PLAN2 = NULL;
+    if( trained_wisdom ) PLAN2 = fftwf_plan_dft_1d(nfft2, fftin, fftout, FFTW_BACKWARD, TRAINED_PATIENCE);
+    if( !PLAN2 ) PLAN2 = fftwf_plan_dft_1d(nfft2, fftin, fftout, FFTW_BACKWARD, PATIENCE);
     fftwf_execute(PLAN2);
     
     for (i=0; i<(size_t)nfft2; i++) {
@@ -581,7 +590,7 @@ int main(int argc, char *argv[])
     char *callsign, *call_loc_pow;
     char *ptr_to_infile,*ptr_to_infile_suffix;
     char *data_dir=NULL;
-    char wisdom_fname[200],all_fname[200],spots_fname[200];
+    char wisdom_fname[200],trained_fname[200],all_fname[200],spots_fname[200];
     char timer_fname[200],hash_fname[200];
     char uttime[5],date[7];
     int c,delta,maxpts=65536,verbose=0,quickmode=0,more_candidates=0, stackdecoder=0;
@@ -718,22 +727,26 @@ int main(int argc, char *argv[])
     
     FILE *fp_fftwf_wisdom_file, *fall_wspr, *fwsprd, *fhash, *ftimer;
     strcpy(wisdom_fname,".");
+    strcpy(trained_fname,".");
     strcpy(all_fname,".");
     strcpy(spots_fname,".");
     strcpy(timer_fname,".");
     strcpy(hash_fname,".");
     if(data_dir != NULL) {
         strcpy(wisdom_fname,data_dir);
+        strcpy(trained_fname,data_dir);
         strcpy(all_fname,data_dir);
         strcpy(spots_fname,data_dir);
         strcpy(timer_fname,data_dir);
         strcpy(hash_fname,data_dir);
     }
     strncat(wisdom_fname,"/wspr_wisdom.dat",20);
+    strncat(trained_fname,"/fftwf_trained_wisdom.dat",28);
     strncat(all_fname,"/ALL_WSPR.TXT",20);
     strncat(spots_fname,"/wspr_spots.txt",20);
     strncat(timer_fname,"/wspr_timer.out",20);
     strncat(hash_fname,"/hashtable.txt",20);
+    trained_wisdom=fftwf_import_wisdom_from_filename(trained_fname); //From fftw_train
     if ((fp_fftwf_wisdom_file = fopen(wisdom_fname, "r"))) {  //Open FFTW wisdom
         fftwf_import_wisdom_from_file(fp_fftwf_wisdom_file);
         fclose(fp_fftwf_wisdom_file);
@@ -786,7 +799,9 @@ int main(int argc, char *argv[])
     int nffts=4*floor(npoints/512)-1;
     fftin=(fftwf_complex*) fftwf_malloc(sizeof(fftwf_complex)*512);
     fftout=(fftwf_complex*) fftwf_malloc(sizeof(fftwf_complex)*512);
-    PLAN3 = fftwf_plan_dft_1d(512, fftin, fftout, FFTW_FORWARD, PATIENCE);
+    PLAN3 = NULL;
+    if( trained_wisdom ) PLAN3 = fftwf_plan_dft_1d(512, fftin, fftout, FFTW_FORWARD, TRAINED_PATIENCE);
+    if( !PLAN3 ) PLAN3 = fftwf_plan_dft_1d(512, fftin, fftout, FFTW_FORWARD, PATIENCE);
     
     float ps[512][nffts];
     float w[512];
@@ -794,17 +809,27 @@ int main(int argc, char *argv[])
         w[i]=sin(0.006147931*i);
     }
     
+    // The shared table has the calls copied in every mode, hashtable.txt
+    // is only read to carry its calls over to a new table or if the
+    // table cannot be opened.
+    int hash_store=-1;
     if( usehashtable ) {
         char line[80], hcall[12];
-        if( (fhash=fopen(hash_fname,"r+")) ) {
+        hash_store=callsign_hash_open(data_dir != NULL ? data_dir : ".");
+        if( hash_store != 0 && (fhash=fopen(hash_fname,"r")) ) {
             while (fgets(line, sizeof(line), fhash) != NULL) {
                 sscanf(line,"%d %s",&nh,hcall);
                 strcpy(hashtab+nh*13,hcall);
+                callsign_hash_put(CALLSIGN_HASH_WSPR,nh,hcall);
+            }
+            fclose(fhash);
+        }
+        char scall[CALLSIGN_HASH_TEXT];
+        for (i=0; i<32768; i++) {
+            if( callsign_hash_get(CALLSIGN_HASH_WSPR,i,0,scall) ) {
+                strncpy(hashtab+i*13,scall,12);
             }
-        } else {
-            fhash=fopen(hash_fname,"w+");
         }
-        fclose(fhash);
     }
 
     //*************** main loop starts here *****************
@@ -1149,6 +1174,7 @@ int main(int argc, char *argv[])
                 // sanity checks on grid and power, and return
                 // call_loc_pow string and also callsign (for de-duping).
                 noprint=unpk_(message,hashtab,call_loc_pow,callsign);
+                if( !noprint ) callsign_hash_add_call(callsign);
 
                 // subtract even on last pass
                 if( subtraction && (ipass < npasses ) && !noprint ) {
@@ -1271,7 +1297,7 @@ int main(int argc, char *argv[])
     fftwf_destroy_plan(PLAN2);
     fftwf_destroy_plan(PLAN3);
     
-    if( usehashtable ) {
+    if( usehashtable && hash_store < 0 ) {
         fhash=fopen(hash_fname,"w");
         for (i=0; i<32768; i++) {
             if( strncmp(hashtab+i*13,"\0",1) != 0 ) {
@@ -1281,6 +1307,7 @@ int main(int argc, char *argv[])
         fclose(fhash);
     }
     
+    callsign_hash_close();
     if( stackdecoder ) {
         free(stack);
     }
@@ -124,32 +124,30 @@ void ADIF::add(QString const& call, QString const& band, QString const& mode, QS
 // return true if in the log same band and mode (where JT65 == JT9)
 bool ADIF::match(QString const& call, QString const& band, QString const& mode) const
 {
-    QList<QSO> qsos = _data.values(call);
-    if (qsos.size()>0)
+    // walk the entries for this call in place rather than copying them
+    // out with values(), this is called for every decoded CQ
+    for (auto i = _data.constFind (call); i != _data.constEnd () && i.key () == call; ++i)
     {
-        QSO q;
-        foreach(q,qsos)
+        QSO const& q = i.value ();
+        if (     (band.compare(q.band,Qt::CaseInsensitive) == 0)
+              || (band=="")
+              || (q.band==""))
         {
-            if (     (band.compare(q.band,Qt::CaseInsensitive) == 0)
-                  || (band=="")
-                  || (q.band==""))
-            {
-                if (
-                     (
-                       ((mode.compare("JT65",Qt::CaseInsensitive)==0) ||
-                        (mode.compare("JT9",Qt::CaseInsensitive)==0)  ||
-                        (mode.compare("FT8",Qt::CaseInsensitive)==0))
-                       &&
-                       ((q.mode.compare("JT65",Qt::CaseInsensitive)==0) ||
-                        (q.mode.compare("JT9",Qt::CaseInsensitive)==0)  ||
-                        (q.mode.compare("FT8",Qt::CaseInsensitive)==0))
-                     )
-                        || (mode.compare(q.mode,Qt::CaseInsensitive)==0)
-                        || (mode=="")
-                        || (q.mode=="")
-                    )
-                return true;
-            }
+            if (
+                 (
+                   ((mode.compare("JT65",Qt::CaseInsensitive)==0) ||
+                    (mode.compare("JT9",Qt::CaseInsensitive)==0)  ||
+                    (mode.compare("FT8",Qt::CaseInsensitive)==0))
+                   &&
+                   ((q.mode.compare("JT65",Qt::CaseInsensitive)==0) ||
+                    (q.mode.compare("JT9",Qt::CaseInsensitive)==0)  ||
+                    (q.mode.compare("FT8",Qt::CaseInsensitive)==0))
+                 )
+                    || (mode.compare(q.mode,Qt::CaseInsensitive)==0)
+                    || (mode=="")
+                    || (q.mode=="")
+                )
+            return true;
         }
     }
     return false;
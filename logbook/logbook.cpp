@@ -33,6 +33,7 @@ void LogBook::init()
   _log.load();
 
   _setAlreadyWorkedFromLog();
+  ++_generation;
 
   /*
     int QSOcount = _log.getCount();
@@ -94,6 +95,7 @@ void LogBook::addAsWorked(const QString call, const QString band, const QString
   QString countryName = _countries.find(call);
   if (countryName.length() > 0)
     _worked.setAsWorked(countryName);
+  ++_generation;
 }
 
 
@@ -26,10 +26,15 @@ public:
                       bool &countryWorkedBefore) const;
     void addAsWorked(const QString call, const QString band, const QString mode, const QString date);
 
+    // bumped whenever worked before status may have changed so that
+    // clients caching match() results know to discard them
+    unsigned generation () const {return _generation;}
+
 private:
    CountryDat _countries;
    CountriesWorked _worked;
    ADIF _log;
+   unsigned _generation {0};
 
    void _setAlreadyWorkedFromLog();
 
@@ -5,6 +5,7 @@
 #include <functional>
 #include <fstream>
 #include <iterator>
+#include <algorithm>
 #include <fftw3.h>
 #include <QLineEdit>
 #include <QRegExpValidator>
@@ -24,6 +25,9 @@
 #include <QAction>
 #include <QActionGroup>
 #include <QSplashScreen>
+#include <QInputDialog>
+#include <QMutex>
+#include <QMutexLocker>
 
 #include "revision_utils.hpp"
 #include "qt_helpers.hpp"
@@ -54,6 +58,7 @@
 #include "HelpTextWindow.hpp"
 #include "SampleDownloader.hpp"
 #include "Audio/BWFFile.hpp"
+#include "lib/period_archive.h"
 #include "MultiSettings.hpp"
 #include "MaidenheadLocatorValidator.hpp"
 #include "CallsignValidator.hpp"
@@ -117,9 +122,6 @@ extern "C" {
                 float* level, float* sigdb, float* snr, float* dfreq,
                 float* width);
 
-  void fast_decode_(short id2[], int narg[], int* ntrperiod,
-                    char msg[], char mycall[], char hiscall[],
-                    int len1, int len2, int len3);
   void degrade_snr_(short d2[], int* n, float* db, float* bandwidth);
 
   void wav12_(short d2[], short d1[], int* nbytes, short* nbitsam2);
@@ -152,7 +154,6 @@ float fast_s2[44992];
 int   fast_jh {0};
 int   fast_jhpeak {0};
 int   fast_jh2 {0};
-int narg[15];
 QVector<QColor> g_ColorTbl;
 
 namespace
@@ -230,9 +231,14 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
   m_modulator {new Modulator {TX_SAMPLE_RATE, NTMAX}},
   m_soundOutput {new SoundOutput},
   m_msErase {0},
+  m_nextTxMs {0},
+  m_txLeadMs {0},
   m_secBandChanged {0},
   m_freqNominal {0},
   m_freqTxNominal {0},
+  m_dopplerRetune {0},
+  m_decoderProfile {0},
+  m_decodeBudget {0},
   m_s6 {0.},
   m_tRemaining {0.},
   m_DTtol {3.0},
@@ -268,6 +274,7 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
   m_startAnother {false},
   m_saveDecoded {false},
   m_saveAll {false},
+  m_saveArchive {false},
   m_widebandDecode {false},
   m_dataAvailable {false},
   m_blankLine {false},
@@ -304,7 +311,9 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
   m_nsendingsh {0},
   m_onAirFreq0 {0.0},
   m_first_error {true},
+  m_fastSamplesKin {0},
   tx_status_label {"Receiving"},
+  m_savingPeriods {false},
   wsprNet {new WSPRNet {&m_network_manager, this}},
   m_appDir {QApplication::applicationDirPath ()},
   m_palette {"Linrad"},
@@ -433,9 +442,14 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
 
   // hook up Modulator slots and disposal
   connect (this, &MainWindow::transmitFrequency, m_modulator, &Modulator::setFrequency);
+  connect (this, &MainWindow::txDopplerShift, m_modulator, &Modulator::setDopplerShift);
+  connect (this, &MainWindow::txPttLead, m_modulator, &Modulator::setPttLead);
   connect (this, &MainWindow::endTransmitMessage, m_modulator, &Modulator::stop);
   connect (this, &MainWindow::tune, m_modulator, &Modulator::tune);
   connect (this, &MainWindow::sendMessage, m_modulator, &Modulator::start);
+  connect (m_modulator, &Modulator::txStartOffset, this, [this] (double dt) {
+      tx_status_label.setToolTip (tr ("Tx audio started %1 ms after its boundary").arg (qRound (1000. * dt)));
+    });
   connect (&m_audioThread, &QThread::finished, m_modulator, &QObject::deleteLater);
 
   // hook up the audio input stream signals, slots and disposal
@@ -444,14 +458,19 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
   connect (this, &MainWindow::resumeAudioInputStream, m_soundInput, &SoundInput::resume);
   connect (this, &MainWindow::finished, m_soundInput, &SoundInput::stop);
   connect(m_soundInput, &SoundInput::error, this, &MainWindow::showSoundInError);
-  // connect(m_soundInput, &SoundInput::status, this, &MainWindow::showStatusMessage);
+  connect(m_soundInput, &SoundInput::status, this, &MainWindow::showStatusMessage);
   connect (&m_audioThread, &QThread::finished, m_soundInput, &QObject::deleteLater);
 
   connect (this, &MainWindow::finished, this, &MainWindow::close);
 
   // hook up the detector signals, slots and disposal
   connect (this, &MainWindow::FFTSize, m_detector, &Detector::setBlockSize);
+  connect (this, &MainWindow::rxDopplerShift, m_detector, &Detector::setDopplerShift);
   connect(m_detector, &Detector::framesWritten, this, &MainWindow::dataSink);
+  connect (m_detector, &Detector::timing, this, [this] (double latency, double drift) {
+      ui->signal_meter_widget->setToolTip (tr ("Rx audio latency %1 ms, clock drift %2 ppm")
+                                           .arg (latency, 0, 'f', 1).arg (drift, 0, 'f', 0));
+    });
   connect (&m_audioThread, &QThread::finished, m_detector, &QObject::deleteLater);
 
   // setup the waterfall
@@ -625,8 +644,11 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
 
   // hook up save WAV file exit handling
   connect (&m_saveWAVWatcher, &QFutureWatcher<QString>::finished, [this] {
-      // extract the promise from the future
-      auto const& result = m_saveWAVWatcher.future ().result ();
+      // extract the promise from the future before the next batch
+      // replaces it
+      auto result = m_saveWAVWatcher.future ().result ();
+      m_savingPeriods = false;
+      if (!m_periodsToSave.isEmpty ()) startPeriodWriter ();
       if (!result.isEmpty ())   // error
         {
           MessageBox::critical_message (this, tr("Error Writing WAV File"), result);
@@ -712,8 +734,8 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
   tuneATU_Timer.setSingleShot(true);
   connect(&tuneATU_Timer, &QTimer::timeout, this, &MainWindow::stopTuneATU);
 
-  killFileTimer.setSingleShot(true);
-  connect(&killFileTimer, &QTimer::timeout, this, &MainWindow::killFile);
+  savePolicyTimer.setSingleShot(true);
+  connect(&savePolicyTimer, &QTimer::timeout, this, &MainWindow::applySavePolicy);
 
   uploadTimer.setSingleShot(true);
   connect(&uploadTimer, SIGNAL(timeout()), this, SLOT(uploadSpots()));
@@ -729,7 +751,6 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
                   "1 mW","2 mW","5 mW","10 mW","20 mW","50 mW","100 mW","200 mW","500 mW",
                   "1 W","2 W","5 W","10 W","20 W","50 W","100 W","200 W","500 W","1 kW"};
 
-  m_msg[0][0]=0;
   m_bQRAsyncWarned=false;
 
   for(int i=0; i<28; i++)  {                      //Initialize dBm values
@@ -805,12 +826,20 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
       , "-a", QDir::toNativeSeparators (m_config.writeable_data_dir ().absolutePath ())
       , "-t", QDir::toNativeSeparators (m_config.temp_dir ().absolutePath ())
       };
+  if (m_decoderProfile > 0)
+    {
+      jt9_args << "-P" << QString::number (m_decoderProfile);
+    }
   QProcessEnvironment env {QProcessEnvironment::systemEnvironment ()};
   env.insert ("OMP_STACKSIZE", "4M");
   proc_jt9.setProcessEnvironment (env);
   proc_jt9.start(QDir::toNativeSeparators (m_appDir) + QDir::separator () +
           "jt9", jt9_args, QIODevice::ReadWrite | QIODevice::Unbuffered);
 
+  // patient plans from fftw_train, if present, are used in preference
+  QString tfname {QDir::toNativeSeparators(m_config.writeable_data_dir ().absoluteFilePath ("fftwf_trained_wisdom.dat"))};
+  fftwtrained_.ntrained = fftwf_import_wisdom_from_filename(tfname.toLocal8Bit ());
+
   QString fname {QDir::toNativeSeparators(m_config.writeable_data_dir ().absoluteFilePath ("wsjtx_wisdom.dat"))};
   QByteArray cfname=fname.toLocal8Bit();
   fftwf_import_wisdom_from_filename(cfname);
@@ -821,7 +850,6 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
 
   connect (&m_wav_future_watcher, &QFutureWatcher<void>::finished, this, &MainWindow::diskDat);
 
-  connect(&watcher3, SIGNAL(finished()),this,SLOT(fast_decode_done()));
 //  Q_EMIT startAudioInputStream (m_config.audio_input_device (), m_framesAudioInputBuffered, &m_detector, m_downSampleFactor, m_config.audio_input_channel ());
   Q_EMIT startAudioInputStream (m_config.audio_input_device (), m_framesAudioInputBuffered, m_detector, m_downSampleFactor, m_config.audio_input_channel ());
   Q_EMIT initializeAudioOutputStream (m_config.audio_output_device (), AudioDevice::Mono == m_config.audio_output_channel () ? 1 : 2, m_msAudioOutputBuffered);
@@ -1001,6 +1029,7 @@ void MainWindow::on_the_minute ()
 //--------------------------------------------------- MainWindow destructor
 MainWindow::~MainWindow()
 {
+  m_saveWAVWatcher.waitForFinished (); // it uses this
   m_astroWidget.reset ();
   QString fname {QDir::toNativeSeparators(m_config.writeable_data_dir ().absoluteFilePath ("wsjtx_wisdom.dat"))};
   QByteArray cfname=fname.toLocal8Bit();
@@ -1182,6 +1211,25 @@ void MainWindow::readSettings()
   m_msAudioOutputBuffered = m_settings->value ("Audio/OutputBufferMs").toInt ();
   m_framesAudioInputBuffered = m_settings->value ("Audio/InputBufferFrames", RX_SAMPLE_RATE / 10).toInt ();
   m_audioThreadPriority = static_cast<QThread::Priority> (m_settings->value ("Audio/ThreadPriority", QThread::HighPriority).toInt () % 8);
+  // audio input backend, "qt", "alsa" or "file", safe to set directly
+  // as the audio thread has not been started yet
+  m_soundInput->setBackend (m_settings->value ("Audio/InputBackend", "qt").toString ()
+                            , m_settings->value ("Audio/InputBackendDevice").toString ());
+  // Rx periods kept in memory for saving after the event
+  m_periods.set_capacity (m_settings->value ("Audio/RetainedPeriods", 8).toInt ());
+  // save to compressed daily archive segments rather than WAV files
+  m_saveArchive = m_settings->value ("Audio/SaveArchive", false).toBool ();
+  // EME Doppler in Hz corrected in the audio before the rig is
+  // retuned, zero to do it all by CAT as before
+  m_dopplerRetune = m_settings->value ("Audio/DopplerRetune", 50).toInt ();
+  // profile jt9 into decoder_trace.json and decoder_metrics.json,
+  // the value is the depth of timed routines traced
+  m_decoderProfile = m_settings->value ("Decoder/Profile", 0).toInt ();
+  // percentage of the T/R period a decode may take before the
+  // decoders drop optional stages, 0 for no limit
+  m_decodeBudget = m_settings->value ("Decoder/Budget", 90).toInt ();
+  // seconds before the same call, band and mode is spotted again
+  psk_Reporter->setDeduplicationWindow (m_settings->value ("PSKReporter/DedupSeconds", 5 * 60).toUInt ());
   m_settings->endGroup ();
 
   //for QRP with Raspberry pi by KD8CEC
@@ -1394,22 +1442,23 @@ void MainWindow::dataSink(qint64 frames)
 
     if(!m_diskData) {                        //Always save; may delete later
 
+      QDateTime period_start;
       if(m_mode=="FT8") {
         int n=now.time().second() % m_TRperiod;
         if(n<(m_TRperiod/2)) n=n+m_TRperiod;
-        auto const& period_start=now.addSecs(-n);
+        period_start=now.addSecs(-n);
         m_fnameWE=m_config.save_directory().absoluteFilePath (period_start.toString("yyMMdd_hhmmss"));
       } else {
-        auto const& period_start = now.addSecs (-(now.time ().minute () % (m_TRperiod / 60)) * 60);
+        period_start = now.addSecs (-(now.time ().minute () % (m_TRperiod / 60)) * 60);
+        period_start.setTime (QTime {period_start.time ().hour (), period_start.time ().minute ()});
         m_fnameWE=m_config.save_directory ().absoluteFilePath (period_start.toString ("yyMMdd_hhmm"));
       }
       m_fileToSave.clear ();
+      retainPeriod (period_start);
 
-      // the following is potential a threading hazard - not a good
-      // idea to pass pointer to be processed in another thread
-      m_saveWAVWatcher.setFuture (QtConcurrent::run (std::bind (&MainWindow::save_wave_file,
-            this, m_fnameWE, &dec_data.d2[0], m_TRperiod, m_config.my_callsign(),
-            m_config.my_grid(), m_mode, m_nSubMode, m_freqNominal, m_hisCall, m_hisGrid)));
+      // the WSPR decoders read the file so it is always written,
+      // other modes are written when the save policy asks
+      if (m_saveAll || m_mode.startsWith ("WSPR")) savePeriod (m_fnameWE);
       if (m_mode=="WSPR") {
         QString c2name_string {m_fnameWE + ".c2"};
         int len1=c2name_string.length();
@@ -1464,9 +1513,7 @@ void MainWindow::startP1()
   p1.start(m_cmndP1);
 }
 
-QString MainWindow::save_wave_file (QString const& name, short const * data, int seconds,
-        QString const& my_callsign, QString const& my_grid, QString const& mode, qint32 sub_mode,
-        Frequency frequency, QString const& his_call, QString const& his_grid) const
+QString MainWindow::save_wave_file (PeriodRing::Period const& period) const
 {
   //
   // This member function runs in a thread and should not access
@@ -1479,16 +1526,16 @@ QString MainWindow::save_wave_file (QString const& name, short const * data, int
   format.setChannelCount (1);
   format.setSampleSize (16);
   format.setSampleType (QAudioFormat::SignedInt);
-  auto source = QString {"%1, %2"}.arg (my_callsign).arg (my_grid);
+  auto source = QString {"%1, %2"}.arg (period.my_callsign).arg (period.my_grid);
   auto comment = QString {"Mode=%1%2, Freq=%3%4"}
-     .arg (mode)
-     .arg (QString {mode.contains ('J') && !mode.contains ('+')
-           ? QString {", Sub Mode="} + QChar {'A' + sub_mode}
+     .arg (period.mode)
+     .arg (QString {period.mode.contains ('J') && !period.mode.contains ('+')
+           ? QString {", Sub Mode="} + QChar {'A' + period.sub_mode}
          : QString {}})
-        .arg (Radio::frequency_MHz_string (frequency))
-     .arg (QString {!mode.startsWith ("WSPR") ? QString {", DXCall=%1, DXGrid=%2"}
-         .arg (his_call)
-         .arg (his_grid).toLocal8Bit () : ""});
+        .arg (Radio::frequency_MHz_string (period.frequency))
+     .arg (QString {!period.mode.startsWith ("WSPR") ? QString {", DXCall=%1, DXGrid=%2"}
+         .arg (period.his_call)
+         .arg (period.his_grid).toLocal8Bit () : ""});
   BWFFile::InfoDictionary list_info {
       {{{'I','S','R','C'}}, source.toLocal8Bit ()},
       {{{'I','S','F','T'}}, program_title (revision ()).simplified ().toLocal8Bit ()},
@@ -1496,16 +1543,50 @@ QString MainWindow::save_wave_file (QString const& name, short const * data, int
                           .toString ("yyyy-MM-ddTHH:mm:ss.zzzZ").toLocal8Bit ()},
       {{{'I','C','M','T'}}, comment.toLocal8Bit ()},
   };
-  BWFFile wav {format, name + ".wav", list_info};
+  BWFFile wav {format, period.name + ".wav", list_info};
   if (!wav.open (BWFFile::WriteOnly)
-      || 0 > wav.write (reinterpret_cast<char const *> (data)
-                        , sizeof (short) * seconds * format.sampleRate ()))
+      || 0 > wav.write (reinterpret_cast<char const *> (period.samples.constData ())
+                        , sizeof (short) * period.samples.size ()))
     {
       return wav.errorString ();
     }
   return QString {};
 }
 
+QString MainWindow::save_archive_period (PeriodRing::Period const& period) const
+{
+  //
+  // This member function runs in a thread, see save_wave_file().
+  //
+  // One segment per UTC day in the save directory, appends must not
+  // interleave.
+  //
+  static QMutex mutex;
+  QMutexLocker lock {&mutex};
+  auto segment = QFileInfo {period.name}.dir ().absoluteFilePath (period.start.toString ("yyMMdd") + ".wsa");
+  auto comment = QString {"%1, %2, Mode=%3%4, DXCall=%5, DXGrid=%6"}
+     .arg (period.my_callsign)
+     .arg (period.my_grid)
+     .arg (period.mode)
+     .arg (QString {period.mode.contains ('J') && !period.mode.contains ('+')
+           ? QString {", Sub Mode="} + QChar {'A' + period.sub_mode}
+         : QString {}})
+     .arg (period.his_call)
+     .arg (period.his_grid);
+  period_archive_entry entry;
+  entry.utc_ms = period.start.toMSecsSinceEpoch ();
+  entry.dial_hz = period.frequency;
+  qstrncpy (entry.mode, period.mode.toLatin1 ().constData (), sizeof entry.mode);
+  entry.nsamples = period.samples.size ();
+  entry.sample_rate = 12000;
+  if (period_archive_append (QDir::toNativeSeparators (segment).toLocal8Bit ().constData (), &entry
+                             , comment.toLocal8Bit ().constData (), period.samples.constData ()))
+    {
+      return tr ("Cannot append to archive %1").arg (QDir::toNativeSeparators (segment));
+    }
+  return QString {};
+}
+
 //-------------------------------------------------------------- fastSink()
 void MainWindow::fastSink(qint64 frames)
 {
@@ -1517,6 +1598,8 @@ void MainWindow::fastSink(qint64 frames)
     memcpy(fast_s2,fast_s,4*703*64);             //Copy fast_s[] into fast_s2[]
     fast_jh2=fast_jh;
     if(!m_diskData) memset(dec_data.d2,0,2*30*12000);   //Zero the d2[] array
+    m_fastSamples.clear ();                      //Jobs keep their own references
+    m_fastSamplesKin=0;
     m_bFastDecodeCalled=false;
     m_bDecoded=false;
   }
@@ -1589,18 +1672,6 @@ void MainWindow::fastSink(qint64 frames)
 //  if(m_mode=="MSK144" and m_config.realTimeDecode()) decodeNow=false;
   if(m_mode=="MSK144") decodeNow=false;
 
-  if(decodeNow) {
-    m_dataAvailable=true;
-    m_t0=0.0;
-    m_t1=k/12000.0;
-    m_kdone=k;
-    dec_data.params.newdat=1;
-    if(!m_decoderBusy) {
-      m_bFastDecodeCalled=true;
-      decode();
-    }
-  }
-
   if(decodeNow or m_bFastDone) {
     if(!m_diskData) {
       QDateTime now {QDateTime::currentDateTimeUtc()};
@@ -1609,20 +1680,32 @@ void MainWindow::fastSink(qint64 frames)
       auto const& period_start = now.addSecs (-n);
       m_fnameWE = m_config.save_directory ().absoluteFilePath (period_start.toString ("yyMMdd_hhmmss"));
       m_fileToSave.clear ();
-      if(m_saveAll or m_bAltV or (m_bDecoded and m_saveDecoded) or (m_mode!="MSK144")) {
+      retainPeriod (period_start);
+      // the decode below shares the retained copy
+      m_fastSamples = m_periods.find (m_fnameWE)->samples;
+      m_fastSamplesKin = dec_data.params.kin;
+      if(m_saveAll or m_bAltV or (m_bDecoded and m_saveDecoded)) {
         m_bAltV=false;
-        // the following is potential a threading hazard - not a good
-        // idea to pass pointer to be processed in another thread
-        m_saveWAVWatcher.setFuture (QtConcurrent::run (std::bind (&MainWindow::save_wave_file,
-           this, m_fnameWE, &dec_data.d2[0], m_TRperiod, m_config.my_callsign(),
-           m_config.my_grid(), m_mode, m_nSubMode, m_freqNominal, m_hisCall, m_hisGrid)));
+        savePeriod (m_fnameWE);
       }
       if(m_mode!="MSK144") {
-        killFileTimer.start (3*1000*m_TRperiod/4); //Kill 3/4 period from now
+        savePolicyTimer.start (3*1000*m_TRperiod/4); //Decide 3/4 period from now
       }
     }
     m_bFastDone=false;
   }
+
+  if(decodeNow) {
+    m_dataAvailable=true;
+    m_t0=0.0;
+    m_t1=k/12000.0;
+    m_kdone=k;
+    dec_data.params.newdat=1;
+    if(!m_decoderBusy) {
+      m_bFastDecodeCalled=true;
+      decode();
+    }
+  }
   float tsec=0.001*(QDateTime::currentMSecsSinceEpoch() - ms0);
   m_fCPUmskrtd=0.9*m_fCPUmskrtd + 0.1*tsec;
 }
@@ -1900,6 +1983,7 @@ void MainWindow::keyPressEvent (QKeyEvent * e)
       if(e->modifiers() & Qt::AltModifier) {
         m_fileToSave = m_fnameWE;
         m_bAltV=true;
+        if (!m_diskData) savePeriod (m_fnameWE);
         return;
       }
       break;
@@ -2197,7 +2281,18 @@ void MainWindow::closeEvent(QCloseEvent * e)
   m_prefixes.reset ();
   m_shortcuts.reset ();
   m_mouseCmnds.reset ();
-  if(m_mode!="MSK144" and m_mode!="FT8") killFile();
+  if(m_mode!="MSK144" and m_mode!="FT8") applySavePolicy();
+  // the writer's finished handler won't run once the event loop has
+  // gone, so finish its batch and write any still queued here
+  m_saveWAVWatcher.waitForFinished ();
+  for (auto const& period : m_periodsToSave) {
+    auto result = write_period (period, m_saveArchive);
+    if (!result.isEmpty ()) {
+      MessageBox::critical_message (this, tr("Error Writing WAV File"), result);
+      break;
+    }
+  }
+  m_periodsToSave.clear ();
   mem_jt9->detach();
   QFile quitFile {m_config.temp_dir ().absoluteFilePath (".quit")};
   quitFile.open(QIODevice::ReadWrite);
@@ -2381,6 +2476,7 @@ void MainWindow::on_actionAstronomical_data_toggled (bool checked)
       connect (this, &MainWindow::finished, m_astroWidget.data (), &Astro::close);
       connect (m_astroWidget.data (), &Astro::tracking_update, [this] {
           m_astroCorrection = {};
+          audioDoppler ({});
           setRig ();
           setXIT (ui->TxFreqSpinBox->value ());
           displayDialFrequency ();
@@ -2415,9 +2511,35 @@ void MainWindow::on_actionOpen_triggered()                     //Open File
   monitor (false);
 
   QString fname;
-  fname=QFileDialog::getOpenFileName(this, "Open File", m_path,
-                                     "WSJT Files (*.wav)");
-  if(!fname.isEmpty ()) {
+  auto dir = m_path.contains (".wsa#") ? m_path.left (m_path.lastIndexOf ('#')) : m_path;
+  fname=QFileDialog::getOpenFileName(this, "Open File", dir,
+                                     "WSJT Files (*.wav *.wsa)");
+  if(fname.endsWith (".wsa", Qt::CaseInsensitive)) {
+    // pick a period from the archive index
+    period_archive_entry * entries;
+    int count = period_archive_index (QDir::toNativeSeparators (fname).toLocal8Bit ().constData (), &entries);
+    // numbered as the periods are in m_path so that identical periods
+    // can be told apart
+    QStringList items;
+    for (int i = 0; i < count; ++i) {
+      items << QString {"#%1  %2  %3  %4"}
+        .arg (i + 1)
+        .arg (QDateTime::fromMSecsSinceEpoch (entries[i].utc_ms, Qt::UTC).toString ("yyyy-MM-dd hh:mm:ss"))
+        .arg (Radio::pretty_frequency_MHz_string (Radio::Frequency (entries[i].dial_hz)))
+        .arg (QString::fromLatin1 (entries[i].mode));
+    }
+    free (entries);
+    if (!items.size ()) {
+      MessageBox::information_message (this, tr ("No periods in archive %1").arg (QDir::toNativeSeparators (fname)));
+      return;
+    }
+    bool ok;
+    auto item = QInputDialog::getItem (this, tr ("Open Archived Period"), tr ("Period:"), items, 0, false, &ok);
+    if (ok) {
+      on_stopButton_clicked();
+      read_archive_period (fname, item.mid (1, item.indexOf (' ') - 1).toInt ());
+    }
+  } else if(!fname.isEmpty ()) {
     m_path=fname;
     int i1=fname.lastIndexOf("/");
     QString baseName=fname.mid(i1+1);
@@ -2429,6 +2551,13 @@ void MainWindow::on_actionOpen_triggered()                     //Open File
   }
 }
 
+// The jt9 shared memory region, decoder results are read from it
+// directly
+struct dec_data * MainWindow::jt9_shared_data () const
+{
+  return reinterpret_cast<struct dec_data *> (mem_jt9->data ());
+}
+
 void MainWindow::read_wav_file (QString const& fname)
 {
   // call diskDat() when done
@@ -2476,10 +2605,70 @@ void MainWindow::read_wav_file (QString const& fname)
       }));
 }
 
+// Open period n, counting from 1, of an archive segment, returns the
+// number of periods in the segment. m_path becomes "segment#n" so the
+// following periods can be opened in turn.
+int MainWindow::read_archive_period (QString const& segment, int n)
+{
+  // call diskDat() when done
+  auto native = QDir::toNativeSeparators (segment).toLocal8Bit ();
+  period_archive_entry * entries;
+  int count = period_archive_index (native.constData (), &entries);
+  if (n < 1 || n > count) {
+    free (entries);
+    return count;
+  }
+  auto entry = entries[n - 1];
+  free (entries);
+  m_path = segment + '#' + QString::number (n);
+  tx_status_label.setStyleSheet("QLabel{background-color: #99ffff}");
+  tx_status_label.setText(" " + QFileInfo {segment}.fileName () + '#' + QString::number (n) + " ");
+  m_diskData=true;
+  auto start = QDateTime::fromMSecsSinceEpoch (entry.utc_ms, Qt::UTC).time ();
+  m_nutc0=m_UTCdisk;
+  m_UTCdisk=10000*start.hour () + 100*start.minute () + start.second ();
+  int nutc=m_UTCdisk;
+  m_wav_future_watcher.setFuture (QtConcurrent::run ([this, native, entry, nutc] {
+        // global variables and threads do not mix well, this needs changing
+        int max_samples = std::min (std::size_t (m_TRperiod * RX_SAMPLE_RATE),
+                                    sizeof (dec_data.d2) / sizeof (dec_data.d2[0]));
+        int frames_read = period_archive_read (native.constData (), entry.offset, nullptr, nullptr, 0
+                                               , dec_data.d2, max_samples);
+        if (frames_read > 0) {
+          // zero unfilled remaining sample space
+          std::memset (&dec_data.d2[frames_read], 0, sizeof (dec_data.d2[0]) * (max_samples - frames_read));
+          dec_data.params.nutc = nutc;
+          dec_data.params.kin = frames_read;
+          dec_data.params.newdat = 1;
+        } else {
+          dec_data.params.kin = 0;
+          dec_data.params.newdat = 0;
+        }
+      }));
+  return count;
+}
+
 void MainWindow::on_actionOpen_next_in_directory_triggered()   //Open Next
 {
   monitor (false);
 
+  auto hash = m_path.lastIndexOf ('#');
+  if (hash > 0 && m_path.contains (".wsa#")) {
+    // next period in the archive segment
+    int n = m_path.mid (hash + 1).toInt () + 1;
+    int count = read_archive_period (m_path.left (hash), n);
+    if (n > count) {
+      m_loopall=false;
+      MessageBox::information_message(this, tr("No more files to open."));
+      return;
+    }
+    if (m_loopall and n == count) {
+      m_loopall=false;
+      m_bNoMoreFiles=true;
+    }
+    return;
+  }
+
   int i,len;
   QFileInfo fi(m_path);
   QStringList list;
@@ -2567,6 +2756,19 @@ void MainWindow::on_actionSave_all_triggered()                //Save All
   ui->actionSave_all->setChecked(true);
 }
 
+void MainWindow::on_actionSave_recent_triggered()
+{
+  // write the retained periods not already on disk
+  QList<PeriodRing::Period> periods;
+  m_periods.for_each ([&periods] (PeriodRing::Period& period) {
+      if (!period.saved) {
+        period.saved = true;
+        periods << period;
+      }
+    });
+  if (periods.size ()) savePeriods (periods);
+}
+
 void MainWindow::on_actionKeyboard_shortcuts_triggered()
 {
   if (!m_shortcuts)
@@ -2702,10 +2904,7 @@ void MainWindow::decode()                                       //decode()
   if(m_mode=="QRA64") dec_data.params.nsubmode=100 + m_nSubMode;
   dec_data.params.minw=0;
   dec_data.params.nclearave=m_nclearave;
-  if(m_nclearave!=0) {
-    QFile f(m_config.temp_dir ().absoluteFilePath ("avemsg.txt"));
-    f.remove();
-  }
+  if(m_nclearave!=0) jt9_shared_data ()->results.naverage=0;
   dec_data.params.dttol=m_DTtol;
   dec_data.params.emedelay=0.0;
   if(m_config.decode_at_52s()) dec_data.params.emedelay=2.5;
@@ -2714,6 +2913,12 @@ void MainWindow::decode()                                       //decode()
   if(m_config.single_decode()) dec_data.params.nexp_decode += 32;
   if(m_config.enable_VHF_features()) dec_data.params.nexp_decode += 64;
   if(ui->cbVHFcontest->isChecked()) dec_data.params.nexp_decode += 128;
+  // the next period's decode is due one T/R period after this one,
+  // decodes at fQSO and of saved data are not limited
+  dec_data.params.nbudget=0;
+  if(m_decodeBudget>0 and !dec_data.params.nagain and !m_diskData) {
+    dec_data.params.nbudget=10*m_TRperiod*m_decodeBudget;
+  }
 
   strncpy(dec_data.params.datetime, m_dateTime.toLatin1(), 20);
   strncpy(dec_data.params.mycall, (m_config.my_callsign()+"            ").toLatin1(),12);
@@ -2726,9 +2931,10 @@ void MainWindow::decode()                                       //decode()
   //newdat=1  ==> this is new data, must do the big FFT
   //nagain=1  ==> decode only at fQSO +/- Tol
 
+  // jt9 owns the results block, only the members before it are copied
   char *to = (char*)mem_jt9->data();
   char *from = (char*) dec_data.ss;
-  int size=sizeof(struct dec_data);
+  int size=offsetof (struct dec_data, results);
   if(dec_data.params.newdat==0) {
     int noffset {offsetof (struct dec_data, params.nutc)};
     to += noffset;
@@ -2744,7 +2950,7 @@ void MainWindow::decode()                                       //decode()
       t1=m_t1Pick;
 //      if(t1 > m_kdone/12000.0 and !m_config.realTimeDecode()) t1=m_kdone/12000.0;
     }
-    static short int d2b[360000];
+    FastDecodeJob::Args narg {};
     narg[0]=dec_data.params.nutc;
     if(m_kdone>12000*m_TRperiod) {
       m_kdone=12000*m_TRperiod;
@@ -2766,10 +2972,21 @@ void MainWindow::decode()                                       //decode()
     narg[12]=0;
     narg[13]=-1;
     narg[14]=m_config.aggressive();
-    memcpy(d2b,dec_data.d2,2*360000);
-    watcher3.setFuture (QtConcurrent::run (std::bind (fast_decode_,&d2b[0],
-        &narg[0],&m_TRperiod,&m_msg[0][0],
-        dec_data.params.mycall,dec_data.params.hiscall,8000,12,12)));
+    // the job has its own copies, this and earlier jobs are not
+    // disturbed by GUI changes or by the next period
+    FastDecodeJob job {fastSnapshot (), narg, m_TRperiod
+        , QByteArray {dec_data.params.mycall, 12}, QByteArray {dec_data.params.hiscall, 12}};
+    auto watcher = new QFutureWatcher<FastDecodeJob::Results> {this};
+    connect (watcher, &QFutureWatcherBase::finished, this, [this, watcher] {
+        auto const& results = watcher->result ();
+        for (auto line : results.lines) {
+          if(results.args[13]/8==results.args[12]) line=line.trimmed().replace("<...>",m_calls);
+          m_fastDecodes << line;
+        }
+        watcher->deleteLater ();
+        fast_decode_done ();
+      });
+    watcher->setFuture (job.start ());
   } else {
     memcpy(to, from, qMin(mem_jt9->size(), size));
     QFile {m_config.temp_dir ().absoluteFilePath (".lock")}.remove (); // Allow jt9 to start
@@ -2777,17 +2994,28 @@ void MainWindow::decode()                                       //decode()
   }
 }
 
+QVector<short> MainWindow::fastSnapshot ()
+{
+  // the decoder buffer is refilled from the start of each period so
+  // jobs get a copy, shared while it still holds what they need
+  if (m_fastSamples.isEmpty () || dec_data.params.kin < m_fastSamplesKin || m_kdone > m_fastSamplesKin) {
+    int count {qMin (m_TRperiod * 12000, static_cast<int> (sizeof (dec_data.d2) / sizeof (dec_data.d2[0])))};
+    m_fastSamples = QVector<short> (count);
+    std::copy (dec_data.d2, dec_data.d2 + count, m_fastSamples.begin ());
+    m_fastSamplesKin = dec_data.params.kin;
+  }
+  return m_fastSamples;
+}
+
 void::MainWindow::fast_decode_done()
 {
   float t,tmax=-99.0;
   dec_data.params.nagain=false;
   dec_data.params.ndiskdat=false;
-//  if(m_msg[0][0]==0) m_bDecoded=false;
-  for(int i=0; m_msg[i][0] && i<100; i++) {
-    QString message=QString::fromLatin1(m_msg[i]);
-    m_msg[i][0]=0;
-    if(message.length()>80) message=message.left (80);
-    if(narg[13]/8==narg[12]) message=message.trimmed().replace("<...>",m_calls);
+//  if(m_fastDecodes.isEmpty()) m_bDecoded=false;
+  auto const decodes = m_fastDecodes;
+  m_fastDecodes.clear ();
+  for (auto message : decodes) {
 
 //Left (Band activity) window
     DecodedText decodedtext {message.replace (QChar::LineFeed, ""), "FT8" == m_mode &&
@@ -2852,40 +3080,65 @@ void MainWindow::decodeDone ()
   m_nclearave=0;
   QFile {m_config.temp_dir ().absoluteFilePath (".lock")}.open(QIODevice::ReadWrite);
   ui->DecodeButton->setChecked (false);
+  m_messageClient->flush_decodes ();
   decodeBusy(false);
   m_RxLog=0;
   m_blankLine=true;
 }
 
+// stages the decoders left out to finish within dec_data.params.nbudget
+void MainWindow::showSkippedStages (int skipped)
+{
+  if (!skipped) return;
+  QStringList stages;
+  if (skipped & SKIP_OSD) stages << tr ("OSD");
+  if (skipped & SKIP_AP) stages << tr ("AP");
+  if (skipped & SKIP_PASSES) stages << tr ("extra passes");
+  if (skipped & SKIP_TRIALS) stages << tr ("deep trials");
+  if (skipped & SKIP_CANDIDATES) stages << tr ("weak candidates");
+  statusBar ()->showMessage (tr ("Decode shortened to finish in time, skipped %1")
+                             .arg (stages.join (", ")), 1000 * m_TRperiod);
+}
+
+// jt9 -P has left the profile of the pass just finished in the
+// results block
+void MainWindow::sendDecoderStats ()
+{
+  auto const& results = jt9_shared_data ()->results;
+  MessageClient::DecoderStages stages;
+  for (int i = 0; i < qMin (results.nstages, MAXSTAGES); ++i)
+    {
+      stages.append ({QString::fromLatin1 (results.stages[i], sizeof results.stages[i]).trimmed ()
+            , results.stage_time[i], static_cast<quint32> (results.stage_calls[i])});
+    }
+  m_messageClient->decoder_stats (QDateTime::currentDateTimeUtc ().time (), m_mode, results.elapsed
+                                  , results.ncandidates, results.ndecodes, results.nskipped, stages);
+}
+
 void MainWindow::readFromStdout()                             //readFromStdout
 {
+  // everything available now goes into each window as one edit block
+  DisplayText::Batch band_activity_batch {ui->decodedTextBrowser};
+  DisplayText::Batch rx_frequency_batch {ui->decodedTextBrowser2};
   while(proc_jt9.canReadLine()) {
     QByteArray t=proc_jt9.readLine();
     bool bAvgMsg=false;
     int navg=0;
     if(t.indexOf("<DecodeFinished>") >= 0) {
-      if(m_mode=="QRA64") m_wideGraph->drawRed(0,0);
-      /*
       if(m_mode=="QRA64") {
-        char name[512];
-        QString fname=m_config.temp_dir ().absoluteFilePath ("red.dat");
-        strncpy(name,fname.toLatin1(), sizeof (name) - 1);
-        name[sizeof (name) - 1] = '\0';
-        FILE* fp=fopen(name,"rb");
-        if(fp != NULL) {
-          int ia,ib;
-          memset(dec_data.sred,0,4*5760);
-          fread(&ia,4,1,fp);
-          fread(&ib,4,1,fp);
-          fread(&dec_data.sred[ia-1],4,ib-ia+1,fp);
-          m_wideGraph->drawRed(ia,ib);
-
-        }
+        // fetch the sync curve for the waterfall, jt9 is idle now
+        auto const * shared = jt9_shared_data ();
+        std::copy (shared->sred, shared->sred + shared->results.nred, dec_data.sred);
+        dec_data.results.nred=shared->results.nred;
+        dec_data.results.fred=shared->results.fred;
+        dec_data.results.dfred=shared->results.dfred;
+        m_wideGraph->drawRed(0,0);
       }
-      */
       m_bDecoded = t.mid(20).trimmed().toInt() > 0;
+      showSkippedStages (jt9_shared_data ()->results.nskipped);
+      if (m_decoderProfile > 0) sendDecoderStats ();
       int mswait=3*1000*m_TRperiod/4;
-      if(!m_diskData) killFileTimer.start(mswait); //Kill in 3/4 period
+      if(!m_diskData) savePolicyTimer.start(mswait); //Decide in 3/4 period
       decodeDone ();
       m_startAnother=m_loopall;
       if(m_bNoMoreFiles) {
@@ -3002,12 +3255,12 @@ void MainWindow::readFromStdout()                             //readFromStdout
 
       if((m_mode=="JT4" or m_mode=="JT65" or m_mode=="QRA64") and m_msgAvgWidget!=NULL) {
         if(m_msgAvgWidget->isVisible()) {
-          QFile f(m_config.temp_dir ().absoluteFilePath ("avemsg.txt"));
-          if(f.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream s(&f);
-            QString t=s.readAll();
-            m_msgAvgWidget->displayAvg(t);
+          auto const& results = jt9_shared_data ()->results;
+          QString t;
+          for (int i = 0; i < qMin (results.naverage, MAXAVERAGE); ++i) {
+            t += QString::fromLatin1 (results.average[i], sizeof results.average[i]).trimmed () + '\n';
           }
+          m_msgAvgWidget->displayAvg(t);
         }
       }
     }
@@ -3093,24 +3346,92 @@ void MainWindow::pskPost (DecodedText const& decodedtext)
   pskSetLocal ();
   if(grid.contains (grid_regexp)) {
 //    qDebug() << "To PSKreporter:" << deCall << grid << frequency << msgmode << snr;
-    psk_Reporter->addRemoteStation(deCall,grid,QString::number(frequency),msgmode,
-           QString::number(snr),QString::number(QDateTime::currentDateTime().toTime_t()));
+    psk_Reporter->addRemoteStation(deCall,grid,frequency,m_config.bands ()->find (frequency),
+           msgmode,snr,QDateTime::currentDateTime().toTime_t());
   }
 }
 
-void MainWindow::killFile ()
+void MainWindow::applySavePolicy ()
 {
-  if (m_fnameWE.size () &&
-      !(m_saveAll || (m_saveDecoded && m_bDecoded) || m_fnameWE == m_fileToSave)) {
-    QFile f1 {m_fnameWE + ".wav"};
-    if(f1.exists()) f1.remove();
-    if(m_mode.startsWith ("WSPR")) {
+  if (!m_fnameWE.size ()) return;
+  bool save {m_saveAll || (m_saveDecoded && m_bDecoded) || m_fnameWE == m_fileToSave};
+  if (m_mode.startsWith ("WSPR")) {
+    // written for the decoder so delete unless wanted
+    if (!save) {
+      QFile f1 {m_fnameWE + ".wav"};
+      if(f1.exists()) f1.remove();
       QFile f2 {m_fnameWE + ".c2"};
       if(f2.exists()) f2.remove();
+      // still retained, so Save recent can write it again
+      if (auto period = m_periods.find (m_fnameWE)) period->saved = false;
+    }
+  } else if (save) {
+    savePeriod (m_fnameWE);
+  }
+}
+
+void MainWindow::retainPeriod (QDateTime const& start)
+{
+  // period lengths are whole seconds at 12000 Hz
+  int count {qMin (m_TRperiod * 12000, static_cast<int> (sizeof (dec_data.d2) / sizeof (dec_data.d2[0])))};
+  QVector<short> samples (count);
+  std::copy (dec_data.d2, dec_data.d2 + count, samples.begin ());
+  m_periods.append ({m_fnameWE, start, samples, m_config.my_callsign (), m_config.my_grid ()
+        , m_mode, m_nSubMode, m_freqNominal, m_hisCall, m_hisGrid, false});
+}
+
+void MainWindow::savePeriod (QString const& name)
+{
+  if (auto period = m_periods.find (name)) {
+    if (!period->saved) {
+      period->saved = true;
+      if (period->mode.startsWith ("WSPR")) {
+        // the decoder is started on it straight away so it can't wait
+        // behind the writer
+        auto result = save_wave_file (*period);
+        if (!result.isEmpty ()) {
+          MessageBox::critical_message (this, tr("Error Writing WAV File"), result);
+        }
+      } else {
+        savePeriods ({*period});
+      }
     }
   }
 }
 
+void MainWindow::savePeriods (QList<PeriodRing::Period> const& periods)
+{
+  // one writer at a time so that every error is reported, periods
+  // asked for meanwhile wait for it to finish
+  m_periodsToSave << periods;
+  if (!m_savingPeriods) startPeriodWriter ();
+}
+
+void MainWindow::startPeriodWriter ()
+{
+  // the writer gets its own shallow copies, the samples are never
+  // modified after capture
+  auto periods = m_periodsToSave;
+  m_periodsToSave.clear ();
+  m_savingPeriods = true;
+  auto archive = m_saveArchive;
+  m_saveWAVWatcher.setFuture (QtConcurrent::run ([this, periods, archive] {
+        for (auto const& period : periods) {
+          auto result = write_period (period, archive);
+          if (!result.isEmpty ()) return result;
+        }
+        return QString {};
+      }));
+}
+
+QString MainWindow::write_period (PeriodRing::Period const& period, bool archive) const
+{
+  // runs in the writer thread too, see save_wave_file(), WSPR periods
+  // are always WAV files as wsprd reads them
+  return archive && !period.mode.startsWith ("WSPR")
+    ? save_archive_period (period) : save_wave_file (period);
+}
+
 void MainWindow::on_EraseButton_clicked ()
 {
   qint64 ms=QDateTime::currentMSecsSinceEpoch();
@@ -3127,9 +3448,9 @@ void MainWindow::on_EraseButton_clicked ()
 
 void MainWindow::band_activity_cleared ()
 {
+  m_decodeHistory.clear ();
   m_messageClient->clear_decodes ();
-  QFile f(m_config.temp_dir ().absoluteFilePath ("decoded.txt"));
-  if(f.exists()) f.remove();
+  jt9_shared_data ()->results.ndecodes=0;
 }
 
 void MainWindow::rx_frequency_activity_cleared ()
@@ -3259,18 +3580,49 @@ void MainWindow::guiUpdate()
       tx_watchdog (true);       // disable transmit
     }
 
+// Assert PTT ahead of an automatic Tx period so audio can start on time
+    bool bTxLead=false;
+    int pttLead=m_config.pttLead();
+    if(m_auto and !m_bTxTime and !m_tune and pttLead>0 and !m_bFastMode
+       and !m_mode.startsWith ("WSPR") and m_mode!="Echo") {
+      double t2pLead=fmod(tsec+0.001*pttLead,2*m_TRperiod);
+      bTxLead=(t2pLead >= tx1) and (t2pLead < tx2);
+    }
+
     float fTR=float((nsec%m_TRperiod))/m_TRperiod;
 //    if(g_iptt==0 and ((m_bTxTime and fTR<0.4) or m_tune )) {
-    if(g_iptt==0 and ((m_bTxTime and fTR<99) or m_tune )) {   //### Allow late starts
+    if(g_iptt==0 and (((m_bTxTime or bTxLead) and fTR<99) or m_tune )) {   //### Allow late starts
       icw[0]=m_ncw;
       g_iptt = 1;
       setRig ();
       setXIT (ui->TxFreqSpinBox->value ());
 
+      m_txLeadMs=bTxLead ? pttLead : 0;
+      Q_EMIT txPttLead (m_txLeadMs);   // queued ahead of sendMessage
       Q_EMIT m_config.transceiver_ptt (true);            //Assert the PTT
       m_tx_when_ready = true;
     }
-    if(!m_bTxTime and !m_tune) m_btxok=false;       //Time to stop transmitting
+    if(!m_bTxTime and !m_tune and !bTxLead) m_btxok=false;       //Time to stop transmitting
+  }
+
+// Tell CAT when the next Tx starts so rig polls keep clear of the PTT command
+  qint64 nextTxMs=0;
+  if(m_auto and !m_transmitting and g_iptt==0 and !m_tune and m_mode!="Echo") {
+    qint64 now=QDateTime::currentMSecsSinceEpoch();
+    if(m_mode.startsWith ("WSPR")) {
+      if((m_WSPR_tx_next and m_pctx>0) or m_txNext or m_pctx==100) {
+        qint64 period=1000*m_TRperiod;
+        nextTxMs=now - now%period + period;         //WSPR Tx starts at a period boundary
+      }
+    } else {
+      qint64 cycle=2000*m_TRperiod;
+      nextTxMs=now - now%cycle + qint64(1000*tx1) - m_config.pttLead();
+      if(nextTxMs<=now) nextTxMs+=cycle;
+    }
+  }
+  if(nextTxMs!=m_nextTxMs) {
+    m_nextTxMs=nextTxMs;
+    m_config.transceiver_next_tx (m_nextTxMs);
   }
 
   if(m_mode.startsWith ("WSPR") and
@@ -5110,8 +5462,6 @@ void MainWindow::on_actionQRA64_triggered()
   ui->sbSubmode->setValue(m_nSubMode);
   ui->actionInclude_averaging->setVisible (false);
   ui->actionInclude_correlation->setVisible (false);
-  QString fname {QDir::toNativeSeparators(m_config.temp_dir ().absoluteFilePath ("red.dat"))};
-  m_wideGraph->setRedFile(fname);
   QFile f(m_appDir + "/old_qra_sync");
   if(f.exists() and !m_bQRAsyncWarned) {
     MessageBox::warning_message (this, tr ("***  WARNING  *** "),
@@ -6449,31 +6799,11 @@ void MainWindow::replayDecodes ()
   // we accept this request even if the setting to accept UDP requests
   // is not checked
 
-  // attempt to parse the decoded text
-  Q_FOREACH (auto const& message
-             , ui->decodedTextBrowser->toPlainText ().split (QChar::LineFeed,
-                                                             QString::SkipEmptyParts))
-    {
-      if (message.size() >= 4 && message.left (4) != "----")
-        {
-          auto const& parts = message.split (' ', QString::SkipEmptyParts);
-          if (parts.size () >= 5 && parts[3].contains ('.')) // WSPR
-            {
-              postWSPRDecode (false, parts);
-            }
-          else
-            {
-              auto eom_pos = message.indexOf (' ', 35);
-              // we always want at least the characters to position 35
-              if (eom_pos < 35)
-                {
-                  eom_pos = message.size () - 1;
-                }
-              // TODO - how to skip ISCAT decodes
-              postDecode (false, message.left (eom_pos + 1));
-            }
-        }
-    }
+  // replay from the decode history, no need to parse the decoded text
+  m_decodeHistory.for_each ([this] (DecodeHistory::Record const& record) {
+      sendDecode (false, record);
+    });
+  m_messageClient->flush_decodes ();
   statusChanged ();
 }
 
@@ -6484,13 +6814,15 @@ void MainWindow::postDecode (bool is_new, QString const& message)
   if (parts.size () >= 5)
     {
       auto has_seconds = parts[0].size () > 4;
-      m_messageClient->decode (is_new
-                               , QTime::fromString (parts[0], has_seconds ? "hhmmss" : "hhmm")
-                               , parts[1].toInt ()
-                               , parts[2].toFloat (), parts[3].toUInt (), parts[4]
-                               , decode.mid (has_seconds ? 24 : 22, 21)
-                               , QChar {'?'} == decode.mid (has_seconds ? 24 + 21 : 22 + 21, 1)
-                               , m_diskData);
+      DecodeHistory::Record record {false
+          , QTime::fromString (parts[0], has_seconds ? "hhmmss" : "hhmm")
+          , parts[1].toInt ()
+          , parts[2].toFloat (), parts[3].toUInt (), parts[4]
+          , decode.mid (has_seconds ? 24 : 22, 21)
+          , QChar {'?'} == decode.mid (has_seconds ? 24 + 21 : 22 + 21, 1)
+          , 0u, 0, QString {}, QString {}, 0};
+      if (is_new) m_decodeHistory.append (record);
+      sendDecode (is_new, record);
     }
 }
 
@@ -6500,10 +6832,28 @@ void MainWindow::postWSPRDecode (bool is_new, QStringList parts)
     {
       parts.insert (6, "");
     }
-  m_messageClient->WSPR_decode (is_new, QTime::fromString (parts[0], "hhmm"), parts[1].toInt ()
-                                , parts[2].toFloat (), Radio::frequency (parts[3].toFloat (), 6)
-                                , parts[4].toInt (), parts[5], parts[6], parts[7].toInt ()
-                                , m_diskData);
+  DecodeHistory::Record record {true, QTime::fromString (parts[0], "hhmm"), parts[1].toInt ()
+      , parts[2].toFloat (), 0u, QString {}, QString {}, false
+      , Radio::frequency (parts[3].toFloat (), 6)
+      , parts[4].toInt (), parts[5], parts[6], parts[7].toInt ()};
+  if (is_new) m_decodeHistory.append (record);
+  sendDecode (is_new, record);
+}
+
+void MainWindow::sendDecode (bool is_new, DecodeHistory::Record const& record)
+{
+  if (record.is_WSPR)
+    {
+      m_messageClient->WSPR_decode (is_new, record.time, record.snr, record.delta_time
+                                    , record.frequency, record.drift, record.callsign
+                                    , record.grid, record.power, m_diskData);
+    }
+  else
+    {
+      m_messageClient->decode (is_new, record.time, record.snr, record.delta_time
+                               , record.delta_frequency, record.mode, record.message
+                               , record.low_confidence, m_diskData);
+    }
 }
 
 void MainWindow::networkError (QString const& e)
@@ -6543,7 +6893,7 @@ void MainWindow::p1ReadFromStdout()                        //p1readFromStdout
           t=WSPR_hhmm(-60) + ' ' + t.rightJustified (66, '-');
           ui->decodedTextBrowser->appendText(t);
         }
-        killFileTimer.start (45*1000); //Kill in 45s (for slow modes)
+        savePolicyTimer.start (45*1000); //Decide in 45s (for slow modes)
       }
       m_nWSPRdecodes=0;
       ui->DecodeButton->setChecked (false);
@@ -6783,9 +7133,15 @@ void MainWindow::astroUpdate ()
                                                    m_freqNominal,
                                                    "Echo" == m_mode, m_transmitting,
                                                    !m_config.tx_QSY_allowed (), m_TRperiod);
-      // no Doppler correction in Tx if rig can't do it
-      if (m_transmitting && !m_config.tx_QSY_allowed ()) return;
+      // no Doppler correction in Tx if rig can't do it, the audio
+      // still follows from the correction it was left with
+      if (m_transmitting && !m_config.tx_QSY_allowed ())
+        {
+          if (m_astroWidget->doppler_tracking ()) audioDoppler (correction);
+          return;
+        }
       if (!m_astroWidget->doppler_tracking ()) return;
+      auto previous = m_astroCorrection;
       if ((m_monitoring || m_transmitting)
           // no Doppler correction below 6m
           && m_freqNominal >= 50000000
@@ -6822,14 +7178,37 @@ void MainWindow::astroUpdate ()
               correction.rx = correction.rx / 10 * 10;
               correction.tx = correction.tx / 10 * 10;
             }
+          if (m_dopplerRetune > 0)
+            {
+              // leave the rig alone until the audio would have to
+              // shift more than m_dopplerRetune
+              if (qAbs (correction.rx - previous.rx) < m_dopplerRetune) correction.rx = previous.rx;
+              if (qAbs (correction.tx - previous.tx) < m_dopplerRetune) correction.tx = previous.tx;
+            }
           m_astroCorrection = correction;
+          audioDoppler (correction);
         }
       else
         {
           m_astroCorrection = {};
+          audioDoppler ({});
         }
 
-      setRig ();
+      // CAT only when something changed, or every second without
+      // audio correction as before
+      if (m_astroCorrection != previous || m_dopplerRetune <= 0) setRig ();
+    }
+}
+
+void MainWindow::audioDoppler (Astro::Correction const& exact)
+{
+  // what CAT has not corrected is removed from the Rx audio and
+  // added to the Tx audio, sweeping with the Doppler rate rather than
+  // stepping each second
+  if (m_dopplerRetune > 0)
+    {
+      Q_EMIT rxDopplerShift (m_astroCorrection.rx - exact.rx_exact, -exact.rx_rate);
+      Q_EMIT txDopplerShift (exact.tx_exact - m_astroCorrection.tx, exact.tx_rate);
     }
 }
 
@@ -7057,7 +7436,7 @@ void MainWindow::write_transmit_entry (QString const& file_name)
   if (f.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Append))
     {
       QTextStream out(&f);
-      auto time = QDateTime::currentDateTimeUtc ();
+      auto time = QDateTime::currentDateTimeUtc ().addMSecs (m_txLeadMs); // may be early
       time = time.addSecs (-(time.time ().second () % m_TRperiod));
       out << time.toString("yyMMdd_hhmmss")
           << "  Transmitting " << qSetRealNumberPrecision (12) << (m_freqNominal / 1.e6)
@@ -35,6 +35,9 @@
 #include "logbook/logbook.h"
 #include "commons.h"
 #include "astro.h"
+#include "DecodeHistory.hpp"
+#include "PeriodRing.hpp"
+#include "FastDecodeJob.hpp"
 #include "MessageBox.hpp"
 #include "NetworkAccessManager.hpp"
 
@@ -147,6 +150,7 @@ private slots:
   void on_actionOpen_log_directory_triggered ();
   void on_actionNone_triggered();
   void on_actionSave_all_triggered();
+  void on_actionSave_recent_triggered();
   void on_actionKeyboard_shortcuts_triggered();
   void on_actionSpecial_mouse_commands_triggered();
   void on_actionSolve_FreqCal_triggered();
@@ -212,7 +216,7 @@ private slots:
   void on_rbFreeText_clicked(bool checked);
   void on_freeTextMsg_currentTextChanged (QString const&);
   void on_rptSpinBox_valueChanged(int n);
-  void killFile();
+  void applySavePolicy();
   void on_tuneButton_clicked (bool);
   void on_pbR2T_clicked();
   void on_pbT2R_clicked();
@@ -344,6 +348,9 @@ private:
   Q_SIGNAL void detectorClose () const;
   Q_SIGNAL void finished () const;
   Q_SIGNAL void transmitFrequency (double) const;
+  Q_SIGNAL void rxDopplerShift (double hertz, double rate) const;
+  Q_SIGNAL void txDopplerShift (double hertz, double rate) const;
+  Q_SIGNAL void txPttLead (int ms) const;
   Q_SIGNAL void endTransmitMessage (bool quick = false) const;
   Q_SIGNAL void tune (bool = true) const;
   Q_SIGNAL void sendMessage (unsigned symbolsLength, double framesPerSymbol,
@@ -402,11 +409,16 @@ private:
   QThread m_audioThread;
 
   qint64  m_msErase;
+  qint64  m_nextTxMs;                   // advised to CAT, 0 if none
+  qint32  m_txLeadMs;                   // PTT lead used by this Tx, ms
   qint64  m_secBandChanged;
   qint64  m_freqMoon;
   Frequency m_freqNominal;
   Frequency m_freqTxNominal;
   Astro::Correction m_astroCorrection;
+  int     m_dopplerRetune;      // Hz left to the audio before the rig is retuned
+  int     m_decoderProfile;     // jt9 -P trace depth, 0 when not profiling
+  int     m_decodeBudget;       // % of the T/R period a decode may take, 0 no limit
 
   double  m_s6;
   double  m_tRemaining;
@@ -465,6 +477,7 @@ private:
   bool    m_startAnother;
   bool    m_saveDecoded;
   bool    m_saveAll;
+  bool    m_saveArchive;        // saved periods go to the day's archive segment
   bool    m_widebandDecode;
   bool    m_call3Modified;
   bool    m_dataAvailable;
@@ -533,7 +546,9 @@ private:
   double	m_onAirFreq0;
   bool		m_first_error;
 
-  char    m_msg[100][80];
+  QVector<short> m_fastSamples; // snapshot shared by fast decode jobs
+  int     m_fastSamplesKin;     // samples captured when it was taken
+  QStringList m_fastDecodes;    // lines not yet displayed
 
   // labels in status bar
   QLabel tx_status_label;
@@ -547,8 +562,9 @@ private:
 
   QFuture<void> m_wav_future;
   QFutureWatcher<void> m_wav_future_watcher;
-  QFutureWatcher<void> watcher3;
   QFutureWatcher<QString> m_saveWAVWatcher;
+  QList<PeriodRing::Period> m_periodsToSave; // waiting for the writer
+  bool m_savingPeriods;
 
   QProcess proc_jt9;
   QProcess p1;
@@ -560,7 +576,7 @@ private:
   QTimer ptt1Timer;                 //StartTx delay
   QTimer ptt0Timer;                 //StopTx delay
   QTimer logQSOTimer;
-  QTimer killFileTimer;
+  QTimer savePolicyTimer;
   QTimer tuneButtonTimer;
   QTimer uploadTimer;
   QTimer tuneATU_Timer;
@@ -598,6 +614,8 @@ private:
 
   QSharedMemory *mem_jt9;
   LogBook m_logBook;
+  DecodeHistory m_decodeHistory;
+  PeriodRing m_periods;         // recent Rx periods, saved on demand
   QString m_QSOText;
   unsigned m_msAudioOutputBuffered;
   unsigned m_framesAudioInputBuffered;
@@ -654,11 +672,13 @@ private:
   void replayDecodes ();
   void postDecode (bool is_new, QString const& message);
   void postWSPRDecode (bool is_new, QStringList message_parts);
+  void sendDecode (bool is_new, DecodeHistory::Record const&);
   void enable_DXCC_entity (bool on);
   void switch_mode (Mode);
   void WSPR_scheduling ();
   void freqCalStep();
   void setRig (Frequency = 0);  // zero frequency means no change
+  void audioDoppler (Astro::Correction const&);
 
   void inputVFOFreq(int inputValue);        //for QRP with RPI by KD8CEC
   void mmMemoryProcess(int memoryIndex);
@@ -667,18 +687,20 @@ private:
   QString WSPR_hhmm(int n);
   void fast_config(bool b);
   void CQTxFreq();
-  QString save_wave_file (QString const& name
-                          , short const * data
-                          , int seconds
-                          , QString const& my_callsign
-                          , QString const& my_grid
-                          , QString const& mode
-                          , qint32 sub_mode
-                          , Frequency frequency
-                          , QString const& his_call
-                          , QString const& his_grid) const;
+  QString save_wave_file (PeriodRing::Period const&) const;
+  QString save_archive_period (PeriodRing::Period const&) const;
+  QString write_period (PeriodRing::Period const&, bool archive) const;
+  void retainPeriod (QDateTime const& start);
+  QVector<short> fastSnapshot ();
+  void savePeriods (QList<PeriodRing::Period> const&);
+  void startPeriodWriter ();
+  void savePeriod (QString const& name);
   void read_wav_file (QString const& fname);
+  int read_archive_period (QString const& segment, int n);
+  struct dec_data * jt9_shared_data () const;
   void decodeDone ();
+  void sendDecoderStats ();
+  void showSkippedStages (int skipped);
   void subProcessFailed (QProcess *, int exit_code, QProcess::ExitStatus);
   void subProcessError (QProcess *, QProcess::ProcessError);
   void statusUpdate () const;
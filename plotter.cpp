@@ -3,8 +3,6 @@
 #include <QDebug>
 #include "commons.h"
 #include "moc_plotter.cpp"
-#include <fstream>
-#include <iostream>
 
 #define MAX_SCREENSIZE 2048
 
@@ -35,7 +33,8 @@ CPlotter::CPlotter(QWidget *parent) :                  //CPlotter Constructor
   m_Percent2DScreen0 {0},
   m_rxFreq {1020},
   m_txFreq {0},
-  m_startFreq {0}
+  m_startFreq {0},
+  m_waterfallTop {0}
 {
   setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
   setFocusPolicy(Qt::StrongFocus);
@@ -85,10 +84,11 @@ void CPlotter::resizeEvent(QResizeEvent* )                    //resizeEvent()
     m_h1=m_h-m_h2;
     m_2DPixmap = QPixmap(m_Size.width(), m_h2);
     m_2DPixmap.fill(Qt::black);
-    m_WaterfallPixmap = QPixmap(m_Size.width(), m_h1);
+    m_WaterfallImage = QImage(m_Size.width(), m_h1, QImage::Format_RGB32);
+    m_waterfallTop = 0;
     m_OverlayPixmap = QPixmap(m_Size.width(), m_h2);
     m_OverlayPixmap.fill(Qt::black);
-    m_WaterfallPixmap.fill(Qt::black);
+    m_WaterfallImage.fill(Qt::black);
     m_2DPixmap.fill(Qt::black);
     m_ScalePixmap = QPixmap(m_w,15);
     m_ScalePixmap.fill(Qt::gray);
@@ -103,7 +103,12 @@ void CPlotter::paintEvent(QPaintEvent *)                                // paint
   m_paintEventBusy=true;
   QPainter painter(this);
   painter.drawPixmap(0,0,m_ScalePixmap);
-  painter.drawPixmap(0,15,m_WaterfallPixmap);
+  // the waterfall ring is unrolled from the newest row down
+  int h_top = m_WaterfallImage.height() - m_waterfallTop;
+  painter.drawImage(0, 15, m_WaterfallImage, 0, m_waterfallTop, -1, h_top);
+  if(m_waterfallTop > 0) {
+    painter.drawImage(0, 15 + h_top, m_WaterfallImage, 0, 0, -1, m_waterfallTop);
+  }
   painter.drawPixmap(0,m_h1,m_2DPixmap);
   m_paintEventBusy=false;
 }
@@ -120,9 +125,9 @@ void CPlotter::draw(float swide[], bool bScroll, bool bRed)
   if(m_bReference != m_bReference0) resizeEvent(NULL);
   m_bReference0=m_bReference;
 
-//move current data down one line (must do this before attaching a QPainter object)
-  if(bScroll) m_WaterfallPixmap.scroll(0,1,0,0,m_w,m_h1);
-  QPainter painter1(&m_WaterfallPixmap);
+//move current data down one line by stepping back the top of the ring
+  if(m_WaterfallImage.isNull()) return;
+  if(bScroll) m_waterfallTop = (m_waterfallTop + m_h1 - 1) % m_h1;
   m_2DPixmap = m_OverlayPixmap.copy(0,0,m_w,m_h2);
   QPainter painter2D(&m_2DPixmap);
   if(!painter2D.isActive()) return;
@@ -153,16 +158,23 @@ void CPlotter::draw(float swide[], bool bScroll, bool bRed)
   }
 
   ymin=1.e30;
-  if(swide[0]>1.e29 and swide[0]< 1.5e30) painter1.setPen(Qt::green);
-  if(swide[0]>1.4e30) painter1.setPen(Qt::yellow);
-  for(int i=0; i<iz; i++) {
+  // marker lines keep the last colour used, as a pen would
+  QRgb colour=qRgb(0,0,0);
+  if(swide[0]>1.e29 and swide[0]< 1.5e30) colour=qRgb(0,255,0);
+  if(swide[0]>1.4e30) colour=qRgb(255,255,0);
+  auto * row = reinterpret_cast<QRgb *> (m_WaterfallImage.scanLine(m_waterfallTop));
+  int nx=qMin(iz,m_WaterfallImage.width());
+  for(int i=0; i<nx; i++) {
     y=swide[i];
     if(y<ymin) ymin=y;
     int y1 = 10.0*gain*y + 10*m_plotZero +40;
     if (y1<0) y1=0;
     if (y1>254) y1=254;
-    if (swide[i]<1.e29) painter1.setPen(g_ColorTbl[y1]);
-    painter1.drawPoint(i,0);
+    if (y<1.e29 and y1<m_ColorLut.size()) colour=m_ColorLut[y1];
+    row[i]=colour;
+  }
+  for(int i=nx; i<iz; i++) {
+    if(swide[i]<ymin) ymin=swide[i];
   }
 
   float y2min=1.e30;
@@ -215,8 +227,7 @@ void CPlotter::draw(float swide[], bool bScroll, bool bRed)
   }
 
   if(swide[0]>1.0e29) m_line=0;
-  if(m_line == painter1.fontMetrics ().height ()) {
-    painter1.setPen(Qt::white);
+  if(m_line == fontMetrics ().height ()) {
     QString t;
     qint64 ms = QDateTime::currentMSecsSinceEpoch() % 86400000;
     int n=(ms/1000) % m_TRperiod;
@@ -226,7 +237,10 @@ void CPlotter::draw(float swide[], bool bScroll, bool bRed)
     } else {
       t=t1.toString("hh:mm") + "    " + m_rxBand;
     }
-    painter1.drawText (5, painter1.fontMetrics ().ascent (), t);
+    paintWaterfallTop (fontMetrics ().height (), [&t] (QPainter& painter) {
+        painter.setPen(Qt::white);
+        painter.drawText (5, painter.fontMetrics ().ascent (), t);
+      });
   }
 
   if(m_mode=="JT4" or m_mode=="QRA64") {
@@ -246,28 +260,24 @@ void CPlotter::draw(float swide[], bool bScroll, bool bRed)
   }
 
     if(bRed) {
-      std::ifstream f;
-      f.open(m_redFile.toLatin1());
-      if(f) {
-        int x,y;
-        float freq,sync;
+      // QRA64 sync curve left by the decoder
+      if(dec_data.results.nred > 0) {
         float slimit=6.0;
-        QPen pen0(Qt::red,1);
-        painter1.setPen(pen0);
-        for(int i=0; i<99999; i++) {
-          f >> freq >> sync;
-          if(f.eof()) break;
-          x=XfromFreq(freq);
-          y=(sync-slimit)*3.0;
+        QVector<QLine> lines;
+        for(int i=0; i<dec_data.results.nred; i++) {
+          float freq=dec_data.results.fred + i*dec_data.results.dfred;
+          float sync=dec_data.sred[i];
+          int x=XfromFreq(freq);
+          int y=(sync-slimit)*3.0;
           if(y>0) {
-            if(y>15.0) y=15.0;
-            if(x>=0 and x<=m_w) {
-              painter1.setPen(pen0);
-              painter1.drawLine(x,0,x,y);
-            }
+            if(y>15) y=15;
+            if(x>=0 and x<=m_w) lines << QLine {x,0,x,y};
           }
         }
-        f.close();
+        paintWaterfallTop (16, [&lines] (QPainter& painter) {
+            painter.setPen(QPen {Qt::red,1});
+            painter.drawLines(lines);
+          });
       }
 //      m_bDecodeFinished=false;
     }
@@ -276,6 +286,21 @@ void CPlotter::draw(float swide[], bool bScroll, bool bRed)
   m_bScaleOK=true;
 }
 
+// paint over the newest rows of the waterfall, the ring may wrap
+// inside them so paint both pieces as required
+template<typename F>
+void CPlotter::paintWaterfallTop (int height, F paint)
+{
+  QPainter painter(&m_WaterfallImage);
+  painter.setFont(font());
+  painter.translate(0, m_waterfallTop);
+  paint (painter);
+  if(m_waterfallTop + height > m_h1) {
+    painter.translate(0, -m_h1);
+    paint (painter);
+  }
+}
+
 void CPlotter::drawRed(int ia, int ib, float swide[])
 {
   m_ia=ia;
@@ -286,8 +311,8 @@ void CPlotter::drawRed(int ia, int ib, float swide[])
 void CPlotter::DrawOverlay()                   //DrawOverlay()
 {
   if(m_OverlayPixmap.isNull()) return;
-  if(m_WaterfallPixmap.isNull()) return;
-  int w = m_WaterfallPixmap.width();
+  if(m_WaterfallImage.isNull()) return;
+  int w = m_WaterfallImage.width();
   int x,y,x1,x2,x3,x4,x5,x6;
   float pixperdiv;
 
@@ -544,7 +569,7 @@ void CPlotter::MakeFrequencyStrs()                       //MakeFrequencyStrs
 
 int CPlotter::XfromFreq(float f)                               //XfromFreq()
 {
-//  float w = m_WaterfallPixmap.width();
+//  float w = m_WaterfallImage.width();
   int x = int(m_w * (f - m_startFreq)/m_fSpan + 0.5);
   if(x<0 ) return 0;
   if(x>m_w) return m_w;
@@ -614,7 +639,7 @@ int CPlotter::startFreq()                              //startFreq()
   return m_startFreq;
 }
 
-int CPlotter::plotWidth(){return m_WaterfallPixmap.width();}     //plotWidth
+int CPlotter::plotWidth(){return m_WaterfallImage.width();}     //plotWidth
 void CPlotter::UpdateOverlay() {DrawOverlay();}                  //UpdateOverlay
 void CPlotter::setDataFromDisk(bool b) {m_dataFromDisk=b;}       //setDataFromDisk
 
@@ -758,6 +783,10 @@ void CPlotter::setTol(int n)                                 //setTol()
 void CPlotter::setColours(QVector<QColor> const& cl)
 {
   g_ColorTbl = cl;
+  m_ColorLut.resize(cl.size());
+  for(int i=0; i<cl.size(); i++) {
+    m_ColorLut[i]=cl[i].rgb();
+  }
 }
 
 void CPlotter::SetPercent2DScreen(int percent)
@@ -770,8 +799,3 @@ void CPlotter::setVHF(bool bVHF)
 {
   m_bVHF=bVHF;
 }
-
-void CPlotter::setRedFile(QString fRed)
-{
-  m_redFile=fRed;
-}
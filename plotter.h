@@ -84,7 +84,6 @@ public:
   bool Reference() const {return m_bReference;}
   void drawRed(int ia, int ib, float swide[]);
   void setVHF(bool bVHF);
-  void setRedFile(QString fRed);
   bool scaleOK () const {return m_bScaleOK;}
 signals:
   void freezeDecode1(int n);
@@ -101,6 +100,7 @@ private:
 
   void MakeFrequencyStrs();
   int XfromFreq(float f);
+  template<typename F> void paintWaterfallTop (int height, F paint);
   float FreqfromX(int x);
 
   QAction * m_set_freq_action;
@@ -127,7 +127,12 @@ private:
   qint32  m_ia;
   qint32  m_ib;
 
-  QPixmap m_WaterfallPixmap;
+  // waterfall rows are written straight into a ring of scan lines,
+  // m_waterfallTop is the row holding the newest spectrum so
+  // scrolling is just a change of offset
+  QImage  m_WaterfallImage;
+  qint32  m_waterfallTop;
+  QVector<QRgb> m_ColorLut;     // palette as ARGB values
   QPixmap m_2DPixmap;
   QPixmap m_ScalePixmap;
   QPixmap m_OverlayPixmap;
@@ -138,7 +143,6 @@ private:
   QString m_mode;
   QString m_modeTx;
   QString m_rxBand;
-  QString m_redFile;
 
   bool    m_Running;
   bool    m_paintEventBusy;
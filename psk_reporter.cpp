@@ -7,6 +7,8 @@
 
 #include <QHostInfo>
 #include <QTimer>
+#include <QDateTime>
+#include <QDataStream>
 
 #include "MessageClient.hpp"
 
@@ -15,35 +17,55 @@
 namespace
 {
   int constexpr MAX_PAYLOAD_LENGTH {1400};
+  int constexpr SET_HEADER_LENGTH {4};
+  int constexpr SET_PADDING_LENGTH {2};
+
+  // IPFIX variable length field, single byte length prefix
+  void write_string (QDataStream& out, QString const& s)
+  {
+    auto const& utf = s.toUtf8 ();
+    out << quint8 (utf.size ());
+    out.writeRawData (utf.constData (), utf.size ());
+  }
+
+  int string_length (QString const& s)
+  {
+    return 1 + s.toUtf8 ().size ();
+  }
+
+  // set lengths are written after the content, the buffer is always
+  // big endian as IPFIX requires
+  void set_length (QByteArray& buffer, int offset, int length)
+  {
+    buffer[offset] = static_cast<char> ((length >> 8) & 0xff);
+    buffer[offset + 1] = static_cast<char> (length & 0xff);
+  }
 }
 
 PSK_Reporter::PSK_Reporter(MessageClient * message_client, QObject *parent) :
     QObject {parent},
+    m_observationId {static_cast<quint32> (qrand ())},
+    m_dedupWindow {5 * 60},
     m_messageClient {message_client},
     reportTimer {new QTimer {this}},
     m_sequenceNumber {0}
 {
-    m_header_h = "000Allllttttttttssssssssiiiiiiii";
-
     // We use 50E2 and 50E3 for link Id
-    m_rxInfoDescriptor_h = "0003002C50E200040000"
-                           "8002FFFF0000768F"     // 2. Rx Call
-                           "8004FFFF0000768F"     // 4. Rx Grid
-                           "8008FFFF0000768F"     // 8. Rx Soft
-                           "8009FFFF0000768F"     // 9. Rx Antenna
-                           "0000";
-
-    m_txInfoDescriptor_h = "0002003C50E30007"
-                           "8001FFFF0000768F" // 1. Tx Call
-                           "800500040000768F" // 5. Tx Freq
-                           "800600010000768F" // 6. Tx snr
-                           "800AFFFF0000768F" // 10. Tx Mode
-                           "8003FFFF0000768F" // 3. Tx Grid
-                           "800B00010000768F" // 11. Tx info src
-                           "00960004";        // Report time
-
-
-    m_randomId_h = QString("%1").arg(qrand(),8,16,QChar('0'));
+    m_rxInfoDescriptor = QByteArray::fromHex ("0003002C50E200040000"
+                                              "8002FFFF0000768F"     // 2. Rx Call
+                                              "8004FFFF0000768F"     // 4. Rx Grid
+                                              "8008FFFF0000768F"     // 8. Rx Soft
+                                              "8009FFFF0000768F"     // 9. Rx Antenna
+                                              "0000");
+
+    m_txInfoDescriptor = QByteArray::fromHex ("0002003C50E30007"
+                                              "8001FFFF0000768F" // 1. Tx Call
+                                              "800500040000768F" // 5. Tx Freq
+                                              "800600010000768F" // 6. Tx snr
+                                              "800AFFFF0000768F" // 10. Tx Mode
+                                              "8003FFFF0000768F" // 3. Tx Grid
+                                              "800B00010000768F" // 11. Tx info src
+                                              "00960004");       // Report time
 
     QHostInfo::lookupHost("report.pskreporter.info", this, SLOT(dnsLookupResult(QHostInfo)));
 
@@ -59,58 +81,88 @@ void PSK_Reporter::setLocalStation(QString call, QString gridSquare, QString ant
   m_progId = programInfo;
 }
 
-void PSK_Reporter::addRemoteStation(QString call, QString grid, QString freq, QString mode, QString snr, QString time )
+void PSK_Reporter::addRemoteStation(QString const& call, QString const& grid, Radio::Frequency freq
+                                    , QString const& band, QString const& mode, int snr, uint time)
 {
-    QHash<QString,QString> spot;
-    spot["call"] = call;
-    spot["grid"] = grid;
-    spot["snr"] = snr;
-    spot["freq"] = freq;
-    spot["mode"] = mode;
-    spot["time"] = time;
-    m_spotQueue.enqueue(spot);
+  // a station calling CQ for an hour is only worth reporting once in
+  // a while on each band and mode
+  auto const& key = call + '|' + band + '|' + mode;
+  auto last = m_lastSpotted.find (key);
+  if (last != m_lastSpotted.end () && time - *last < m_dedupWindow)
+    {
+      return;
+    }
+  m_lastSpotted[key] = time;
+  m_spotQueue.enqueue ({call, grid, freq, mode, snr, time});
 }
 
 void PSK_Reporter::sendReport()
 {
+  // forget spots that have aged out of the deduplication window
+  auto now = QDateTime::currentDateTime ().toTime_t ();
+  for (auto iter = m_lastSpotted.begin (); iter != m_lastSpotted.end (); )
+    {
+      if (now - *iter >= m_dedupWindow)
+        {
+          iter = m_lastSpotted.erase (iter);
+        }
+      else
+        {
+          ++iter;
+        }
+    }
+
   while (!m_spotQueue.isEmpty()) {
-    QString report_h;
+    QByteArray report;
+    report.reserve (MAX_PAYLOAD_LENGTH);
+    QDataStream out {&report, QIODevice::WriteOnly};
 
-    // Header
-    QString header_h = m_header_h;
-    header_h.replace("tttttttt", QString("%1").arg(QDateTime::currentDateTime().toTime_t(),8,16,QChar('0')));
-    header_h.replace("ssssssss", QString("%1").arg(++m_sequenceNumber,8,16,QChar('0')));
-    header_h.replace("iiiiiiii", m_randomId_h);
+    // Header, length is filled in at the end
+    out << quint16 (0x000A) << quint16 (0)
+        << quint32 (QDateTime::currentDateTime().toTime_t())
+        << quint32 (++m_sequenceNumber)
+        << m_observationId;
 
-    // Receiver information
-    QString rxInfoData_h = "50E2llll";
-    rxInfoData_h += QString("%1").arg(m_rxCall.length(),2,16,QChar('0')) + m_rxCall.toUtf8().toHex();
-    rxInfoData_h += QString("%1").arg(m_rxGrid.length(),2,16,QChar('0')) + m_rxGrid.toUtf8().toHex();
-    rxInfoData_h += QString("%1").arg(m_progId.length(),2,16,QChar('0')) + m_progId.toUtf8().toHex();
-    rxInfoData_h += QString("%1").arg(m_rxAnt.length(),2,16,QChar('0')) + m_rxAnt.toUtf8().toHex();
-    rxInfoData_h += "0000";
-    rxInfoData_h.replace("50E2llll", "50E2" + QString("%1").arg(rxInfoData_h.length()/2,4,16,QChar('0')));
-
-    // Sender information
-    QString txInfoData_h = "50E3llll";
-    while (!m_spotQueue.isEmpty()
-           && (header_h.size () + m_rxInfoDescriptor_h.size () + m_txInfoDescriptor_h.size () + rxInfoData_h.size () + txInfoData_h.size ()) / 2 < MAX_PAYLOAD_LENGTH) {
-      QHash<QString,QString> spot = m_spotQueue.dequeue();
-      txInfoData_h += QString("%1").arg(spot["call"].length(),2,16,QChar('0')) + spot["call"].toUtf8().toHex();
-      txInfoData_h += QString("%1").arg(spot["freq"].toLongLong(),8,16,QChar('0'));
-      txInfoData_h += QString("%1").arg(spot["snr"].toInt(),8,16,QChar('0')).right(2);
-      txInfoData_h += QString("%1").arg(spot["mode"].length(),2,16,QChar('0')) + spot["mode"].toUtf8().toHex();
-      txInfoData_h += QString("%1").arg(spot["grid"].length(),2,16,QChar('0')) + spot["grid"].toUtf8().toHex();
-      txInfoData_h += QString("%1").arg(1,2,16,QChar('0')); // REPORTER_SOURCE_AUTOMATIC
-      txInfoData_h += QString("%1").arg(spot["time"].toInt(),8,16,QChar('0'));
-    }
-    txInfoData_h += "0000";
-    txInfoData_h.replace("50E3llll", "50E3" + QString("%1").arg(txInfoData_h.length()/2,4,16,QChar('0')));
-    report_h = header_h + m_rxInfoDescriptor_h + m_txInfoDescriptor_h + rxInfoData_h + txInfoData_h;
-    //qDebug() << "Sending Report TX: ";
+    out.writeRawData (m_rxInfoDescriptor.constData (), m_rxInfoDescriptor.size ());
+    out.writeRawData (m_txInfoDescriptor.constData (), m_txInfoDescriptor.size ());
 
-    report_h.replace("000Allll", "000A" + QString("%1").arg(report_h.length()/2,4,16,QChar('0')));
-    QByteArray report = QByteArray::fromHex(report_h.toUtf8());
+    // Receiver information
+    auto set_offset = report.size ();
+    out << quint16 (0x50E2) << quint16 (0);
+    write_string (out, m_rxCall);
+    write_string (out, m_rxGrid);
+    write_string (out, m_progId);
+    write_string (out, m_rxAnt);
+    out << quint16 (0);
+    set_length (report, set_offset + 2, report.size () - set_offset);
+
+    // Sender information, as many spots as will fit without
+    // exceeding the maximum payload
+    set_offset = report.size ();
+    out << quint16 (0x50E3) << quint16 (0);
+    do
+      {
+        auto const& spot = m_spotQueue.head ();
+        auto spot_length = string_length (spot.call) + 4 + 1 + string_length (spot.mode)
+          + string_length (spot.grid) + 1 + 4;
+        if (report.size () > set_offset + SET_HEADER_LENGTH // always send at least one
+            && report.size () + spot_length + SET_PADDING_LENGTH > MAX_PAYLOAD_LENGTH)
+          {
+            break;
+          }
+        write_string (out, spot.call);
+        out << quint32 (spot.freq);
+        out << quint8 (spot.snr);
+        write_string (out, spot.mode);
+        write_string (out, spot.grid);
+        out << quint8 (1);          // REPORTER_SOURCE_AUTOMATIC
+        out << quint32 (spot.time);
+        m_spotQueue.dequeue ();
+      }
+    while (!m_spotQueue.isEmpty ());
+    out << quint16 (0);
+    set_length (report, set_offset + 2, report.size () - set_offset);
+    set_length (report, 2, report.size ());
 
     // Send data to PSK Reporter site
     if (!m_pskReporterAddress.isNull()) {
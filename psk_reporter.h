@@ -4,10 +4,13 @@
 
 #include <QObject>
 #include <QString>
+#include <QByteArray>
 #include <QHostAddress>
 #include <QQueue>
 #include <QHash>
 
+#include "Radio.hpp"
+
 class MessageClient;
 class QTimer;
 class QHostInfo;
@@ -18,8 +21,13 @@ class PSK_Reporter : public QObject
 public:
   explicit PSK_Reporter(MessageClient *, QObject *parent = nullptr);
     void setLocalStation(QString call, QString grid, QString antenna, QString programInfo);
-    void addRemoteStation(QString call, QString grid, QString freq, QString mode, QString snr, QString time);
-    
+
+    // spots of the same call on the same band and mode are only
+    // queued once per deduplication window
+    void addRemoteStation(QString const& call, QString const& grid, Radio::Frequency freq
+                          , QString const& band, QString const& mode, int snr, uint time);
+    void setDeduplicationWindow (uint seconds) {m_dedupWindow = seconds;}
+
 signals:
     
 public slots:
@@ -29,11 +37,19 @@ private slots:
     void dnsLookupResult(QHostInfo info);
 
 private:
-    QString m_header_h;
-    QString m_rxInfoDescriptor_h;
-    QString m_txInfoDescriptor_h;
-    QString m_randomId_h;
-    QString m_linkId_h;
+    struct Spot
+    {
+      QString call;
+      QString grid;
+      Radio::Frequency freq;
+      QString mode;
+      int snr;
+      uint time;
+    };
+
+    QByteArray m_rxInfoDescriptor;
+    QByteArray m_txInfoDescriptor;
+    quint32 m_observationId;
 
     QString m_rxCall;
     QString m_rxGrid;
@@ -42,7 +58,9 @@ private:
 
     QHostAddress m_pskReporterAddress;
 
-    QQueue< QHash<QString,QString> > m_spotQueue;
+    QQueue<Spot> m_spotQueue;
+    QHash<QString, uint> m_lastSpotted; // call/band/mode -> time
+    uint m_dedupWindow;
 
     MessageClient * m_messageClient;
 
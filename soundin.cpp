@@ -2,43 +2,42 @@
 
 #include <QAudioDeviceInfo>
 #include <QAudioFormat>
-#include <QAudioInput>
 #include <QSysInfo>
 #include <QDebug>
 
+#include "Audio/AudioInputBackend.hpp"
+#include "Audio/QtAudioInput.hpp"
+#include "Audio/FileAudioInput.hpp"
+#if WSJT_ALSA_AUDIO
+#include "Audio/AlsaAudioInput.hpp"
+#endif
+
 #include "moc_soundin.cpp"
 
-bool SoundInput::audioError () const
+void SoundInput::setBackend (QString const& type, QString const& device)
 {
-  bool result (true);
+  m_backendType = type.toLower ();
+  m_backendDevice = device;
+}
 
-  Q_ASSERT_X (m_stream, "SoundInput", "programming error");
-  if (m_stream)
+AudioInputBackend * SoundInput::makeBackend ()
+{
+  if ("file" == m_backendType)
+    {
+      return new FileAudioInput {m_backendDevice};
+    }
+#if WSJT_ALSA_AUDIO
+  if ("alsa" == m_backendType)
+    {
+      return new AlsaAudioInput {m_backendDevice};
+    }
+#endif
+  if ("qt" != m_backendType)
     {
-      switch (m_stream->error ())
-        {
-        case QAudio::OpenError:
-          Q_EMIT error (tr ("An error opening the audio input device has occurred."));
-          break;
-
-        case QAudio::IOError:
-          Q_EMIT error (tr ("An error occurred during read from the audio input device."));
-          break;
-
-        case QAudio::UnderrunError:
-          Q_EMIT error (tr ("Audio data not being fed to the audio input device fast enough."));
-          break;
-
-        case QAudio::FatalError:
-          Q_EMIT error (tr ("Non-recoverable error, audio input device not usable at this time."));
-          break;
-
-        case QAudio::NoError:
-          result = false;
-          break;
-        }
+      Q_EMIT error (tr ("Unknown or unavailable audio input backend \"%1\", using Qt audio input instead.")
+                    .arg (m_backendType));
     }
-  return result;
+  return new QtAudioInput;
 }
 
 void SoundInput::start(QAudioDeviceInfo const& device, int framesPerBuffer, AudioDevice * sink, unsigned downSampleFactor, AudioDevice::Channel channel)
@@ -57,46 +56,41 @@ void SoundInput::start(QAudioDeviceInfo const& device, int framesPerBuffer, Audi
   format.setSampleType (QAudioFormat::SignedInt);
   format.setSampleSize (16);
   format.setByteOrder (QAudioFormat::Endian (QSysInfo::ByteOrder));
+
+  m_backend.reset (makeBackend ());
+  connect (m_backend.data (), &AudioInputBackend::error, this, &SoundInput::error);
+  connect (m_backend.data (), &AudioInputBackend::status, this, &SoundInput::status);
+
+  // capture at the native rate of the device if it can't do the
+  // requested rate, the sink resamples
+  format.setSampleRate (m_backend->frameRate (device, format, 12000));
   if (!format.isValid ())
     {
+      m_backend.reset ();
       Q_EMIT error (tr ("Requested input audio format is not valid."));
       return;
     }
 
-  if (!device.isFormatSupported (format))
-    {
-//      qDebug () << "Nearest supported audio format:" << device.nearestFormat (format);
-      Q_EMIT error (tr ("Requested input audio format is not supported on device."));
-      return;
-    }
-//  qDebug () << "Selected audio input format:" << format;
-
-  m_stream.reset (new QAudioInput {device, format});
-  if (audioError ())
+  sink->setFrameRate (format.sampleRate ());
+  if (!sink->initialize (QIODevice::WriteOnly, channel))
     {
+      m_backend.reset ();
+      Q_EMIT error (tr ("Failed to initialize audio sink device"));
       return;
     }
 
-  connect (m_stream.data(), &QAudioInput::stateChanged, this, &SoundInput::handleStateChanged);
-
-  m_stream->setBufferSize (m_stream->format ().bytesForFrames (framesPerBuffer));
-  if (sink->initialize (QIODevice::WriteOnly, channel))
+  if (!m_backend->start (device, format, framesPerBuffer, sink))
     {
-      m_stream->start (sink);
-      audioError ();
-    }
-  else
-    {
-      Q_EMIT error (tr ("Failed to initialize audio sink device"));
+      m_backend.reset ();
+      sink->close ();
     }
 }
 
 void SoundInput::suspend ()
 {
-  if (m_stream)
+  if (m_backend)
     {
-      m_stream->suspend ();
-      audioError ();
+      m_backend->suspend ();
     }
 }
 
@@ -108,51 +102,19 @@ void SoundInput::resume ()
       m_sink->reset ();
     }
 
-  if (m_stream)
-    {
-      m_stream->resume ();
-      audioError ();
-    }
-}
-
-void SoundInput::handleStateChanged (QAudio::State newState) const
-{
-  // qDebug () << "SoundInput::handleStateChanged: newState:" << newState;
-
-  switch (newState)
+  if (m_backend)
     {
-    case QAudio::IdleState:
-      Q_EMIT status (tr ("Idle"));
-      break;
-
-    case QAudio::ActiveState:
-      Q_EMIT status (tr ("Receiving"));
-      break;
-
-    case QAudio::SuspendedState:
-      Q_EMIT status (tr ("Suspended"));
-      break;
-
-    case QAudio::StoppedState:
-      if (audioError ())
-        {
-          Q_EMIT status (tr ("Error"));
-        }
-      else
-        {
-          Q_EMIT status (tr ("Stopped"));
-        }
-      break;
+      m_backend->resume ();
     }
 }
 
 void SoundInput::stop()
 {
-  if (m_stream)
+  if (m_backend)
     {
-      m_stream->stop ();
+      m_backend->stop ();
     }
-  m_stream.reset ();
+  m_backend.reset ();
 
   if (m_sink)
     {
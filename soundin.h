@@ -7,14 +7,23 @@
 #include <QDateTime>
 #include <QScopedPointer>
 #include <QPointer>
-#include <QAudioInput>
 
 #include "AudioDevice.hpp"
 
 class QAudioDeviceInfo;
-class QAudioInput;
+class AudioInputBackend;
 
 // Gets audio data from sound sample source and passes it to a sink device
+//
+// The capture itself is done by an AudioInputBackend, selected by
+// setBackend() as one of:
+//
+//  "qt"   - QAudioInput on the configured device (the default)
+//  "alsa" - ALSA PCM capture on a real time thread, device is an ALSA
+//           PCM name or empty for the configured device
+//  "file" - a WAV file played in a loop in real time, device is the
+//           file path
+//
 class SoundInput
   : public QObject
 {
@@ -24,11 +33,15 @@ public:
   SoundInput (QObject * parent = nullptr)
     : QObject {parent}
     , m_sink {nullptr}
+    , m_backendType {"qt"}
   {
   }
 
   ~SoundInput ();
 
+  // takes effect at the next start call
+  void setBackend (QString const& type, QString const& device = QString {});
+
   // sink must exist from the start call until the next start call or
   // stop call
   Q_SLOT void start(QAudioDeviceInfo const&, int framesPerBuffer, AudioDevice * sink, unsigned downSampleFactor, AudioDevice::Channel = AudioDevice::Mono);
@@ -40,13 +53,12 @@ public:
   Q_SIGNAL void status (QString message) const;
 
 private:
-  // used internally
-  Q_SLOT void handleStateChanged (QAudio::State) const;
-
-  bool audioError () const;
+  AudioInputBackend * makeBackend ();
 
-  QScopedPointer<QAudioInput> m_stream;
+  QScopedPointer<AudioInputBackend> m_backend;
   QPointer<AudioDevice> m_sink;
+  QString m_backendType;
+  QString m_backendDevice;
 };
 
 #endif
@@ -141,6 +141,15 @@ void SoundOutput::stop ()
     }
 }
 
+qint64 SoundOutput::latency () const
+{
+  if (!m_stream || QAudio::StoppedState == m_stream->state ())
+    {
+      return 0;
+    }
+  return m_stream->format ().durationForBytes (m_stream->bufferSize () - m_stream->bytesFree ());
+}
+
 qreal SoundOutput::attenuation () const
 {
   return -(20. * qLn (m_volume) / qLn (10.));
@@ -25,6 +25,10 @@ public:
 
   qreal attenuation () const;
 
+  // duration in microseconds of the audio queued in the device and
+  // not yet played
+  qint64 latency () const;
+
 public Q_SLOTS:
   void setFormat (QAudioDeviceInfo const& device, unsigned channels, unsigned msBuffered = 0u);
   void restart (QIODevice *);
@@ -518,7 +518,3 @@ void WideGraph::on_sbPercent2dPlot_valueChanged(int n)
   ui->widePlot->SetPercent2DScreen(n);
 }
 
-void WideGraph::setRedFile(QString fRed)
-{
-  ui->widePlot->setRedFile(fRed);
-}
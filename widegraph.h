@@ -48,7 +48,6 @@ public:
   void   setWSPRtransmitted();
   void   drawRed(int ia, int ib);
   void   setVHF(bool bVHF);
-  void   setRedFile(QString fRed);
 
 signals:
   void freezeDecode2(int n);